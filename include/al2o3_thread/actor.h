@@ -0,0 +1,36 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/mpsc.h"
+#include "al2o3_thread/pool.h"
+
+// Lightweight actors on a Thread_Pool, an alternative to a mutex per object.
+// An actor is a mailbox plus a handler. Sending a message to an idle actor
+// schedules one activation on the pool, which runs the handler for up to
+// batchSize messages and reschedules itself if more are waiting. An actor
+// never has more than one activation at a time, so the handler owns the
+// actor's state without any lock. Sends are lock free from any thread,
+// including from handlers.
+typedef struct Thread_Actor Thread_Actor;
+typedef void (*Thread_ActorHandler)(Thread_Actor *actor, Thread_MPSCNode *message);
+
+// not padded, so 100k of them stay small, embed one per entity
+struct Thread_Actor {
+	Thread_MPSCQueue mailbox;
+	// messages sent but not yet handled, 0 -> 1 schedules an activation
+	Thread_Atomic32_t pending;
+	uint32_t batchSize;
+	Thread_ActorHandler handler;
+	Thread_PoolHandle pool;
+	void *userData;
+};
+
+// batchSize 0 uses a default
+AL2O3_EXTERN_C bool Thread_ActorCreate(Thread_Actor *actor, Thread_PoolHandle pool, Thread_ActorHandler handler,
+																			 void *userData, uint32_t batchSize);
+// the mailbox must be empty with no activation running
+AL2O3_EXTERN_C void Thread_ActorDestroy(Thread_Actor *actor);
+// message memory is owned by the sender until the handler gets it
+AL2O3_EXTERN_C void Thread_ActorSend(Thread_Actor *actor, Thread_MPSCNode *message);
+// messages sent but not yet handled
+AL2O3_EXTERN_C uint32_t Thread_ActorPendingCount(Thread_Actor *actor);
@@ -0,0 +1,68 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/pool.h"
+
+// Asynchronous positional file reads and writes.
+// On Linux requests are batched into io_uring submission entries, one syscall
+// per Thread_AsyncIOSubmit, and a single reaper thread turns completions into
+// continuation jobs on a Thread_Pool, so no worker ever blocks in read().
+// Where io_uring isn't available (older kernels, other platforms, or asked for)
+// fallbackThreads threads do blocking pread/pwrite and post the same
+// continuations. They mostly wait on the device, so their count isn't limited
+// by the core count. Their queue is linked through the requests, so it never
+// fills and a submit never does the transfer itself.
+// Results match pread/pwrite, a transfer can be short.
+typedef struct Thread_AsyncIO *Thread_AsyncIOHandle;
+
+typedef enum Thread_AsyncIOOp {
+	Thread_ASYNCIO_READ,
+	Thread_ASYNCIO_WRITE,
+} Thread_AsyncIOOp;
+
+// owned by the caller and must stay alive until its continuation has run,
+// the continuation is called with the request as its data
+typedef struct Thread_AsyncIORequest {
+	Thread_AsyncIOOp op;
+	intptr_t file;       // fd on posix, HANDLE on windows
+	void *buffer;        // inside registered buffer bufferIndex if that is >= 0
+	uint64_t offset;
+	uint32_t size;
+	int32_t bufferIndex; // registered buffer or -1
+	Thread_JobFunction continuation; // may be NULL
+	void *userData;
+
+	// bytes transferred or a negative errno (GetLastError on windows), set before the continuation runs
+	int64_t result;
+	// internal
+	struct Thread_AsyncIO *owner;
+	struct Thread_AsyncIORequest *next;
+} Thread_AsyncIORequest;
+
+// zero in any field selects the default
+typedef struct Thread_AsyncIODesc {
+	Thread_PoolHandle pool; // continuations run here, NULL runs them on the I/O thread
+	Thread_PoolPriority continuationPriority; // default is high, completions are latency sensitive
+	uint32_t queueDepth;      // io_uring submission entries
+	uint32_t fallbackThreads; // blocking threads when io_uring isn't used, not clamped to the cores
+	bool forceFallback;       // skip io_uring even if the kernel has it
+} Thread_AsyncIODesc;
+
+AL2O3_EXTERN_C Thread_AsyncIOHandle Thread_AsyncIOCreate(Thread_AsyncIODesc const *desc);
+// waits for every submitted request to complete and its continuation to be posted
+AL2O3_EXTERN_C void Thread_AsyncIODestroy(Thread_AsyncIOHandle io);
+
+// true if io_uring is in use rather than the blocking fallback
+AL2O3_EXTERN_C bool Thread_AsyncIOIsUring(Thread_AsyncIOHandle io);
+
+// pins the buffers with the kernel so fixed requests skip the per request page
+// mapping. Call once before submitting anything that uses them. The fallback
+// accepts the call and treats the buffers as normal memory.
+AL2O3_EXTERN_C bool Thread_AsyncIORegisterBuffers(Thread_AsyncIOHandle io,
+																									void *const *buffers,
+																									size_t const *sizes,
+																									uint32_t count);
+
+// queues count requests with a single kernel submission, blocks only if the
+// completion ring is full. Safe to call from any thread.
+AL2O3_EXTERN_C void Thread_AsyncIOSubmit(Thread_AsyncIOHandle io, Thread_AsyncIORequest *const *requests, uint32_t count);
@@ -15,12 +15,49 @@
 #include "al2o3_platform/platform.h"
 #include <stddef.h>
 
+// C11 style memory orders for the *Explicit API, values match std::memory_order
+typedef enum {
+	Thread_ATOMIC_RELAXED = 0,
+	Thread_ATOMIC_CONSUME = 1,
+	Thread_ATOMIC_ACQUIRE = 2,
+	Thread_ATOMIC_RELEASE = 3,
+	Thread_ATOMIC_ACQ_REL = 4,
+	Thread_ATOMIC_SEQ_CST = 5
+} Thread_atomicOrder_t;
+
 #if AL2O3_COMPILER == AL2O3_COMPILER_MSVC
 #include "al2o3_thread/impl/atomic_msvc.h"
 #else
+#if defined(__x86_64__)
 #include "al2o3_thread/impl/atomic_gcc_x64.h"
+#else
+#include "al2o3_thread/impl/atomic_gcc_generic.h"
+#endif
+#include "al2o3_thread/impl/atomic_gcc.h"
 #endif
 
+//--------------------------------------------------------------
+//  Cache line padding
+//  Thread_CACHE_LINE_ALIGN goes between the closing brace and the typedef name
+//  typedef struct { ... } Thread_CACHE_LINE_ALIGN MyStruct;
+//--------------------------------------------------------------
+#if defined(__aarch64__) && defined(__APPLE__)
+#define Thread_CACHE_LINE_SIZE 128
+#else
+#define Thread_CACHE_LINE_SIZE 64
+#endif
+
+#if AL2O3_COMPILER == AL2O3_COMPILER_MSVC
+#define Thread_CACHE_LINE_ALIGN __declspec(align(Thread_CACHE_LINE_SIZE))
+#else
+#define Thread_CACHE_LINE_ALIGN __attribute__((aligned(Thread_CACHE_LINE_SIZE)))
+#endif
+
+// atomics that own a whole cache line so neighbours can't false share with them
+typedef struct { Thread_Atomic32_t value; } Thread_CACHE_LINE_ALIGN Thread_PaddedAtomic32_t;
+typedef struct { Thread_Atomic64_t value; } Thread_CACHE_LINE_ALIGN Thread_PaddedAtomic64_t;
+typedef struct { Thread_AtomicPtr_t value; } Thread_CACHE_LINE_ALIGN Thread_PaddedAtomicPtr_t;
+
 typedef enum {
 	Thread_MEMORY_ORDER_ACQUIRE,
 	Thread_MEMORY_ORDER_RELEASE,
@@ -261,6 +298,51 @@ AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchOr64(Thread_Atomic64_t *object, ui
 	return result;
 }
 
+//--------------------------------------------------------------
+//  Wrappers for 128-bit operations with built-in ordering constraints
+//--------------------------------------------------------------
+AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicLoad128(Thread_Atomic128_t *object, Thread_memoryOrder_t memoryOrder) {
+	platform_uint128_t result = Thread_AtomicLoad128Relaxed(object);
+	if (memoryOrder == Thread_MEMORY_ORDER_ACQUIRE || memoryOrder == Thread_MEMORY_ORDER_ACQ_REL) // a little forgiving
+			Thread_AtomicThreadFenceAcquire();
+	return result;
+}
+AL2O3_FORCE_INLINE void Thread_AtomicStore128(Thread_Atomic128_t *object, platform_uint128_t desired, Thread_memoryOrder_t memoryOrder) {
+	if (memoryOrder == Thread_MEMORY_ORDER_RELEASE || memoryOrder == Thread_MEMORY_ORDER_ACQ_REL) // a little forgiving
+			Thread_AtomicThreadFenceRelease();
+	Thread_AtomicStore128Relaxed(object, desired);
+}
+AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicCompareExchange128(Thread_Atomic128_t *object,
+																																			platform_uint128_t expected,
+																																			platform_uint128_t desired,
+																																			Thread_memoryOrder_t memoryOrder) {
+	if (memoryOrder == Thread_MEMORY_ORDER_RELEASE || memoryOrder == Thread_MEMORY_ORDER_ACQ_REL)
+			Thread_AtomicThreadFenceRelease();
+	platform_uint128_t result = Thread_AtomicCompareExchange128Relaxed(object, expected, desired);
+	if (memoryOrder == Thread_MEMORY_ORDER_ACQUIRE || memoryOrder == Thread_MEMORY_ORDER_ACQ_REL)
+			Thread_AtomicThreadFenceAcquire();
+	return result;
+}
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak128(Thread_Atomic128_t *object,
+																														platform_uint128_t *expected,
+																														platform_uint128_t desired,
+																														Thread_memoryOrder_t memoryOrder) {
+	if (memoryOrder == Thread_MEMORY_ORDER_RELEASE || memoryOrder == Thread_MEMORY_ORDER_ACQ_REL)
+			Thread_AtomicThreadFenceRelease();
+	bool result = Thread_AtomicCompareExchangeWeak128Relaxed(object, expected, desired);
+	if (memoryOrder == Thread_MEMORY_ORDER_ACQUIRE || memoryOrder == Thread_MEMORY_ORDER_ACQ_REL)
+			Thread_AtomicThreadFenceAcquire();
+	return result;
+}
+AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicExchange128(Thread_Atomic128_t *object, platform_uint128_t desired, Thread_memoryOrder_t memoryOrder) {
+	if (memoryOrder == Thread_MEMORY_ORDER_RELEASE || memoryOrder == Thread_MEMORY_ORDER_ACQ_REL)
+			Thread_AtomicThreadFenceRelease();
+	platform_uint128_t result = Thread_AtomicExchange128Relaxed(object, desired);
+	if (memoryOrder == Thread_MEMORY_ORDER_ACQUIRE || memoryOrder == Thread_MEMORY_ORDER_ACQ_REL)
+			Thread_AtomicThreadFenceAcquire();
+	return result;
+}
+
 AL2O3_FORCE_INLINE void *Thread_AtomicLoadPtrRelaxed(const Thread_AtomicPtr_t *object) {
 	return (void *) Thread_AtomicLoad64Relaxed((const Thread_Atomic64_t *) object);
 }
@@ -0,0 +1,284 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+#include <string.h>
+#include <stddef.h>
+#include <type_traits>
+
+namespace Thread {
+
+namespace Detail {
+
+constexpr Thread_atomicOrder_t AtomicFailureOrder(Thread_atomicOrder_t order) {
+	return order == Thread_ATOMIC_RELEASE ? Thread_ATOMIC_RELAXED :
+				 order == Thread_ATOMIC_ACQ_REL ? Thread_ATOMIC_ACQUIRE : order;
+}
+
+// maps a size onto the C width suffixed functions, orders are template
+// parameters so every call site folds down to a single instruction sequence
+template<size_t Size>
+struct AtomicOps;
+
+#define THREAD_ATOMIC_OPS(SIZE, BITS, RAW, SIGNED) \
+template<> \
+struct AtomicOps<SIZE> { \
+	typedef Thread_Atomic##BITS##_t Storage; \
+	typedef RAW Raw; \
+	template<Thread_atomicOrder_t Order> static Raw Load(Storage const *object) { return Thread_AtomicLoad##BITS##Explicit(object, Order); } \
+	template<Thread_atomicOrder_t Order> static void Store(Storage *object, Raw desired) { Thread_AtomicStore##BITS##Explicit(object, desired, Order); } \
+	template<Thread_atomicOrder_t Order> static Raw Exchange(Storage *object, Raw desired) { return Thread_AtomicExchange##BITS##Explicit(object, desired, Order); } \
+	template<Thread_atomicOrder_t Success, Thread_atomicOrder_t Failure> \
+	static bool CompareExchangeWeak(Storage *object, Raw *expected, Raw desired) { \
+		return Thread_AtomicCompareExchangeWeak##BITS##Explicit(object, expected, desired, Success, Failure); \
+	} \
+	template<Thread_atomicOrder_t Success, Thread_atomicOrder_t Failure> \
+	static bool CompareExchangeStrong(Storage *object, Raw *expected, Raw desired) { \
+		return Thread_AtomicCompareExchangeStrong##BITS##Explicit(object, expected, desired, Success, Failure); \
+	} \
+	template<Thread_atomicOrder_t Order> static Raw FetchAdd(Storage *object, Raw operand) { return Thread_AtomicFetchAdd##BITS##Explicit(object, (SIGNED) operand, Order); } \
+	template<Thread_atomicOrder_t Order> static Raw FetchSub(Storage *object, Raw operand) { return Thread_AtomicFetchSub##BITS##Explicit(object, (SIGNED) operand, Order); } \
+	template<Thread_atomicOrder_t Order> static Raw FetchAnd(Storage *object, Raw operand) { return Thread_AtomicFetchAnd##BITS##Explicit(object, operand, Order); } \
+	template<Thread_atomicOrder_t Order> static Raw FetchOr(Storage *object, Raw operand) { return Thread_AtomicFetchOr##BITS##Explicit(object, operand, Order); } \
+	template<Thread_atomicOrder_t Order> static Raw FetchXor(Storage *object, Raw operand) { return Thread_AtomicFetchXor##BITS##Explicit(object, operand, Order); } \
+	template<Thread_atomicOrder_t Order> static Raw FetchMin(Storage *object, Raw operand) { return Thread_AtomicFetchMin##BITS##Explicit(object, operand, Order); } \
+	template<Thread_atomicOrder_t Order> static Raw FetchMax(Storage *object, Raw operand) { return Thread_AtomicFetchMax##BITS##Explicit(object, operand, Order); } \
+};
+
+THREAD_ATOMIC_OPS(1, 8, uint8_t, int8_t)
+THREAD_ATOMIC_OPS(2, 16, uint16_t, int16_t)
+THREAD_ATOMIC_OPS(4, 32, uint32_t, int32_t)
+THREAD_ATOMIC_OPS(8, 64, uint64_t, int64_t)
+
+#undef THREAD_ATOMIC_OPS
+
+// 128 bit only has load, store, exchange and CAS. The relaxed C ops are wrapped
+// in explicit fences, fences for relaxed orders compile away.
+template<>
+struct AtomicOps<16> {
+	typedef Thread_Atomic128_t Storage;
+	typedef platform_uint128_t Raw;
+
+	template<Thread_atomicOrder_t Order> static void FenceBefore() {
+		if (Order == Thread_ATOMIC_RELEASE || Order == Thread_ATOMIC_ACQ_REL || Order == Thread_ATOMIC_SEQ_CST) {
+			Thread_AtomicThreadFenceExplicit(Order == Thread_ATOMIC_SEQ_CST ? Thread_ATOMIC_SEQ_CST : Thread_ATOMIC_RELEASE);
+		}
+	}
+	template<Thread_atomicOrder_t Order> static void FenceAfter() {
+		if (Order == Thread_ATOMIC_ACQUIRE || Order == Thread_ATOMIC_CONSUME || Order == Thread_ATOMIC_ACQ_REL) {
+			Thread_AtomicThreadFenceExplicit(Thread_ATOMIC_ACQUIRE);
+		} else if (Order == Thread_ATOMIC_SEQ_CST) {
+			Thread_AtomicThreadFenceExplicit(Thread_ATOMIC_SEQ_CST);
+		}
+	}
+
+	template<Thread_atomicOrder_t Order> static Raw Load(Storage const *object) {
+		if (Order == Thread_ATOMIC_SEQ_CST) {
+			FenceBefore<Order>();
+		}
+		Raw result = Thread_AtomicLoad128Relaxed(const_cast<Storage *>(object));
+		FenceAfter<Order>();
+		return result;
+	}
+	template<Thread_atomicOrder_t Order> static void Store(Storage *object, Raw desired) {
+		FenceBefore<Order>();
+		Thread_AtomicStore128Relaxed(object, desired);
+		if (Order == Thread_ATOMIC_SEQ_CST) {
+			FenceAfter<Order>();
+		}
+	}
+	template<Thread_atomicOrder_t Order> static Raw Exchange(Storage *object, Raw desired) {
+		FenceBefore<Order>();
+		Raw result = Thread_AtomicExchange128Relaxed(object, desired);
+		FenceAfter<Order>();
+		return result;
+	}
+	template<Thread_atomicOrder_t Success, Thread_atomicOrder_t Failure>
+	static bool CompareExchangeWeak(Storage *object, Raw *expected, Raw desired) {
+		FenceBefore<Success>();
+		bool const result = Thread_AtomicCompareExchangeWeak128Relaxed(object, expected, desired);
+		if (result) {
+			FenceAfter<Success>();
+		} else {
+			FenceAfter<Failure>();
+		}
+		return result;
+	}
+	template<Thread_atomicOrder_t Success, Thread_atomicOrder_t Failure>
+	static bool CompareExchangeStrong(Storage *object, Raw *expected, Raw desired) {
+		Raw observed = *expected;
+		while (!CompareExchangeWeak<Success, Failure>(object, &observed, desired)) {
+			// weak CAS can fail spuriously, only report failure if the value differs
+			if (memcmp(&observed, expected, sizeof(Raw)) != 0) {
+				*expected = observed;
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+template<typename T, typename Raw>
+AL2O3_FORCE_INLINE Raw AtomicToRaw(T value) {
+	Raw raw;
+	memcpy(&raw, &value, sizeof(Raw));
+	return raw;
+}
+template<typename T, typename Raw>
+AL2O3_FORCE_INLINE T AtomicFromRaw(Raw raw) {
+	T value;
+	memcpy(&value, &raw, sizeof(T));
+	return value;
+}
+
+// operations common to every T
+template<typename T>
+struct AtomicBase {
+	typedef AtomicOps<sizeof(T)> Ops;
+	typedef typename Ops::Raw Raw;
+
+	static_assert(std::is_trivially_copyable<T>::value, "Thread::Atomic<T> requires a trivially copyable T");
+	static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8 || sizeof(T) == 16,
+								"Thread::Atomic<T> requires a T of 1, 2, 4, 8 or 16 bytes");
+
+	static constexpr bool IsAlwaysLockFree = true;
+
+	AtomicBase() = default;
+	// nothing else can see the object yet so initialisation is a plain copy
+	explicit AtomicBase(T desired) { memcpy((void *) &storage, &desired, sizeof(T)); }
+
+	AtomicBase(AtomicBase const &) = delete;
+	AtomicBase &operator=(AtomicBase const &) = delete;
+
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	T Load() const { return AtomicFromRaw<T, Raw>(Ops::template Load<Order>(&storage)); }
+
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	void Store(T desired) { Ops::template Store<Order>(&storage, AtomicToRaw<T, Raw>(desired)); }
+
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	T Exchange(T desired) { return AtomicFromRaw<T, Raw>(Ops::template Exchange<Order>(&storage, AtomicToRaw<T, Raw>(desired))); }
+
+	// on failure expected is updated with the observed value
+	template<Thread_atomicOrder_t Success = Thread_ATOMIC_SEQ_CST, Thread_atomicOrder_t Failure = AtomicFailureOrder(Success)>
+	bool CompareExchangeWeak(T &expected, T desired) {
+		Raw rawExpected = AtomicToRaw<T, Raw>(expected);
+		bool const result = Ops::template CompareExchangeWeak<Success, Failure>(&storage, &rawExpected, AtomicToRaw<T, Raw>(desired));
+		expected = AtomicFromRaw<T, Raw>(rawExpected);
+		return result;
+	}
+	template<Thread_atomicOrder_t Success = Thread_ATOMIC_SEQ_CST, Thread_atomicOrder_t Failure = AtomicFailureOrder(Success)>
+	bool CompareExchangeStrong(T &expected, T desired) {
+		Raw rawExpected = AtomicToRaw<T, Raw>(expected);
+		bool const result = Ops::template CompareExchangeStrong<Success, Failure>(&storage, &rawExpected, AtomicToRaw<T, Raw>(desired));
+		expected = AtomicFromRaw<T, Raw>(rawExpected);
+		return result;
+	}
+
+	operator T() const { return Load(); }
+	T operator=(T desired) { Store(desired); return desired; }
+
+	typename Ops::Storage storage;
+};
+
+template<typename T,
+		bool Integral = std::is_integral<T>::value && !std::is_same<T, bool>::value,
+		bool Pointer = std::is_pointer<T>::value>
+struct AtomicArithmetic : public AtomicBase<T> {
+	using AtomicBase<T>::AtomicBase;
+	using AtomicBase<T>::operator=;
+};
+
+// integral T get the fetch ops and the std::atomic style operators
+template<typename T>
+struct AtomicArithmetic<T, true, false> : public AtomicBase<T> {
+	typedef AtomicBase<T> Base;
+	typedef typename Base::Ops Ops;
+	typedef typename Base::Raw Raw;
+	using Base::Base;
+	using Base::operator=;
+
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	T FetchAdd(T operand) { return (T) Ops::template FetchAdd<Order>(&this->storage, (Raw) operand); }
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	T FetchSub(T operand) { return (T) Ops::template FetchSub<Order>(&this->storage, (Raw) operand); }
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	T FetchAnd(T operand) { return (T) Ops::template FetchAnd<Order>(&this->storage, (Raw) operand); }
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	T FetchOr(T operand) { return (T) Ops::template FetchOr<Order>(&this->storage, (Raw) operand); }
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	T FetchXor(T operand) { return (T) Ops::template FetchXor<Order>(&this->storage, (Raw) operand); }
+
+	// the C min/max compare unsigned, signed T uses a CAS loop
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	T FetchMin(T operand) {
+		if (std::is_unsigned<T>::value) {
+			return (T) Ops::template FetchMin<Order>(&this->storage, (Raw) operand);
+		}
+		T current = this->template Load<AtomicFailureOrder(Order)>();
+		while (current > operand && !this->template CompareExchangeWeak<Order>(current, operand)) {
+		}
+		return current;
+	}
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	T FetchMax(T operand) {
+		if (std::is_unsigned<T>::value) {
+			return (T) Ops::template FetchMax<Order>(&this->storage, (Raw) operand);
+		}
+		T current = this->template Load<AtomicFailureOrder(Order)>();
+		while (current < operand && !this->template CompareExchangeWeak<Order>(current, operand)) {
+		}
+		return current;
+	}
+
+	T operator++() { return (T) (FetchAdd(1) + 1); }
+	T operator++(int) { return FetchAdd(1); }
+	T operator--() { return (T) (FetchSub(1) - 1); }
+	T operator--(int) { return FetchSub(1); }
+	T operator+=(T operand) { return (T) (FetchAdd(operand) + operand); }
+	T operator-=(T operand) { return (T) (FetchSub(operand) - operand); }
+	T operator&=(T operand) { return (T) (FetchAnd(operand) & operand); }
+	T operator|=(T operand) { return (T) (FetchOr(operand) | operand); }
+	T operator^=(T operand) { return (T) (FetchXor(operand) ^ operand); }
+};
+
+// pointers step in units of the pointee like std::atomic<T*>
+template<typename T>
+struct AtomicArithmetic<T, false, true> : public AtomicBase<T> {
+	typedef AtomicBase<T> Base;
+	typedef typename Base::Ops Ops;
+	typedef typename Base::Raw Raw;
+	using Base::Base;
+	using Base::operator=;
+
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	T FetchAdd(ptrdiff_t operand) {
+		return AtomicFromRaw<T, Raw>(Ops::template FetchAdd<Order>(&this->storage, (Raw) (operand * (ptrdiff_t) sizeof(typename std::remove_pointer<T>::type))));
+	}
+	template<Thread_atomicOrder_t Order = Thread_ATOMIC_SEQ_CST>
+	T FetchSub(ptrdiff_t operand) {
+		return AtomicFromRaw<T, Raw>(Ops::template FetchSub<Order>(&this->storage, (Raw) (operand * (ptrdiff_t) sizeof(typename std::remove_pointer<T>::type))));
+	}
+
+	T operator++() { return FetchAdd(1) + 1; }
+	T operator++(int) { return FetchAdd(1); }
+	T operator--() { return FetchSub(1) - 1; }
+	T operator--(int) { return FetchSub(1); }
+	T operator+=(ptrdiff_t operand) { return FetchAdd(operand) + operand; }
+	T operator-=(ptrdiff_t operand) { return FetchSub(operand) - operand; }
+};
+
+} // end Detail namespace
+
+// std::atomic like wrapper over atomic.h, the width is picked from sizeof(T)
+// and the memory order is a template parameter on each operation, e.g.
+//   Thread::Atomic<uint32_t> count;
+//   count.FetchAdd<Thread_ATOMIC_RELAXED>(1);
+// Integral, pointer and trivially copyable T of 1, 2, 4, 8 or 16 bytes are supported,
+// 16 byte T is backed by the 128 bit ops and only has load/store/exchange/CAS.
+template<typename T>
+struct Atomic : public Detail::AtomicArithmetic<T> {
+	using Detail::AtomicArithmetic<T>::AtomicArithmetic;
+	using Detail::AtomicArithmetic<T>::operator=;
+};
+
+}; // end Thread namespace
@@ -0,0 +1,50 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+
+// Phase synchronisation primitives. Waiters spin briefly (skipped on single
+// core machines) then park on a futex, signallers only make a syscall if
+// someone is actually parked.
+
+// Reusable sense reversing barrier for a fixed number of participants.
+// The arrival counter and the generation waiters watch live on separate
+// cache lines so spinning waiters aren't disturbed by each arrival.
+typedef struct Thread_Barrier {
+	Thread_Atomic32_t arrived;
+	uint32_t count;
+	uint32_t spinCount;
+	Thread_PaddedAtomic32_t generation;
+	Thread_PaddedAtomic32_t sleepers;
+} Thread_Barrier;
+
+// Single use, waiters are released once the count reaches zero
+typedef struct Thread_Latch {
+	Thread_PaddedAtomic32_t count;
+	Thread_Atomic32_t sleepers;
+	uint32_t spinCount;
+} Thread_Latch;
+
+// A latch that can be re-armed, count can be added to (a "wait group")
+typedef Thread_Latch Thread_CountdownEvent;
+
+AL2O3_EXTERN_C bool Thread_BarrierCreate(Thread_Barrier *barrier, uint32_t count);
+AL2O3_EXTERN_C void Thread_BarrierDestroy(Thread_Barrier *barrier);
+// returns true for exactly one participant per phase (the last to arrive)
+AL2O3_EXTERN_C bool Thread_BarrierWait(Thread_Barrier *barrier);
+
+AL2O3_EXTERN_C bool Thread_LatchCreate(Thread_Latch *latch, uint32_t count);
+AL2O3_EXTERN_C void Thread_LatchDestroy(Thread_Latch *latch);
+AL2O3_EXTERN_C void Thread_LatchCountDown(Thread_Latch *latch, uint32_t n);
+AL2O3_EXTERN_C bool Thread_LatchTryWait(Thread_Latch *latch);
+AL2O3_EXTERN_C void Thread_LatchWait(Thread_Latch *latch);
+AL2O3_EXTERN_C void Thread_LatchArriveAndWait(Thread_Latch *latch, uint32_t n);
+
+AL2O3_EXTERN_C bool Thread_CountdownEventCreate(Thread_CountdownEvent *event, uint32_t count);
+AL2O3_EXTERN_C void Thread_CountdownEventDestroy(Thread_CountdownEvent *event);
+AL2O3_EXTERN_C void Thread_CountdownEventAdd(Thread_CountdownEvent *event, uint32_t n);
+// returns true if this signal released the waiters
+AL2O3_EXTERN_C bool Thread_CountdownEventSignal(Thread_CountdownEvent *event, uint32_t n);
+AL2O3_EXTERN_C bool Thread_CountdownEventIsSet(Thread_CountdownEvent *event);
+AL2O3_EXTERN_C void Thread_CountdownEventWait(Thread_CountdownEvent *event);
+// only safe when no one is waiting or signalling
+AL2O3_EXTERN_C void Thread_CountdownEventReset(Thread_CountdownEvent *event, uint32_t count);
@@ -0,0 +1,63 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/barrier.h"
+
+namespace Thread {
+
+struct Barrier {
+	explicit Barrier(uint32_t count) { Thread_BarrierCreate(&handle, count); }
+	~Barrier() { Thread_BarrierDestroy(&handle); }
+
+	Barrier(Barrier const &rhs) = delete;
+	Barrier &operator=(Barrier const &rhs) = delete;
+
+	// returns true for the last participant to arrive each phase
+	bool Wait() { return Thread_BarrierWait(&handle); }
+
+	Thread_Barrier handle;
+};
+
+struct Latch {
+	explicit Latch(uint32_t count) { Thread_LatchCreate(&handle, count); }
+	~Latch() { Thread_LatchDestroy(&handle); }
+
+	Latch(Latch const &rhs) = delete;
+	Latch &operator=(Latch const &rhs) = delete;
+
+	void CountDown(uint32_t n = 1) { Thread_LatchCountDown(&handle, n); }
+	bool TryWait() { return Thread_LatchTryWait(&handle); }
+	void Wait() { Thread_LatchWait(&handle); }
+	void ArriveAndWait(uint32_t n = 1) { Thread_LatchArriveAndWait(&handle, n); }
+
+	Thread_Latch handle;
+};
+
+struct CountdownEvent {
+	explicit CountdownEvent(uint32_t count = 0) { Thread_CountdownEventCreate(&handle, count); }
+	~CountdownEvent() { Thread_CountdownEventDestroy(&handle); }
+
+	CountdownEvent(CountdownEvent const &rhs) = delete;
+	CountdownEvent &operator=(CountdownEvent const &rhs) = delete;
+
+	void Add(uint32_t n = 1) { Thread_CountdownEventAdd(&handle, n); }
+	bool Signal(uint32_t n = 1) { return Thread_CountdownEventSignal(&handle, n); }
+	bool IsSet() { return Thread_CountdownEventIsSet(&handle); }
+	void Wait() { Thread_CountdownEventWait(&handle); }
+	void Reset(uint32_t count) { Thread_CountdownEventReset(&handle, count); }
+
+	Thread_CountdownEvent handle;
+};
+
+// signals the event when it goes out of scope, so early returns still count
+struct CountdownEventSignalGuard {
+	explicit CountdownEventSignalGuard(CountdownEvent &event) : mEvent(&event.handle) {};
+	explicit CountdownEventSignalGuard(Thread_CountdownEvent *event) : mEvent(event) {};
+	~CountdownEventSignalGuard() { Thread_CountdownEventSignal(mEvent, 1); };
+
+	CountdownEventSignalGuard(CountdownEventSignalGuard const &rhs) = delete;
+	CountdownEventSignalGuard &operator=(CountdownEventSignalGuard const &rhs) = delete;
+
+	Thread_CountdownEvent *mEvent;
+};
+
+}; // end Thread namespace
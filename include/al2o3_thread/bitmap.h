@@ -0,0 +1,45 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+
+// Lock free fixed size bitmap for handing out indices.
+// Bits live in 64 bit atomic words with summary levels above them. A summary
+// bit marks a word below it as full, so a search skips full regions instead
+// of walking every word. Acquire finds a free bit with a count trailing zeros
+// and claims it with one CAS. Each thread starts searching where it last found
+// a free bit, and different threads start in different places, so threads
+// mostly work in different words.
+// Acquire fails only when every bit is taken. While a release is still in
+// flight it may briefly miss the bit being released.
+typedef struct Thread_AtomicBitmap *Thread_AtomicBitmapHandle;
+
+// every bit starts clear (free), capacity can't be 0
+AL2O3_EXTERN_C Thread_AtomicBitmapHandle Thread_AtomicBitmapCreate(uint32_t capacity);
+AL2O3_EXTERN_C void Thread_AtomicBitmapDestroy(Thread_AtomicBitmapHandle bitmap);
+// sets a clear bit and returns its index, false if every bit is set
+AL2O3_EXTERN_C bool Thread_AtomicBitmapAcquire(Thread_AtomicBitmapHandle bitmap, uint32_t *outIndex);
+// clears a bit the caller acquired
+AL2O3_EXTERN_C void Thread_AtomicBitmapRelease(Thread_AtomicBitmapHandle bitmap, uint32_t index);
+AL2O3_EXTERN_C bool Thread_AtomicBitmapIsSet(Thread_AtomicBitmapHandle bitmap, uint32_t index);
+AL2O3_EXTERN_C uint32_t Thread_AtomicBitmapCapacity(Thread_AtomicBitmapHandle bitmap);
+
+// Generation checked handles on top of Thread_AtomicBitmap.
+// Each slot has a generation that goes up every time it is released, and a
+// handle carries the generation it was acquired with. A handle kept after
+// its slot was released and reused no longer matches, so stale handles can be
+// detected and a double release is harmless. 0 is never a valid handle.
+typedef struct Thread_SlotAllocator *Thread_SlotAllocatorHandle;
+typedef uint64_t Thread_SlotHandle;
+
+AL2O3_EXTERN_C Thread_SlotAllocatorHandle Thread_SlotAllocatorCreate(uint32_t capacity);
+AL2O3_EXTERN_C void Thread_SlotAllocatorDestroy(Thread_SlotAllocatorHandle allocator);
+// false if every slot is in use
+AL2O3_EXTERN_C bool Thread_SlotAllocatorAcquire(Thread_SlotAllocatorHandle allocator, Thread_SlotHandle *outHandle);
+// false if the handle is stale, the slot is then left alone
+AL2O3_EXTERN_C bool Thread_SlotAllocatorRelease(Thread_SlotAllocatorHandle allocator, Thread_SlotHandle handle);
+AL2O3_EXTERN_C bool Thread_SlotAllocatorIsValid(Thread_SlotAllocatorHandle allocator, Thread_SlotHandle handle);
+AL2O3_EXTERN_C uint32_t Thread_SlotAllocatorCapacity(Thread_SlotAllocatorHandle allocator);
+
+// index in the low 32 bits, generation in the high 32
+AL2O3_FORCE_INLINE uint32_t Thread_SlotHandleIndex(Thread_SlotHandle handle) { return (uint32_t) handle; }
+AL2O3_FORCE_INLINE uint32_t Thread_SlotHandleGeneration(Thread_SlotHandle handle) { return (uint32_t) (handle >> 32); }
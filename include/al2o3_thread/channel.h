@@ -0,0 +1,52 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+
+// Go style channels of fixed size elements.
+// capacity 0 is unbuffered, a send only completes when a receiver takes the
+// value (a rendezvous), otherwise up to capacity values wait in a ring.
+// A party that has to block parks on a futex word of its own, whoever
+// completes it copies the value straight to/from the parked thread's memory
+// and wakes only that thread, there is no shared condition variable.
+// Once closed, sends fail and receives drain the ring then fail.
+typedef struct Thread_Channel *Thread_ChannelHandle;
+
+typedef enum Thread_ChannelOp {
+	Thread_CHANNEL_SEND,
+	Thread_CHANNEL_RECV,
+} Thread_ChannelOp;
+
+// Thread_ChannelSelect waits for the first ready case, a NULL channel is
+// never ready (so a case can be switched off in place)
+typedef struct Thread_ChannelCase {
+	Thread_ChannelHandle channel;
+	Thread_ChannelOp op;
+	void *value; // element to send or space to receive into
+	bool ok;     // set on the chosen case, false if the channel was closed
+} Thread_ChannelCase;
+
+#define Thread_CHANNEL_MAX_SELECT_CASES 64
+
+AL2O3_EXTERN_C Thread_ChannelHandle Thread_ChannelCreate(uint32_t elementSize, uint32_t capacity);
+// no one may be blocked on it
+AL2O3_EXTERN_C void Thread_ChannelDestroy(Thread_ChannelHandle channel);
+// wakes every blocked party, must only be called once
+AL2O3_EXTERN_C void Thread_ChannelClose(Thread_ChannelHandle channel);
+
+// block until done, false if the channel is (or gets) closed
+AL2O3_EXTERN_C bool Thread_ChannelSend(Thread_ChannelHandle channel, void const *value);
+// false once closed and empty, value is zeroed
+AL2O3_EXTERN_C bool Thread_ChannelRecv(Thread_ChannelHandle channel, void *value);
+// never block, false if it couldn't be done right now or the channel is closed
+AL2O3_EXTERN_C bool Thread_ChannelTrySend(Thread_ChannelHandle channel, void const *value);
+AL2O3_EXTERN_C bool Thread_ChannelTryRecv(Thread_ChannelHandle channel, void *value);
+
+// values waiting in the ring
+AL2O3_EXTERN_C uint32_t Thread_ChannelCount(Thread_ChannelHandle channel);
+AL2O3_EXTERN_C bool Thread_ChannelIsClosed(Thread_ChannelHandle channel);
+
+// completes exactly one ready case and returns its index, or -1 if nothing
+// was ready within timeoutNs (0 just polls, Thread_FUTEX_WAIT_INFINITE never
+// times out). When several are ready the choice is pseudo random.
+AL2O3_EXTERN_C int32_t Thread_ChannelSelect(Thread_ChannelCase *cases, uint32_t count, uint64_t timeoutNs);
@@ -0,0 +1,65 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/channel.h"
+#include <type_traits>
+
+namespace Thread {
+
+// values are moved with memcpy, so T must be trivially copyable
+template<typename T>
+struct Channel {
+	static_assert(std::is_trivially_copyable<T>::value, "Channel values are copied as raw bytes");
+
+	// capacity 0 is an unbuffered rendezvous channel
+	explicit Channel(uint32_t capacity = 0) : handle(Thread_ChannelCreate(sizeof(T), capacity)) {}
+	~Channel() { Thread_ChannelDestroy(handle); }
+
+	Channel(Channel const &rhs) = delete;
+	Channel &operator=(Channel const &rhs) = delete;
+
+	bool Send(T const &value) { return Thread_ChannelSend(handle, &value); }
+	bool Recv(T &value) { return Thread_ChannelRecv(handle, &value); }
+	bool TrySend(T const &value) { return Thread_ChannelTrySend(handle, &value); }
+	bool TryRecv(T &value) { return Thread_ChannelTryRecv(handle, &value); }
+	void Close() { Thread_ChannelClose(handle); }
+
+	uint32_t Count() { return Thread_ChannelCount(handle); }
+	bool IsClosed() { return Thread_ChannelIsClosed(handle); }
+
+	Thread_ChannelHandle handle;
+};
+
+// Select select;
+// int32_t const gotJob = select.Recv(jobs, job);
+// int32_t const gotQuit = select.Recv(quit, reason);
+// int32_t const fired = select.Wait(timeoutNs); // -1 on timeout
+// the referenced values must outlive Wait
+struct Select {
+	template<typename T>
+	int32_t Send(Channel<T> &channel, T const &value) {
+		return Add(channel.handle, Thread_CHANNEL_SEND, (void *) &value);
+	}
+	template<typename T>
+	int32_t Recv(Channel<T> &channel, T &value) {
+		return Add(channel.handle, Thread_CHANNEL_RECV, &value);
+	}
+
+	int32_t Wait(uint64_t timeoutNs = Thread_FUTEX_WAIT_INFINITE) { return Thread_ChannelSelect(cases, count, timeoutNs); }
+	int32_t TryWait() { return Thread_ChannelSelect(cases, count, 0); }
+	// false if the case that fired found its channel closed
+	bool Ok(int32_t index) const { return index >= 0 && cases[index].ok; }
+
+	int32_t Add(Thread_ChannelHandle channel, Thread_ChannelOp op, void *value) {
+		ASSERT(count < Thread_CHANNEL_MAX_SELECT_CASES);
+		cases[count].channel = channel;
+		cases[count].op = op;
+		cases[count].value = value;
+		cases[count].ok = false;
+		return (int32_t) count++;
+	}
+
+	Thread_ChannelCase cases[Thread_CHANNEL_MAX_SELECT_CASES];
+	uint32_t count = 0;
+};
+
+}; // end Thread namespace
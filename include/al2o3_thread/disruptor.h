@@ -0,0 +1,64 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/futex.h"
+
+// Multicast ring buffer in the style of the LMAX Disruptor.
+// Entries are preallocated and used in place. Producers claim a run of
+// sequence numbers, fill the entries and publish them. Every consumer sees
+// every entry and keeps its own cursor, so fanning out to N consumers costs
+// no copies. A consumer can depend on other consumers, then it only gets an
+// entry once they have all released it. That orders pipeline stages over the
+// same entries, e.g. a journaling and a replication consumer with a business
+// logic consumer after both.
+// Producers wait when the ring is full until the slowest consumer moves on.
+// Each consumer is driven by one thread at a time. All consumers must be
+// added before the first claim.
+typedef struct Thread_Disruptor *Thread_DisruptorHandle;
+
+typedef enum Thread_DisruptorWait {
+	Thread_DISRUPTOR_WAIT_PARK = 0, // spin briefly then sleep on a futex, publish and release pay for a wake check
+	Thread_DISRUPTOR_WAIT_YIELD,    // spin briefly then yield the core, lowest latency that shares a core
+	Thread_DISRUPTOR_WAIT_SPIN,     // never leaves the core, lowest latency, one core per waiting thread
+} Thread_DisruptorWait;
+
+#define Thread_DISRUPTOR_MAX_CONSUMERS 32
+
+// zero in any field selects the default
+typedef struct Thread_DisruptorDesc {
+	uint32_t entrySize;   // required
+	uint32_t capacity;    // entries, rounded up to a power of 2
+	bool singleProducer;  // claim without an atomic read-modify-write, only one thread may claim and publish
+	Thread_DisruptorWait wait;
+} Thread_DisruptorDesc;
+
+AL2O3_EXTERN_C Thread_DisruptorHandle Thread_DisruptorCreate(Thread_DisruptorDesc const *desc);
+AL2O3_EXTERN_C void Thread_DisruptorDestroy(Thread_DisruptorHandle disruptor);
+
+// returns the new consumer's index or -1 if there are too many.
+// dependsOn are indices of earlier consumers
+AL2O3_EXTERN_C int32_t Thread_DisruptorAddConsumer(Thread_DisruptorHandle disruptor,
+																									 uint32_t const *dependsOn,
+																									 uint32_t dependsOnCount);
+
+// producer side. Claims count consecutive entries and returns the first
+// sequence, waiting while the ring is full. Claimed entries must be published.
+// Multiple producers may publish out of order, consumers see an entry once
+// everything before it is published too.
+AL2O3_EXTERN_C uint64_t Thread_DisruptorClaim(Thread_DisruptorHandle disruptor, uint32_t count);
+AL2O3_EXTERN_C bool Thread_DisruptorTryClaim(Thread_DisruptorHandle disruptor, uint32_t count, uint64_t *outFirst);
+AL2O3_EXTERN_C void Thread_DisruptorPublish(Thread_DisruptorHandle disruptor, uint64_t first, uint32_t count);
+
+// consumer side. Waits up to timeoutNs for entries, returns how many are ready
+// starting at *outFirst, at most maxCount, 0 on timeout. They stay valid and
+// unchanged by producers until released.
+AL2O3_EXTERN_C uint32_t Thread_DisruptorConsumerWait(Thread_DisruptorHandle disruptor,
+																										 uint32_t consumer,
+																										 uint64_t *outFirst,
+																										 uint32_t maxCount,
+																										 uint64_t timeoutNs);
+// finished with the next count entries
+AL2O3_EXTERN_C void Thread_DisruptorConsumerRelease(Thread_DisruptorHandle disruptor, uint32_t consumer, uint32_t count);
+
+// the entry for a claimed or received sequence
+AL2O3_EXTERN_C void *Thread_DisruptorEntry(Thread_DisruptorHandle disruptor, uint64_t sequence);
+AL2O3_EXTERN_C uint32_t Thread_DisruptorCapacity(Thread_DisruptorHandle disruptor);
@@ -0,0 +1,49 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/disruptor.h"
+#include <initializer_list>
+#include <type_traits>
+
+namespace Thread {
+
+// entries are zeroed raw memory reused in place, so T must be trivially copyable
+template<typename T>
+struct Disruptor {
+	static_assert(std::is_trivially_copyable<T>::value, "Disruptor entries are raw memory reused in place");
+
+	explicit Disruptor(uint32_t capacity,
+										 bool singleProducer = false,
+										 Thread_DisruptorWait wait = Thread_DISRUPTOR_WAIT_PARK) {
+		Thread_DisruptorDesc desc = {};
+		desc.entrySize = sizeof(T);
+		desc.capacity = capacity;
+		desc.singleProducer = singleProducer;
+		desc.wait = wait;
+		handle = Thread_DisruptorCreate(&desc);
+	}
+	~Disruptor() { Thread_DisruptorDestroy(handle); }
+
+	Disruptor(Disruptor const &rhs) = delete;
+	Disruptor &operator=(Disruptor const &rhs) = delete;
+
+	int32_t AddConsumer(std::initializer_list<uint32_t> dependsOn = {}) {
+		return Thread_DisruptorAddConsumer(handle, dependsOn.begin(), (uint32_t) dependsOn.size());
+	}
+
+	uint64_t Claim(uint32_t count = 1) { return Thread_DisruptorClaim(handle, count); }
+	bool TryClaim(uint64_t &first, uint32_t count = 1) { return Thread_DisruptorTryClaim(handle, count, &first); }
+	void Publish(uint64_t first, uint32_t count = 1) { Thread_DisruptorPublish(handle, first, count); }
+
+	uint32_t Wait(uint32_t consumer, uint64_t &first, uint32_t maxCount,
+								uint64_t timeoutNs = Thread_FUTEX_WAIT_INFINITE) {
+		return Thread_DisruptorConsumerWait(handle, consumer, &first, maxCount, timeoutNs);
+	}
+	void Release(uint32_t consumer, uint32_t count) { Thread_DisruptorConsumerRelease(handle, consumer, count); }
+
+	T &operator[](uint64_t sequence) { return *(T *) Thread_DisruptorEntry(handle, sequence); }
+	uint32_t Capacity() { return Thread_DisruptorCapacity(handle); }
+
+	Thread_DisruptorHandle handle;
+};
+
+}; // end Thread namespace
@@ -0,0 +1,15 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+
+// Address based parking, the building block for the spin-then-block primitives.
+// Wait sleeps only if *address still equals expected when the kernel looks,
+// so a wake between the caller's check and the sleep is never lost.
+// Waits can return spuriously, always re-check the condition in a loop.
+// Linux uses futex, Apple __ulock, Windows WaitOnAddress.
+#define Thread_FUTEX_WAIT_INFINITE UINT64_MAX
+
+// returns false if the wait timed out
+AL2O3_EXTERN_C bool Thread_FutexWait(Thread_Atomic32_t *address, uint32_t expected, uint64_t timeoutNs);
+AL2O3_EXTERN_C void Thread_FutexWakeOne(Thread_Atomic32_t *address);
+AL2O3_EXTERN_C void Thread_FutexWakeAll(Thread_Atomic32_t *address);
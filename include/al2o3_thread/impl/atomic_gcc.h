@@ -0,0 +1,316 @@
+#pragma once
+/*------------------------------------------------------------------------
+  C11 style explicit memory order atomics for GCC and Clang.
+  Built on the __atomic_* builtins so the compiler picks the optimal
+  instruction sequence for the target (x64, AArch64 etc.).
+  Thread_atomicOrder_t values match __ATOMIC_*, orders passed as compile
+  time constants are folded after inlining so there is no runtime branch.
+------------------------------------------------------------------------*/
+
+// the order a failed compare exchange (or a min/max that doesn't store) may use
+AL2O3_FORCE_INLINE Thread_atomicOrder_t Thread_AtomicFailureOrder(Thread_atomicOrder_t order) {
+	return order == Thread_ATOMIC_RELEASE ? Thread_ATOMIC_RELAXED :
+				 order == Thread_ATOMIC_ACQ_REL ? Thread_ATOMIC_ACQUIRE : order;
+}
+
+//-------------------------------------
+//  Fences
+//-------------------------------------
+AL2O3_FORCE_INLINE void Thread_AtomicThreadFenceExplicit(Thread_atomicOrder_t order) {
+	__atomic_thread_fence(order);
+}
+AL2O3_FORCE_INLINE void Thread_AtomicSignalFenceExplicit(Thread_atomicOrder_t order) {
+	__atomic_signal_fence(order);
+}
+
+//----------------------------------------------
+//  8-bit explicit order atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicLoad8Explicit(const Thread_Atomic8_t *object, Thread_atomicOrder_t order) {
+	return __atomic_load_n(&object->nonatomic, order);
+}
+AL2O3_FORCE_INLINE void Thread_AtomicStore8Explicit(Thread_Atomic8_t *object, uint8_t desired, Thread_atomicOrder_t order) {
+	__atomic_store_n(&object->nonatomic, desired, order);
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicExchange8Explicit(Thread_Atomic8_t *object, uint8_t desired, Thread_atomicOrder_t order) {
+	return __atomic_exchange_n(&object->nonatomic, desired, order);
+}
+// on failure *expected is updated with the observed value
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeStrong8Explicit(Thread_Atomic8_t *object,
+		uint8_t *expected,
+		uint8_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return __atomic_compare_exchange_n(&object->nonatomic, expected, desired, false, success, failure);
+}
+// may fail spuriously, use inside a retry loop
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak8Explicit(Thread_Atomic8_t *object,
+		uint8_t *expected,
+		uint8_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return __atomic_compare_exchange_n(&object->nonatomic, expected, desired, true, success, failure);
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchAdd8Explicit(Thread_Atomic8_t *object, int8_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_add(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchSub8Explicit(Thread_Atomic8_t *object, int8_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_sub(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchAnd8Explicit(Thread_Atomic8_t *object, uint8_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_and(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchOr8Explicit(Thread_Atomic8_t *object, uint8_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_or(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchXor8Explicit(Thread_Atomic8_t *object, uint8_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_xor(&object->nonatomic, operand, order);
+}
+// only writes if operand is smaller, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchMin8Explicit(Thread_Atomic8_t *object, uint8_t operand, Thread_atomicOrder_t order) {
+	uint8_t current = __atomic_load_n(&object->nonatomic, Thread_AtomicFailureOrder(order));
+	while (current > operand &&
+			!__atomic_compare_exchange_n(&object->nonatomic, &current, operand, true, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+// only writes if operand is larger, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchMax8Explicit(Thread_Atomic8_t *object, uint8_t operand, Thread_atomicOrder_t order) {
+	uint8_t current = __atomic_load_n(&object->nonatomic, Thread_AtomicFailureOrder(order));
+	while (current < operand &&
+			!__atomic_compare_exchange_n(&object->nonatomic, &current, operand, true, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+
+//----------------------------------------------
+//  16-bit explicit order atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicLoad16Explicit(const Thread_Atomic16_t *object, Thread_atomicOrder_t order) {
+	return __atomic_load_n(&object->nonatomic, order);
+}
+AL2O3_FORCE_INLINE void Thread_AtomicStore16Explicit(Thread_Atomic16_t *object, uint16_t desired, Thread_atomicOrder_t order) {
+	__atomic_store_n(&object->nonatomic, desired, order);
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicExchange16Explicit(Thread_Atomic16_t *object, uint16_t desired, Thread_atomicOrder_t order) {
+	return __atomic_exchange_n(&object->nonatomic, desired, order);
+}
+// on failure *expected is updated with the observed value
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeStrong16Explicit(Thread_Atomic16_t *object,
+		uint16_t *expected,
+		uint16_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return __atomic_compare_exchange_n(&object->nonatomic, expected, desired, false, success, failure);
+}
+// may fail spuriously, use inside a retry loop
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak16Explicit(Thread_Atomic16_t *object,
+		uint16_t *expected,
+		uint16_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return __atomic_compare_exchange_n(&object->nonatomic, expected, desired, true, success, failure);
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchAdd16Explicit(Thread_Atomic16_t *object, int16_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_add(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchSub16Explicit(Thread_Atomic16_t *object, int16_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_sub(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchAnd16Explicit(Thread_Atomic16_t *object, uint16_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_and(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchOr16Explicit(Thread_Atomic16_t *object, uint16_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_or(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchXor16Explicit(Thread_Atomic16_t *object, uint16_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_xor(&object->nonatomic, operand, order);
+}
+// only writes if operand is smaller, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchMin16Explicit(Thread_Atomic16_t *object, uint16_t operand, Thread_atomicOrder_t order) {
+	uint16_t current = __atomic_load_n(&object->nonatomic, Thread_AtomicFailureOrder(order));
+	while (current > operand &&
+			!__atomic_compare_exchange_n(&object->nonatomic, &current, operand, true, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+// only writes if operand is larger, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchMax16Explicit(Thread_Atomic16_t *object, uint16_t operand, Thread_atomicOrder_t order) {
+	uint16_t current = __atomic_load_n(&object->nonatomic, Thread_AtomicFailureOrder(order));
+	while (current < operand &&
+			!__atomic_compare_exchange_n(&object->nonatomic, &current, operand, true, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+
+//----------------------------------------------
+//  32-bit explicit order atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicLoad32Explicit(const Thread_Atomic32_t *object, Thread_atomicOrder_t order) {
+	return __atomic_load_n(&object->nonatomic, order);
+}
+AL2O3_FORCE_INLINE void Thread_AtomicStore32Explicit(Thread_Atomic32_t *object, uint32_t desired, Thread_atomicOrder_t order) {
+	__atomic_store_n(&object->nonatomic, desired, order);
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicExchange32Explicit(Thread_Atomic32_t *object, uint32_t desired, Thread_atomicOrder_t order) {
+	return __atomic_exchange_n(&object->nonatomic, desired, order);
+}
+// on failure *expected is updated with the observed value
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeStrong32Explicit(Thread_Atomic32_t *object,
+		uint32_t *expected,
+		uint32_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return __atomic_compare_exchange_n(&object->nonatomic, expected, desired, false, success, failure);
+}
+// may fail spuriously, use inside a retry loop
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak32Explicit(Thread_Atomic32_t *object,
+		uint32_t *expected,
+		uint32_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return __atomic_compare_exchange_n(&object->nonatomic, expected, desired, true, success, failure);
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchAdd32Explicit(Thread_Atomic32_t *object, int32_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_add(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchSub32Explicit(Thread_Atomic32_t *object, int32_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_sub(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchAnd32Explicit(Thread_Atomic32_t *object, uint32_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_and(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchOr32Explicit(Thread_Atomic32_t *object, uint32_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_or(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchXor32Explicit(Thread_Atomic32_t *object, uint32_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_xor(&object->nonatomic, operand, order);
+}
+// only writes if operand is smaller, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchMin32Explicit(Thread_Atomic32_t *object, uint32_t operand, Thread_atomicOrder_t order) {
+	uint32_t current = __atomic_load_n(&object->nonatomic, Thread_AtomicFailureOrder(order));
+	while (current > operand &&
+			!__atomic_compare_exchange_n(&object->nonatomic, &current, operand, true, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+// only writes if operand is larger, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchMax32Explicit(Thread_Atomic32_t *object, uint32_t operand, Thread_atomicOrder_t order) {
+	uint32_t current = __atomic_load_n(&object->nonatomic, Thread_AtomicFailureOrder(order));
+	while (current < operand &&
+			!__atomic_compare_exchange_n(&object->nonatomic, &current, operand, true, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+
+//----------------------------------------------
+//  64-bit explicit order atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicLoad64Explicit(const Thread_Atomic64_t *object, Thread_atomicOrder_t order) {
+	return __atomic_load_n(&object->nonatomic, order);
+}
+AL2O3_FORCE_INLINE void Thread_AtomicStore64Explicit(Thread_Atomic64_t *object, uint64_t desired, Thread_atomicOrder_t order) {
+	__atomic_store_n(&object->nonatomic, desired, order);
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicExchange64Explicit(Thread_Atomic64_t *object, uint64_t desired, Thread_atomicOrder_t order) {
+	return __atomic_exchange_n(&object->nonatomic, desired, order);
+}
+// on failure *expected is updated with the observed value
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeStrong64Explicit(Thread_Atomic64_t *object,
+		uint64_t *expected,
+		uint64_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return __atomic_compare_exchange_n(&object->nonatomic, expected, desired, false, success, failure);
+}
+// may fail spuriously, use inside a retry loop
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak64Explicit(Thread_Atomic64_t *object,
+		uint64_t *expected,
+		uint64_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return __atomic_compare_exchange_n(&object->nonatomic, expected, desired, true, success, failure);
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchAdd64Explicit(Thread_Atomic64_t *object, int64_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_add(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchSub64Explicit(Thread_Atomic64_t *object, int64_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_sub(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchAnd64Explicit(Thread_Atomic64_t *object, uint64_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_and(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchOr64Explicit(Thread_Atomic64_t *object, uint64_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_or(&object->nonatomic, operand, order);
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchXor64Explicit(Thread_Atomic64_t *object, uint64_t operand, Thread_atomicOrder_t order) {
+	return __atomic_fetch_xor(&object->nonatomic, operand, order);
+}
+// only writes if operand is smaller, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchMin64Explicit(Thread_Atomic64_t *object, uint64_t operand, Thread_atomicOrder_t order) {
+	uint64_t current = __atomic_load_n(&object->nonatomic, Thread_AtomicFailureOrder(order));
+	while (current > operand &&
+			!__atomic_compare_exchange_n(&object->nonatomic, &current, operand, true, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+// only writes if operand is larger, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchMax64Explicit(Thread_Atomic64_t *object, uint64_t operand, Thread_atomicOrder_t order) {
+	uint64_t current = __atomic_load_n(&object->nonatomic, Thread_AtomicFailureOrder(order));
+	while (current < operand &&
+			!__atomic_compare_exchange_n(&object->nonatomic, &current, operand, true, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+
+//----------------------------------------------
+//  Pointer explicit order atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE void *Thread_AtomicLoadPtrExplicit(const Thread_AtomicPtr_t *object, Thread_atomicOrder_t order) {
+	return (void *) __atomic_load_n((uintptr_t const volatile *) &object->nonatomic, order);
+}
+AL2O3_FORCE_INLINE void Thread_AtomicStorePtrExplicit(Thread_AtomicPtr_t *object, void *desired, Thread_atomicOrder_t order) {
+	__atomic_store_n((uintptr_t volatile *) &object->nonatomic, (uintptr_t) desired, order);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicExchangePtrExplicit(Thread_AtomicPtr_t *object, void *desired, Thread_atomicOrder_t order) {
+	return (void *) __atomic_exchange_n((uintptr_t volatile *) &object->nonatomic, (uintptr_t) desired, order);
+}
+// on failure *expected is updated with the observed value
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeStrongPtrExplicit(Thread_AtomicPtr_t *object,
+		void **expected,
+		void *desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return __atomic_compare_exchange_n((uintptr_t volatile *) &object->nonatomic, (uintptr_t *) expected, (uintptr_t) desired, false, success, failure);
+}
+// may fail spuriously, use inside a retry loop
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeakPtrExplicit(Thread_AtomicPtr_t *object,
+		void **expected,
+		void *desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return __atomic_compare_exchange_n((uintptr_t volatile *) &object->nonatomic, (uintptr_t *) expected, (uintptr_t) desired, true, success, failure);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicFetchAddPtrExplicit(Thread_AtomicPtr_t *object, ptrdiff_t operand, Thread_atomicOrder_t order) {
+	return (void *) __atomic_fetch_add((uintptr_t volatile *) &object->nonatomic, (uintptr_t) operand, order);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicFetchSubPtrExplicit(Thread_AtomicPtr_t *object, ptrdiff_t operand, Thread_atomicOrder_t order) {
+	return (void *) __atomic_fetch_sub((uintptr_t volatile *) &object->nonatomic, (uintptr_t) operand, order);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicFetchAndPtrExplicit(Thread_AtomicPtr_t *object, uintptr_t operand, Thread_atomicOrder_t order) {
+	return (void *) __atomic_fetch_and((uintptr_t volatile *) &object->nonatomic, (uintptr_t) operand, order);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicFetchOrPtrExplicit(Thread_AtomicPtr_t *object, uintptr_t operand, Thread_atomicOrder_t order) {
+	return (void *) __atomic_fetch_or((uintptr_t volatile *) &object->nonatomic, (uintptr_t) operand, order);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicFetchXorPtrExplicit(Thread_AtomicPtr_t *object, uintptr_t operand, Thread_atomicOrder_t order) {
+	return (void *) __atomic_fetch_xor((uintptr_t volatile *) &object->nonatomic, (uintptr_t) operand, order);
+}
@@ -0,0 +1,193 @@
+#pragma once
+/*------------------------------------------------------------------------
+  Relaxed atomics for GCC and Clang on non x64 targets (AArch64 etc.).
+  Same interface as atomic_gcc_x64.h but built on the __atomic_* builtins,
+  fences are real hardware fences as weakly ordered CPUs need them.
+------------------------------------------------------------------------*/
+
+//-------------------------------------
+//  Atomic types
+//-------------------------------------
+typedef struct { volatile uint8_t nonatomic; } Thread_Atomic8_t;
+typedef struct { volatile uint16_t nonatomic; } Thread_Atomic16_t __attribute__((aligned(2)));
+typedef struct { volatile uint32_t nonatomic; } Thread_Atomic32_t __attribute__((aligned(4)));
+typedef struct { volatile uint64_t nonatomic; } Thread_Atomic64_t __attribute__((aligned(8)));
+typedef struct { volatile platform_uint128_t nonatomic; } Thread_Atomic128_t __attribute__((aligned(16)));
+
+typedef struct { void* volatile nonatomic; } Thread_AtomicPtr_t __attribute__((aligned(8)));
+
+//-------------------------------------
+//  Fences
+//-------------------------------------
+#define Thread_AtomicSignalFenceConsume() (0)
+#define Thread_AtomicSignalFenceAcquire() __atomic_signal_fence(__ATOMIC_ACQUIRE)
+#define Thread_AtomicSignalFenceRelease() __atomic_signal_fence(__ATOMIC_RELEASE)
+#define Thread_AtomicSignalFenceSeqCst() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+
+#define Thread_AtomicThreadFenceConsume() (0)
+#define Thread_AtomicThreadFenceAcquire() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define Thread_AtomicThreadFenceRelease() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define Thread_AtomicThreadFenceSeqCst() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+// spin wait hint, lets the sibling hyperthread run and saves power
+#if defined(__aarch64__) || defined(__arm__)
+#define Thread_AtomicPause() asm volatile("yield" ::: "memory")
+#else
+#define Thread_AtomicPause() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#endif
+
+//----------------------------------------------
+//  8-bit atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicLoad8Relaxed(const Thread_Atomic8_t* object) {
+	return __atomic_load_n(&object->nonatomic, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE void Thread_AtomicStore8Relaxed(Thread_Atomic8_t* object, uint8_t desired) {
+	__atomic_store_n(&object->nonatomic, desired, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicCompareExchange8Relaxed(Thread_Atomic8_t* object, uint8_t expected, uint8_t desired) {
+	__atomic_compare_exchange_n(&object->nonatomic, &expected, desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	return expected;
+}
+
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicExchange8Relaxed(Thread_Atomic8_t* object, uint8_t desired) {
+	return __atomic_exchange_n(&object->nonatomic, desired, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchAdd8Relaxed(Thread_Atomic8_t* object, int8_t operand) {
+	return __atomic_fetch_add(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchAnd8Relaxed(Thread_Atomic8_t* object, uint8_t operand) {
+	return __atomic_fetch_and(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchOr8Relaxed(Thread_Atomic8_t* object, uint8_t operand) {
+	return __atomic_fetch_or(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+//----------------------------------------------
+//  16-bit atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicLoad16Relaxed(const Thread_Atomic16_t* object) {
+	return __atomic_load_n(&object->nonatomic, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE void Thread_AtomicStore16Relaxed(Thread_Atomic16_t* object, uint16_t desired) {
+	__atomic_store_n(&object->nonatomic, desired, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicCompareExchange16Relaxed(Thread_Atomic16_t* object, uint16_t expected, uint16_t desired) {
+	__atomic_compare_exchange_n(&object->nonatomic, &expected, desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	return expected;
+}
+
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicExchange16Relaxed(Thread_Atomic16_t* object, uint16_t desired) {
+	return __atomic_exchange_n(&object->nonatomic, desired, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchAdd16Relaxed(Thread_Atomic16_t* object, int16_t operand) {
+	return __atomic_fetch_add(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchAnd16Relaxed(Thread_Atomic16_t* object, uint16_t operand) {
+	return __atomic_fetch_and(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchOr16Relaxed(Thread_Atomic16_t* object, uint16_t operand) {
+	return __atomic_fetch_or(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+//----------------------------------------------
+//  32-bit atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicLoad32Relaxed(const Thread_Atomic32_t* object) {
+	return __atomic_load_n(&object->nonatomic, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE void Thread_AtomicStore32Relaxed(Thread_Atomic32_t* object, uint32_t desired) {
+	__atomic_store_n(&object->nonatomic, desired, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicCompareExchange32Relaxed(Thread_Atomic32_t* object, uint32_t expected, uint32_t desired) {
+	__atomic_compare_exchange_n(&object->nonatomic, &expected, desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	return expected;
+}
+
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicExchange32Relaxed(Thread_Atomic32_t* object, uint32_t desired) {
+	return __atomic_exchange_n(&object->nonatomic, desired, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchAdd32Relaxed(Thread_Atomic32_t* object, int32_t operand) {
+	return __atomic_fetch_add(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchAnd32Relaxed(Thread_Atomic32_t* object, uint32_t operand) {
+	return __atomic_fetch_and(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchOr32Relaxed(Thread_Atomic32_t* object, uint32_t operand) {
+	return __atomic_fetch_or(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+//----------------------------------------------
+//  64-bit atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicLoad64Relaxed(const Thread_Atomic64_t* object) {
+	return __atomic_load_n(&object->nonatomic, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE void Thread_AtomicStore64Relaxed(Thread_Atomic64_t* object, uint64_t desired) {
+	__atomic_store_n(&object->nonatomic, desired, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicCompareExchange64Relaxed(Thread_Atomic64_t* object, uint64_t expected, uint64_t desired) {
+	__atomic_compare_exchange_n(&object->nonatomic, &expected, desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	return expected;
+}
+
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicExchange64Relaxed(Thread_Atomic64_t* object, uint64_t desired) {
+	return __atomic_exchange_n(&object->nonatomic, desired, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchAdd64Relaxed(Thread_Atomic64_t* object, int64_t operand) {
+	return __atomic_fetch_add(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchAnd64Relaxed(Thread_Atomic64_t* object, uint64_t operand) {
+	return __atomic_fetch_and(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchOr64Relaxed(Thread_Atomic64_t* object, uint64_t operand) {
+	return __atomic_fetch_or(&object->nonatomic, operand, __ATOMIC_RELAXED);
+}
+
+// 128 bit atomics (LSE2/casp on AArch64, otherwise libatomic)
+AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicLoad128Relaxed(Thread_Atomic128_t* object) {
+	return (platform_uint128_t)__atomic_load_n((__int128 volatile*)&object->nonatomic, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE void Thread_AtomicStore128Relaxed(Thread_Atomic128_t* object, platform_uint128_t desired) {
+	__atomic_store_n((__int128 volatile*)&object->nonatomic, (__int128)desired, __ATOMIC_RELAXED);
+}
+
+AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicCompareExchange128Relaxed(Thread_Atomic128_t* object, platform_uint128_t expected, platform_uint128_t desired) {
+	__int128 e = (__int128)expected;
+	__atomic_compare_exchange_n((__int128 volatile*)&object->nonatomic, &e, (__int128)desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	return (platform_uint128_t)e;
+}
+
+// on failure *expected is updated with the observed value
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak128Relaxed(Thread_Atomic128_t* object, platform_uint128_t* expected, platform_uint128_t desired) {
+	__int128 e = (__int128)*expected;
+	if (__atomic_compare_exchange_n((__int128 volatile*)&object->nonatomic, &e, (__int128)desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		return true;
+	*expected = (platform_uint128_t)e;
+	return false;
+}
+
+AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicExchange128Relaxed(Thread_Atomic128_t* object, platform_uint128_t desired) {
+	return (platform_uint128_t)__atomic_exchange_n((__int128 volatile*)&object->nonatomic, (__int128)desired, __ATOMIC_RELAXED);
+}
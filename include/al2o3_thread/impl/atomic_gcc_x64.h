@@ -10,6 +10,8 @@
   implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
   See the LICENSE file for more information.
 ------------------------------------------------------------------------*/
+#include <cpuid.h>
+#include <string.h>
 
 //-------------------------------------
 //  Atomic types
@@ -35,6 +37,9 @@ typedef struct { void* volatile nonatomic; } Thread_AtomicPtr_t __attribute__((a
 #define Thread_AtomicThreadFenceRelease() asm volatile("" ::: "memory")
 #define Thread_AtomicThreadFenceSeqCst() asm volatile("lock; orl $0, (%%rsp)" ::: "memory")
 
+// spin wait hint, lets the sibling hyperthread run and saves power
+#define Thread_AtomicPause() asm volatile("pause" ::: "memory")
+
 //----------------------------------------------
 //  8-bit atomic operations
 //----------------------------------------------
@@ -173,18 +178,84 @@ AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchOr64Relaxed(Thread_Atomic64_t* obj
 }
 
 // 128 bit atomics
+// Intel, AMD and Zhaoxin guarantee that 16 byte aligned SSE/AVX loads and
+// stores are atomic on any CPU that reports AVX. On those we never touch
+// cmpxchg16b for plain loads/stores, so readers share the cache line instead of
+// taking it exclusive. Other vendors don't document it, so like libatomic they
+// and older CPUs fall back to cmpxchg16b.
+// 0 = not checked yet, 1 = atomic vector load/store, 2 = use cmpxchg16b
+static int Thread_Atomic128VectorLoadStoreState;
+typedef long long Thread_AtomicVector128_t __attribute__((vector_size(16)));
+
+AL2O3_FORCE_INLINE int Thread_Atomic128CheckVectorLoadStore(void) {
+	static char const vendors[][13] = {"GenuineIntel", "AuthenticAMD", "CentaurHauls", "  Shanghai  "};
+	unsigned int eax, ebx, ecx, edx;
+	if (!__builtin_cpu_supports("avx") || !__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
+		return 2;
+	}
+	unsigned int const vendor[3] = {ebx, edx, ecx};
+	for (size_t i = 0; i < sizeof(vendors) / sizeof(vendors[0]); ++i) {
+		if (memcmp(vendor, vendors[i], 12) == 0) {
+			return 1;
+		}
+	}
+	return 2;
+}
+
+AL2O3_FORCE_INLINE bool Thread_Atomic128HasAtomicVectorLoadStore(void) {
+	int state = __atomic_load_n(&Thread_Atomic128VectorLoadStoreState, __ATOMIC_RELAXED);
+	if (state == 0) {
+		state = Thread_Atomic128CheckVectorLoadStore();
+		__atomic_store_n(&Thread_Atomic128VectorLoadStoreState, state, __ATOMIC_RELAXED);
+	}
+	return state == 1;
+}
+
 AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicLoad128Relaxed(Thread_Atomic128_t* object) {
-	return (platform_uint128_t)__sync_fetch_and_or((__int128*)&object->nonatomic, 0);
+	if (Thread_Atomic128HasAtomicVectorLoadStore()) {
+		Thread_AtomicVector128_t result;
+		asm volatile("movdqa %1, %0" : "=x"(result) : "m"(object->nonatomic));
+		return (platform_uint128_t)(__int128)result;
+	}
+	// cmpxchg16b always writes, this is the slow contended path
+	return (platform_uint128_t)__sync_val_compare_and_swap((__int128*)&object->nonatomic, (__int128)0, (__int128)0);
 }
 
 AL2O3_FORCE_INLINE void Thread_AtomicStore128Relaxed(Thread_Atomic128_t* object, platform_uint128_t desired) {
-	// x64 with cx16 can handle 128 bit atomics
-	while(!__sync_bool_compare_and_swap((__int128*)&object->nonatomic, (__int128)Thread_AtomicLoad128Relaxed(object), (__int128)desired))
+	if (Thread_Atomic128HasAtomicVectorLoadStore()) {
+		Thread_AtomicVector128_t value = (Thread_AtomicVector128_t)(__int128)desired;
+		asm volatile("movdqa %1, %0" : "=m"(object->nonatomic) : "x"(value));
+		return;
+	}
+	// x64 with cx16 can handle 128 bit atomics, a torn first guess just costs a retry
+	__int128 expected = (__int128)object->nonatomic;
+	__int128 previous;
+	while((previous = __sync_val_compare_and_swap((__int128*)&object->nonatomic, expected, (__int128)desired)) != expected)
 	{
-		// try again
+		expected = previous;
 	}
 }
 
 AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicCompareExchange128Relaxed(Thread_Atomic128_t* object, platform_uint128_t expected, platform_uint128_t desired) {
 	return (platform_uint128_t)__sync_val_compare_and_swap((__int128*)&object->nonatomic, (__int128)expected, (__int128)desired);
 }
+
+// on failure *expected is updated with the observed value
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak128Relaxed(Thread_Atomic128_t* object, platform_uint128_t* expected, platform_uint128_t desired) {
+	__int128 e = (__int128)*expected;
+	__int128 previous = __sync_val_compare_and_swap((__int128*)&object->nonatomic, e, (__int128)desired);
+	if (previous == e)
+		return true;
+	*expected = (platform_uint128_t)previous;
+	return false;
+}
+
+AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicExchange128Relaxed(Thread_Atomic128_t* object, platform_uint128_t desired) {
+	__int128 expected = (__int128)object->nonatomic;
+	__int128 previous;
+	while((previous = __sync_val_compare_and_swap((__int128*)&object->nonatomic, expected, (__int128)desired)) != expected)
+	{
+		expected = previous;
+	}
+	return (platform_uint128_t)previous;
+}
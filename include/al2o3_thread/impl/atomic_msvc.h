@@ -13,6 +13,7 @@
 #include "al2o3_platform/platform.h"
 
 #include <intrin.h>
+#include <string.h>
 #pragma intrinsic(_ReadWriteBarrier)
 #pragma intrinsic(_InterlockedCompareExchange8)
 #pragma intrinsic(_InterlockedCompareExchange16)
@@ -39,6 +40,10 @@
 #pragma intrinsic(_InterlockedOr16)
 #pragma intrinsic(_InterlockedOr)
 #pragma intrinsic(_InterlockedOr64)
+#pragma intrinsic(_InterlockedXor8)
+#pragma intrinsic(_InterlockedXor16)
+#pragma intrinsic(_InterlockedXor)
+#pragma intrinsic(_InterlockedXor64)
 
 //-------------------------------------
 //  Atomic types
@@ -64,6 +69,9 @@ typedef struct { void* volatile nonatomic; } __declspec(align(8)) Thread_AtomicP
 #define Thread_AtomicThreadFenceRelease() _ReadWriteBarrier()
 #define Thread_AtomicThreadFenceSeqCst() MemoryBarrier()
 
+// spin wait hint, lets the sibling hyperthread run and saves power
+#define Thread_AtomicPause() _mm_pause()
+
 //----------------------------------------------
 //  8-bit atomic operations
 //----------------------------------------------
@@ -235,6 +243,39 @@ AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchOr64Relaxed(Thread_Atomic64_t* obj
 
 
 // 128 bit atomics
+// Intel, AMD and Zhaoxin guarantee that 16 byte aligned SSE/AVX loads and
+// stores are atomic on any CPU that reports AVX. On those we never touch
+// cmpxchg16b for plain loads/stores, so readers share the cache line instead of
+// taking it exclusive. Other vendors don't document it, so like libatomic they
+// fall back to cmpxchg16b.
+// 0 = not checked yet, 1 = atomic vector load/store, 2 = use cmpxchg16b
+__declspec(selectany) volatile long Thread_Atomic128VectorLoadStoreState = 0;
+
+AL2O3_FORCE_INLINE long Thread_Atomic128CheckVectorLoadStore(void) {
+	static char const vendors[][13] = {"GenuineIntel", "AuthenticAMD", "CentaurHauls", "  Shanghai  "};
+	int info[4];
+	__cpuid(info, 1);
+	if (!(info[2] & (1 << 28))) { // CPUID.1:ECX.AVX
+		return 2;
+	}
+	__cpuid(info, 0);
+	int const vendor[3] = {info[1], info[3], info[2]}; // EBX, EDX, ECX
+	for (size_t i = 0; i < sizeof(vendors) / sizeof(vendors[0]); ++i) {
+		if (memcmp(vendor, vendors[i], 12) == 0) {
+			return 1;
+		}
+	}
+	return 2;
+}
+
+AL2O3_FORCE_INLINE bool Thread_Atomic128HasAtomicVectorLoadStore(void) {
+	long state = Thread_Atomic128VectorLoadStoreState;
+	if (state == 0) {
+		state = Thread_Atomic128CheckVectorLoadStore();
+		Thread_Atomic128VectorLoadStoreState = state;
+	}
+	return state == 1;
+}
 
 AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicCompareExchange128Relaxed(Thread_Atomic128_t* object, platform_uint128_t expected, platform_uint128_t desired) {
 	_InterlockedCompareExchange128(object->nonatomic.m128i_i64, desired.m128i_i64[1], desired.m128i_i64[0], expected.m128i_i64);
@@ -242,6 +283,10 @@ AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicCompareExchange128Relaxed(Thr
 }
 
 AL2O3_FORCE_INLINE void Thread_AtomicStore128Relaxed(Thread_Atomic128_t* object, platform_uint128_t desired) {
+	if (Thread_Atomic128HasAtomicVectorLoadStore()) {
+		_mm_store_si128((__m128i*)&object->nonatomic, desired);
+		return;
+	}
 	// x64 with cx16 can handle 128 bit atomics
 Redo:;
 	platform_uint128_t s = *((platform_uint128_t*)&object->nonatomic);
@@ -251,6 +296,9 @@ Redo:;
 }
 
 AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicLoad128Relaxed(Thread_Atomic128_t* object) {
+	if (Thread_Atomic128HasAtomicVectorLoadStore()) {
+		return _mm_load_si128((__m128i const*)&object->nonatomic);
+	}
 Redo:;
 	platform_uint128_t s = *((platform_uint128_t*)&object->nonatomic);
 	if(!_InterlockedCompareExchange128(object->nonatomic.m128i_i64, s.m128i_i64[1], s.m128i_i64[0], s.m128i_i64)) {
@@ -258,3 +306,375 @@ Redo:;
 	}
 	return s;
 }
+
+// on failure *expected is updated with the observed value
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak128Relaxed(Thread_Atomic128_t* object, platform_uint128_t* expected, platform_uint128_t desired) {
+	return _InterlockedCompareExchange128(object->nonatomic.m128i_i64, desired.m128i_i64[1], desired.m128i_i64[0], expected->m128i_i64) != 0;
+}
+
+AL2O3_FORCE_INLINE platform_uint128_t Thread_AtomicExchange128Relaxed(Thread_Atomic128_t* object, platform_uint128_t desired) {
+	platform_uint128_t previous = *((platform_uint128_t*)&object->nonatomic);
+	while(!_InterlockedCompareExchange128(object->nonatomic.m128i_i64, desired.m128i_i64[1], desired.m128i_i64[0], previous.m128i_i64)) {
+		// previous now holds the current value, try again
+	}
+	return previous;
+}
+
+//----------------------------------------------------------------------
+//  C11 style explicit memory order atomics
+//  Interlocked ops are full barriers on x64 so every read-modify-write
+//  is already seq_cst, only loads and stores need the order checked.
+//----------------------------------------------------------------------
+AL2O3_FORCE_INLINE Thread_atomicOrder_t Thread_AtomicFailureOrder(Thread_atomicOrder_t order) {
+	return order == Thread_ATOMIC_RELEASE ? Thread_ATOMIC_RELAXED :
+				 order == Thread_ATOMIC_ACQ_REL ? Thread_ATOMIC_ACQUIRE : order;
+}
+
+AL2O3_FORCE_INLINE void Thread_AtomicThreadFenceExplicit(Thread_atomicOrder_t order) {
+	if (order == Thread_ATOMIC_SEQ_CST)
+		MemoryBarrier();
+	else if (order != Thread_ATOMIC_RELAXED)
+		_ReadWriteBarrier();
+}
+AL2O3_FORCE_INLINE void Thread_AtomicSignalFenceExplicit(Thread_atomicOrder_t order) {
+	if (order != Thread_ATOMIC_RELAXED)
+		_ReadWriteBarrier();
+}
+
+//----------------------------------------------
+//  8-bit explicit order atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicLoad8Explicit(const Thread_Atomic8_t *object, Thread_atomicOrder_t order) {
+	uint8_t result = ((volatile Thread_Atomic8_t*) object)->nonatomic;
+	if (order != Thread_ATOMIC_RELAXED)
+		_ReadWriteBarrier();
+	return result;
+}
+AL2O3_FORCE_INLINE void Thread_AtomicStore8Explicit(Thread_Atomic8_t *object, uint8_t desired, Thread_atomicOrder_t order) {
+	if (order == Thread_ATOMIC_SEQ_CST) {
+		_InterlockedExchange8((volatile char *) object, (char) desired);
+		return;
+	}
+	if (order != Thread_ATOMIC_RELAXED)
+		_ReadWriteBarrier();
+	((volatile Thread_Atomic8_t *) object)->nonatomic = desired;
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicExchange8Explicit(Thread_Atomic8_t *object, uint8_t desired, Thread_atomicOrder_t order) {
+	return (uint8_t) _InterlockedExchange8((volatile char *) object, (char) desired);
+}
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeStrong8Explicit(Thread_Atomic8_t *object,
+		uint8_t *expected,
+		uint8_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	uint8_t e = *expected;
+	uint8_t previous = (uint8_t) _InterlockedCompareExchange8((volatile char *) object, (char) desired, (char) e);
+	if (previous == e)
+		return true;
+	*expected = previous;
+	return false;
+}
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak8Explicit(Thread_Atomic8_t *object,
+		uint8_t *expected,
+		uint8_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return Thread_AtomicCompareExchangeStrong8Explicit(object, expected, desired, success, failure);
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchAdd8Explicit(Thread_Atomic8_t *object, int8_t operand, Thread_atomicOrder_t order) {
+	return (uint8_t) _InterlockedExchangeAdd8((volatile char *) object, (char) operand);
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchSub8Explicit(Thread_Atomic8_t *object, int8_t operand, Thread_atomicOrder_t order) {
+	return (uint8_t) _InterlockedExchangeAdd8((volatile char *) object, (char) (0 - (uint8_t) operand));
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchAnd8Explicit(Thread_Atomic8_t *object, uint8_t operand, Thread_atomicOrder_t order) {
+	return (uint8_t) _InterlockedAnd8((volatile char *) object, (char) operand);
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchOr8Explicit(Thread_Atomic8_t *object, uint8_t operand, Thread_atomicOrder_t order) {
+	return (uint8_t) _InterlockedOr8((volatile char *) object, (char) operand);
+}
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchXor8Explicit(Thread_Atomic8_t *object, uint8_t operand, Thread_atomicOrder_t order) {
+	return (uint8_t) _InterlockedXor8((volatile char *) object, (char) operand);
+}
+// only writes if operand is smaller, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchMin8Explicit(Thread_Atomic8_t *object, uint8_t operand, Thread_atomicOrder_t order) {
+	uint8_t current = Thread_AtomicLoad8Explicit(object, Thread_AtomicFailureOrder(order));
+	while (current > operand &&
+			!Thread_AtomicCompareExchangeWeak8Explicit(object, &current, operand, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+// only writes if operand is larger, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint8_t Thread_AtomicFetchMax8Explicit(Thread_Atomic8_t *object, uint8_t operand, Thread_atomicOrder_t order) {
+	uint8_t current = Thread_AtomicLoad8Explicit(object, Thread_AtomicFailureOrder(order));
+	while (current < operand &&
+			!Thread_AtomicCompareExchangeWeak8Explicit(object, &current, operand, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+
+//----------------------------------------------
+//  16-bit explicit order atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicLoad16Explicit(const Thread_Atomic16_t *object, Thread_atomicOrder_t order) {
+	uint16_t result = ((volatile Thread_Atomic16_t*) object)->nonatomic;
+	if (order != Thread_ATOMIC_RELAXED)
+		_ReadWriteBarrier();
+	return result;
+}
+AL2O3_FORCE_INLINE void Thread_AtomicStore16Explicit(Thread_Atomic16_t *object, uint16_t desired, Thread_atomicOrder_t order) {
+	if (order == Thread_ATOMIC_SEQ_CST) {
+		_InterlockedExchange16((volatile short *) object, (short) desired);
+		return;
+	}
+	if (order != Thread_ATOMIC_RELAXED)
+		_ReadWriteBarrier();
+	((volatile Thread_Atomic16_t *) object)->nonatomic = desired;
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicExchange16Explicit(Thread_Atomic16_t *object, uint16_t desired, Thread_atomicOrder_t order) {
+	return (uint16_t) _InterlockedExchange16((volatile short *) object, (short) desired);
+}
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeStrong16Explicit(Thread_Atomic16_t *object,
+		uint16_t *expected,
+		uint16_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	uint16_t e = *expected;
+	uint16_t previous = (uint16_t) _InterlockedCompareExchange16((volatile short *) object, (short) desired, (short) e);
+	if (previous == e)
+		return true;
+	*expected = previous;
+	return false;
+}
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak16Explicit(Thread_Atomic16_t *object,
+		uint16_t *expected,
+		uint16_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return Thread_AtomicCompareExchangeStrong16Explicit(object, expected, desired, success, failure);
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchAdd16Explicit(Thread_Atomic16_t *object, int16_t operand, Thread_atomicOrder_t order) {
+	return (uint16_t) _InterlockedExchangeAdd16((volatile short *) object, (short) operand);
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchSub16Explicit(Thread_Atomic16_t *object, int16_t operand, Thread_atomicOrder_t order) {
+	return (uint16_t) _InterlockedExchangeAdd16((volatile short *) object, (short) (0 - (uint16_t) operand));
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchAnd16Explicit(Thread_Atomic16_t *object, uint16_t operand, Thread_atomicOrder_t order) {
+	return (uint16_t) _InterlockedAnd16((volatile short *) object, (short) operand);
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchOr16Explicit(Thread_Atomic16_t *object, uint16_t operand, Thread_atomicOrder_t order) {
+	return (uint16_t) _InterlockedOr16((volatile short *) object, (short) operand);
+}
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchXor16Explicit(Thread_Atomic16_t *object, uint16_t operand, Thread_atomicOrder_t order) {
+	return (uint16_t) _InterlockedXor16((volatile short *) object, (short) operand);
+}
+// only writes if operand is smaller, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchMin16Explicit(Thread_Atomic16_t *object, uint16_t operand, Thread_atomicOrder_t order) {
+	uint16_t current = Thread_AtomicLoad16Explicit(object, Thread_AtomicFailureOrder(order));
+	while (current > operand &&
+			!Thread_AtomicCompareExchangeWeak16Explicit(object, &current, operand, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+// only writes if operand is larger, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint16_t Thread_AtomicFetchMax16Explicit(Thread_Atomic16_t *object, uint16_t operand, Thread_atomicOrder_t order) {
+	uint16_t current = Thread_AtomicLoad16Explicit(object, Thread_AtomicFailureOrder(order));
+	while (current < operand &&
+			!Thread_AtomicCompareExchangeWeak16Explicit(object, &current, operand, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+
+//----------------------------------------------
+//  32-bit explicit order atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicLoad32Explicit(const Thread_Atomic32_t *object, Thread_atomicOrder_t order) {
+	uint32_t result = ((volatile Thread_Atomic32_t*) object)->nonatomic;
+	if (order != Thread_ATOMIC_RELAXED)
+		_ReadWriteBarrier();
+	return result;
+}
+AL2O3_FORCE_INLINE void Thread_AtomicStore32Explicit(Thread_Atomic32_t *object, uint32_t desired, Thread_atomicOrder_t order) {
+	if (order == Thread_ATOMIC_SEQ_CST) {
+		_InterlockedExchange((volatile long *) object, (long) desired);
+		return;
+	}
+	if (order != Thread_ATOMIC_RELAXED)
+		_ReadWriteBarrier();
+	((volatile Thread_Atomic32_t *) object)->nonatomic = desired;
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicExchange32Explicit(Thread_Atomic32_t *object, uint32_t desired, Thread_atomicOrder_t order) {
+	return (uint32_t) _InterlockedExchange((volatile long *) object, (long) desired);
+}
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeStrong32Explicit(Thread_Atomic32_t *object,
+		uint32_t *expected,
+		uint32_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	uint32_t e = *expected;
+	uint32_t previous = (uint32_t) _InterlockedCompareExchange((volatile long *) object, (long) desired, (long) e);
+	if (previous == e)
+		return true;
+	*expected = previous;
+	return false;
+}
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak32Explicit(Thread_Atomic32_t *object,
+		uint32_t *expected,
+		uint32_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return Thread_AtomicCompareExchangeStrong32Explicit(object, expected, desired, success, failure);
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchAdd32Explicit(Thread_Atomic32_t *object, int32_t operand, Thread_atomicOrder_t order) {
+	return (uint32_t) _InterlockedExchangeAdd((volatile long *) object, (long) operand);
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchSub32Explicit(Thread_Atomic32_t *object, int32_t operand, Thread_atomicOrder_t order) {
+	return (uint32_t) _InterlockedExchangeAdd((volatile long *) object, (long) (0 - (uint32_t) operand));
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchAnd32Explicit(Thread_Atomic32_t *object, uint32_t operand, Thread_atomicOrder_t order) {
+	return (uint32_t) _InterlockedAnd((volatile long *) object, (long) operand);
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchOr32Explicit(Thread_Atomic32_t *object, uint32_t operand, Thread_atomicOrder_t order) {
+	return (uint32_t) _InterlockedOr((volatile long *) object, (long) operand);
+}
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchXor32Explicit(Thread_Atomic32_t *object, uint32_t operand, Thread_atomicOrder_t order) {
+	return (uint32_t) _InterlockedXor((volatile long *) object, (long) operand);
+}
+// only writes if operand is smaller, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchMin32Explicit(Thread_Atomic32_t *object, uint32_t operand, Thread_atomicOrder_t order) {
+	uint32_t current = Thread_AtomicLoad32Explicit(object, Thread_AtomicFailureOrder(order));
+	while (current > operand &&
+			!Thread_AtomicCompareExchangeWeak32Explicit(object, &current, operand, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+// only writes if operand is larger, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint32_t Thread_AtomicFetchMax32Explicit(Thread_Atomic32_t *object, uint32_t operand, Thread_atomicOrder_t order) {
+	uint32_t current = Thread_AtomicLoad32Explicit(object, Thread_AtomicFailureOrder(order));
+	while (current < operand &&
+			!Thread_AtomicCompareExchangeWeak32Explicit(object, &current, operand, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+
+//----------------------------------------------
+//  64-bit explicit order atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicLoad64Explicit(const Thread_Atomic64_t *object, Thread_atomicOrder_t order) {
+	uint64_t result = ((volatile Thread_Atomic64_t*) object)->nonatomic;
+	if (order != Thread_ATOMIC_RELAXED)
+		_ReadWriteBarrier();
+	return result;
+}
+AL2O3_FORCE_INLINE void Thread_AtomicStore64Explicit(Thread_Atomic64_t *object, uint64_t desired, Thread_atomicOrder_t order) {
+	if (order == Thread_ATOMIC_SEQ_CST) {
+		_InterlockedExchange64((volatile __int64 *) object, (__int64) desired);
+		return;
+	}
+	if (order != Thread_ATOMIC_RELAXED)
+		_ReadWriteBarrier();
+	((volatile Thread_Atomic64_t *) object)->nonatomic = desired;
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicExchange64Explicit(Thread_Atomic64_t *object, uint64_t desired, Thread_atomicOrder_t order) {
+	return (uint64_t) _InterlockedExchange64((volatile __int64 *) object, (__int64) desired);
+}
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeStrong64Explicit(Thread_Atomic64_t *object,
+		uint64_t *expected,
+		uint64_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	uint64_t e = *expected;
+	uint64_t previous = (uint64_t) _InterlockedCompareExchange64((volatile __int64 *) object, (__int64) desired, (__int64) e);
+	if (previous == e)
+		return true;
+	*expected = previous;
+	return false;
+}
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeak64Explicit(Thread_Atomic64_t *object,
+		uint64_t *expected,
+		uint64_t desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return Thread_AtomicCompareExchangeStrong64Explicit(object, expected, desired, success, failure);
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchAdd64Explicit(Thread_Atomic64_t *object, int64_t operand, Thread_atomicOrder_t order) {
+	return (uint64_t) _InterlockedExchangeAdd64((volatile __int64 *) object, (__int64) operand);
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchSub64Explicit(Thread_Atomic64_t *object, int64_t operand, Thread_atomicOrder_t order) {
+	return (uint64_t) _InterlockedExchangeAdd64((volatile __int64 *) object, (__int64) (0 - (uint64_t) operand));
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchAnd64Explicit(Thread_Atomic64_t *object, uint64_t operand, Thread_atomicOrder_t order) {
+	return (uint64_t) _InterlockedAnd64((volatile __int64 *) object, (__int64) operand);
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchOr64Explicit(Thread_Atomic64_t *object, uint64_t operand, Thread_atomicOrder_t order) {
+	return (uint64_t) _InterlockedOr64((volatile __int64 *) object, (__int64) operand);
+}
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchXor64Explicit(Thread_Atomic64_t *object, uint64_t operand, Thread_atomicOrder_t order) {
+	return (uint64_t) _InterlockedXor64((volatile __int64 *) object, (__int64) operand);
+}
+// only writes if operand is smaller, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchMin64Explicit(Thread_Atomic64_t *object, uint64_t operand, Thread_atomicOrder_t order) {
+	uint64_t current = Thread_AtomicLoad64Explicit(object, Thread_AtomicFailureOrder(order));
+	while (current > operand &&
+			!Thread_AtomicCompareExchangeWeak64Explicit(object, &current, operand, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+// only writes if operand is larger, so a losing caller doesn't dirty the cache line
+AL2O3_FORCE_INLINE uint64_t Thread_AtomicFetchMax64Explicit(Thread_Atomic64_t *object, uint64_t operand, Thread_atomicOrder_t order) {
+	uint64_t current = Thread_AtomicLoad64Explicit(object, Thread_AtomicFailureOrder(order));
+	while (current < operand &&
+			!Thread_AtomicCompareExchangeWeak64Explicit(object, &current, operand, order, Thread_AtomicFailureOrder(order))) {
+		// current has been reloaded, try again
+	}
+	return current;
+}
+
+//----------------------------------------------
+//  Pointer explicit order atomic operations
+//----------------------------------------------
+AL2O3_FORCE_INLINE void *Thread_AtomicLoadPtrExplicit(const Thread_AtomicPtr_t *object, Thread_atomicOrder_t order) {
+	return (void *) Thread_AtomicLoad64Explicit((const Thread_Atomic64_t *) object, order);
+}
+AL2O3_FORCE_INLINE void Thread_AtomicStorePtrExplicit(Thread_AtomicPtr_t *object, void *desired, Thread_atomicOrder_t order) {
+	Thread_AtomicStore64Explicit((Thread_Atomic64_t *) object, (uint64_t) desired, order);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicExchangePtrExplicit(Thread_AtomicPtr_t *object, void *desired, Thread_atomicOrder_t order) {
+	return (void *) Thread_AtomicExchange64Explicit((Thread_Atomic64_t *) object, (uint64_t) desired, order);
+}
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeStrongPtrExplicit(Thread_AtomicPtr_t *object,
+		void **expected,
+		void *desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return Thread_AtomicCompareExchangeStrong64Explicit((Thread_Atomic64_t *) object, (uint64_t *) expected, (uint64_t) desired, success, failure);
+}
+AL2O3_FORCE_INLINE bool Thread_AtomicCompareExchangeWeakPtrExplicit(Thread_AtomicPtr_t *object,
+		void **expected,
+		void *desired,
+		Thread_atomicOrder_t success,
+		Thread_atomicOrder_t failure) {
+	return Thread_AtomicCompareExchangeStrong64Explicit((Thread_Atomic64_t *) object, (uint64_t *) expected, (uint64_t) desired, success, failure);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicFetchAddPtrExplicit(Thread_AtomicPtr_t *object, ptrdiff_t operand, Thread_atomicOrder_t order) {
+	return (void *) Thread_AtomicFetchAdd64Explicit((Thread_Atomic64_t *) object, (int64_t) operand, order);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicFetchSubPtrExplicit(Thread_AtomicPtr_t *object, ptrdiff_t operand, Thread_atomicOrder_t order) {
+	return (void *) Thread_AtomicFetchSub64Explicit((Thread_Atomic64_t *) object, (int64_t) operand, order);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicFetchAndPtrExplicit(Thread_AtomicPtr_t *object, uintptr_t operand, Thread_atomicOrder_t order) {
+	return (void *) Thread_AtomicFetchAnd64Explicit((Thread_Atomic64_t *) object, (uint64_t) operand, order);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicFetchOrPtrExplicit(Thread_AtomicPtr_t *object, uintptr_t operand, Thread_atomicOrder_t order) {
+	return (void *) Thread_AtomicFetchOr64Explicit((Thread_Atomic64_t *) object, (uint64_t) operand, order);
+}
+AL2O3_FORCE_INLINE void *Thread_AtomicFetchXorPtrExplicit(Thread_AtomicPtr_t *object, uintptr_t operand, Thread_atomicOrder_t order) {
+	return (void *) Thread_AtomicFetchXor64Explicit((Thread_Atomic64_t *) object, (uint64_t) operand, order);
+}
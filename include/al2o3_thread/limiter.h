@@ -0,0 +1,43 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/pool.h"
+
+// Runs jobs on a Thread_Pool with at most maxConcurrent of them running at
+// once, e.g. one limiter for everything that hits the same disk.
+// Submit never blocks. A job over the limit waits in the limiter's queue
+// rather than the pool's, so it doesn't hold a worker. A slot runs queued
+// jobs in submission order on the same worker until the queue is empty.
+typedef struct Thread_Limiter *Thread_LimiterHandle;
+
+AL2O3_EXTERN_C Thread_LimiterHandle Thread_LimiterCreate(Thread_PoolHandle pool, uint32_t maxConcurrent);
+// waits for every submitted job to finish, nothing may be submitted meanwhile
+AL2O3_EXTERN_C void Thread_LimiterDestroy(Thread_LimiterHandle limiter);
+AL2O3_EXTERN_C void Thread_LimiterSubmit(Thread_LimiterHandle limiter, Thread_JobFunction func, void *data);
+// approximate, for monitoring
+AL2O3_EXTERN_C uint32_t Thread_LimiterRunningCount(Thread_LimiterHandle limiter);
+AL2O3_EXTERN_C uint32_t Thread_LimiterQueuedCount(Thread_LimiterHandle limiter);
+
+// Token bucket holding up to burst tokens, refilled at tokensPerSecond.
+// The bucket is one atomic time stamp, when it will be full again if nothing
+// more is taken (the generic cell rate algorithm). The clock it uses counts
+// tokens since create rather than ns, so any whole rate is exact. Refill is
+// worked out from the clock on each call and taking tokens is one CAS, no
+// timer or lock.
+typedef struct Thread_RateLimiter {
+	Thread_PaddedAtomic64_t fullAtToken;
+	uint64_t startNs;
+	uint64_t tokensPerSecond;
+	uint64_t burst;
+} Thread_RateLimiter;
+
+// starts full, tokensPerSecond at most 1e9
+AL2O3_EXTERN_C bool Thread_RateLimiterCreate(Thread_RateLimiter *limiter, uint64_t tokensPerSecond, uint32_t burst);
+AL2O3_EXTERN_C void Thread_RateLimiterDestroy(Thread_RateLimiter *limiter);
+// takes tokens if there are enough, tokens must not be above burst
+AL2O3_EXTERN_C bool Thread_RateLimiterTryAcquire(Thread_RateLimiter *limiter, uint32_t tokens);
+// always takes tokens, going into debt if needed. Returns how long the
+// caller should wait before using them, 0 for straight away.
+AL2O3_EXTERN_C uint64_t Thread_RateLimiterReserve(Thread_RateLimiter *limiter, uint32_t tokens);
+// tokens in the bucket right now
+AL2O3_EXTERN_C uint32_t Thread_RateLimiterAvailable(Thread_RateLimiter *limiter);
@@ -0,0 +1,24 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+
+// Marshals jobs onto the main thread (windowing, graphics APIs and the like).
+// Any thread posts through a lock free MPSC queue, a post is one atomic
+// exchange, and the main thread runs them from its own loop with
+// Thread_MainQueuePump. Jobs from any one thread run in the order posted.
+// The main thread is the one given to Thread_SetMainThread, which must be
+// called before anything is posted. Pumping from any other thread does nothing.
+
+// func/data are copied into a small heap node
+AL2O3_EXTERN_C void Thread_MainQueuePost(Thread_JobFunction func, void *data);
+// returns once func has run on the main thread, doesn't allocate.
+// On the main thread itself it just calls func.
+AL2O3_EXTERN_C void Thread_MainQueuePostAndWait(Thread_JobFunction func, void *data);
+
+// runs jobs that were waiting when called until none are left or budgetNs
+// has passed, at least one job runs if any is waiting. Jobs posted by the
+// jobs themselves wait for the next pump. Returns how many ran, always 0
+// off the main thread.
+AL2O3_EXTERN_C uint32_t Thread_MainQueuePump(uint64_t budgetNs);
+// jobs posted but not yet run
+AL2O3_EXTERN_C uint32_t Thread_MainQueueCount(void);
@@ -0,0 +1,23 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+
+// Intrusive unbounded multi producer single consumer queue (Vyukov).
+// Embed a Thread_MPSCNode in your message, a push is a single atomic exchange
+// and never fails or allocates. Only one thread may pop at a time.
+// A pop can briefly return NULL while a push is half way through (between its
+// exchange and its link), so an empty result isn't proof the queue is empty.
+typedef struct Thread_MPSCNode {
+	Thread_AtomicPtr_t next;
+} Thread_MPSCNode;
+
+typedef struct Thread_MPSCQueue {
+	Thread_AtomicPtr_t head; // producers
+	Thread_MPSCNode *tail;   // consumer
+	Thread_MPSCNode stub;
+} Thread_MPSCQueue;
+
+AL2O3_EXTERN_C bool Thread_MPSCQueueCreate(Thread_MPSCQueue *queue);
+AL2O3_EXTERN_C void Thread_MPSCQueueDestroy(Thread_MPSCQueue *queue);
+AL2O3_EXTERN_C void Thread_MPSCQueuePush(Thread_MPSCQueue *queue, Thread_MPSCNode *node);
+AL2O3_EXTERN_C Thread_MPSCNode *Thread_MPSCQueuePop(Thread_MPSCQueue *queue);
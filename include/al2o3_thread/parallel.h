@@ -0,0 +1,47 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/pool.h"
+
+// Data parallel kernels over contiguous arrays, run on a Thread_Pool.
+// Work is cut into cache sized blocks that the calling thread and up to
+// every pool worker pull from a shared counter, so uneven blocks balance
+// themselves and the caller is never just waiting while work remains.
+// Safe to call from inside a pool job. A NULL pool runs everything on the
+// calling thread.
+
+// called for [begin, end) of a Thread_ParallelFor range
+typedef void (*Thread_ParallelForFunction)(void *data, uint64_t begin, uint64_t end);
+// sort key of an element, ascending
+typedef uint64_t (*Thread_ParallelKeyFunction)(void const *element, void *userData);
+typedef bool (*Thread_ParallelPredicateFunction)(void const *element, void *userData);
+
+// blockSize 0 picks one, returns once every block has run
+AL2O3_EXTERN_C void Thread_ParallelFor(Thread_PoolHandle pool, uint64_t count, uint64_t blockSize,
+																			 Thread_ParallelForFunction func, void *data);
+
+// stable merge sort by key, needs a count * elementSize scratch allocation
+AL2O3_EXTERN_C bool Thread_ParallelSort(Thread_PoolHandle pool, void *base, uint64_t count, uint32_t elementSize,
+																				Thread_ParallelKeyFunction key, void *userData);
+
+// prefix sums, dst may be src. Exclusive puts 0 in dst[0].
+// Returns the sum of every element. Float sums are added in a different
+// order than a serial loop, so rounding can differ slightly.
+AL2O3_EXTERN_C uint32_t Thread_ParallelScanU32(Thread_PoolHandle pool, uint32_t const *src, uint32_t *dst,
+																							 uint64_t count, bool inclusive);
+AL2O3_EXTERN_C uint64_t Thread_ParallelScanU64(Thread_PoolHandle pool, uint64_t const *src, uint64_t *dst,
+																							 uint64_t count, bool inclusive);
+AL2O3_EXTERN_C float Thread_ParallelScanF32(Thread_PoolHandle pool, float const *src, float *dst,
+																						uint64_t count, bool inclusive);
+AL2O3_EXTERN_C double Thread_ParallelScanF64(Thread_PoolHandle pool, double const *src, double *dst,
+																						 uint64_t count, bool inclusive);
+
+// dst must not overlap src, both keep the original order within each side.
+// Partition writes every element that passes then every one that doesn't,
+// compact writes only those that pass. Both return how many passed.
+// The predicate is called twice per element.
+AL2O3_EXTERN_C uint64_t Thread_ParallelPartition(Thread_PoolHandle pool, void const *src, void *dst, uint64_t count,
+																								 uint32_t elementSize, Thread_ParallelPredicateFunction predicate,
+																								 void *userData);
+AL2O3_EXTERN_C uint64_t Thread_ParallelCompact(Thread_PoolHandle pool, void const *src, void *dst, uint64_t count,
+																							 uint32_t elementSize, Thread_ParallelPredicateFunction predicate,
+																							 void *userData);
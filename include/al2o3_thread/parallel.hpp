@@ -0,0 +1,55 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/parallel.h"
+#include <type_traits>
+
+namespace Thread {
+
+// func(begin, end)
+template<typename Func>
+void ParallelFor(Thread_PoolHandle pool, uint64_t count, uint64_t blockSize, Func const &func) {
+	Thread_ParallelFor(pool, count, blockSize, [](void *data, uint64_t begin, uint64_t end) {
+		(*(Func const *) data)(begin, end);
+	}, (void *) &func);
+}
+
+// key(item) returns the uint64_t sort key, the sort is stable
+template<typename T, typename KeyFunc>
+bool ParallelSort(Thread_PoolHandle pool, T *items, uint64_t count, KeyFunc const &key) {
+	static_assert(std::is_trivially_copyable<T>::value, "items are moved as raw bytes");
+	return Thread_ParallelSort(pool, items, count, sizeof(T), [](void const *element, void *userData) -> uint64_t {
+		return (*(KeyFunc const *) userData)(*(T const *) element);
+	}, (void *) &key);
+}
+
+inline uint32_t ParallelScan(Thread_PoolHandle pool, uint32_t const *src, uint32_t *dst, uint64_t count, bool inclusive) {
+	return Thread_ParallelScanU32(pool, src, dst, count, inclusive);
+}
+inline uint64_t ParallelScan(Thread_PoolHandle pool, uint64_t const *src, uint64_t *dst, uint64_t count, bool inclusive) {
+	return Thread_ParallelScanU64(pool, src, dst, count, inclusive);
+}
+inline float ParallelScan(Thread_PoolHandle pool, float const *src, float *dst, uint64_t count, bool inclusive) {
+	return Thread_ParallelScanF32(pool, src, dst, count, inclusive);
+}
+inline double ParallelScan(Thread_PoolHandle pool, double const *src, double *dst, uint64_t count, bool inclusive) {
+	return Thread_ParallelScanF64(pool, src, dst, count, inclusive);
+}
+
+// predicate(item) returns true for items that go first / are kept
+template<typename T, typename Predicate>
+uint64_t ParallelPartition(Thread_PoolHandle pool, T const *src, T *dst, uint64_t count, Predicate const &predicate) {
+	static_assert(std::is_trivially_copyable<T>::value, "items are moved as raw bytes");
+	return Thread_ParallelPartition(pool, src, dst, count, sizeof(T), [](void const *element, void *userData) -> bool {
+		return (*(Predicate const *) userData)(*(T const *) element);
+	}, (void *) &predicate);
+}
+
+template<typename T, typename Predicate>
+uint64_t ParallelCompact(Thread_PoolHandle pool, T const *src, T *dst, uint64_t count, Predicate const &predicate) {
+	static_assert(std::is_trivially_copyable<T>::value, "items are moved as raw bytes");
+	return Thread_ParallelCompact(pool, src, dst, count, sizeof(T), [](void const *element, void *userData) -> bool {
+		return (*(Predicate const *) userData)(*(T const *) element);
+	}, (void *) &predicate);
+}
+
+}; // end Thread namespace
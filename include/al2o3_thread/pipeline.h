@@ -0,0 +1,38 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/pool.h"
+
+// Streaming pipeline of stages on a Thread_Pool, in the style of TBB's
+// parallel_pipeline.
+// The first stage produces items one at a time until it returns NULL, every
+// later stage takes an item and returns the item for the stage after it.
+// A thread that finishes a stage carries the item straight into the next one,
+// so an item mostly stays in one core's cache from end to end. It only
+// changes thread when it reaches a serial stage that is busy, it then waits
+// in that stage and the thread leaving the stage hands it to the pool.
+// At most maxTokens items are in flight, the first stage isn't called again
+// until one has finished the last stage, which bounds the memory in flight.
+// A thread that finishes an item goes back to the first stage for another.
+// A NULL pool runs each item through every stage in turn on the calling thread.
+typedef enum Thread_PipelineMode {
+	Thread_PIPELINE_PARALLEL = 0,        // any number of items at once
+	Thread_PIPELINE_SERIAL_IN_ORDER,     // one item at a time in the order the first stage produced them
+	Thread_PIPELINE_SERIAL_OUT_OF_ORDER, // one item at a time in any order
+} Thread_PipelineMode;
+
+// item is NULL for the first stage. Returns the item for the next stage,
+// only the first stage may return NULL, the last stage's return is ignored.
+typedef void *(*Thread_PipelineStageFunction)(void *item, void *userData);
+
+typedef struct Thread_PipelineStage {
+	Thread_PipelineStageFunction func;
+	void *userData;
+	Thread_PipelineMode mode; // ignored for the first stage, it is always serial
+} Thread_PipelineStage;
+
+// maxTokens 0 picks a default from the pool's worker count. Returns once the
+// first stage has returned NULL and every item has left the last stage.
+// Blocks the calling thread while workers run, don't call it from a job on
+// the same pool.
+AL2O3_EXTERN_C void Thread_PipelineRun(Thread_PoolHandle pool, uint32_t maxTokens,
+																			 Thread_PipelineStage const *stages, uint32_t stageCount);
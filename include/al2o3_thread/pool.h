@@ -0,0 +1,80 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+
+// Elastic worker pool running Thread_JobFunction jobs.
+// Each worker owns a work stealing deque, jobs submitted from a worker go to
+// its own deque, anything else goes through a shared lock free queue.
+// General worker threads are started on demand and the total never exceeds the
+// usable CPU count.
+// An idle worker spins for a short window then parks on a futex, a submission
+// only wakes a worker if nobody is already searching for work, and a searcher
+// that finds work wakes the next one if more is queued, so a burst ramps up
+// one worker at a time instead of waking the whole pool.
+// Workers above minWorkers that stay parked for retireMs exit their thread,
+// an idle pool costs no CPU.
+// Jobs have a priority, each lane has its own shared queue and per worker deque.
+// Workers always take the highest lane with work, except every agingInterval
+// jobs they serve a lower lane first so background work can't starve.
+// reservedHighWorkers only ever run high priority jobs, so the high lane's
+// latency doesn't depend on how much long running background work is queued.
+// They are all started by create and parked until high priority work arrives.
+typedef struct Thread_Pool *Thread_PoolHandle;
+
+typedef enum Thread_PoolPriority {
+	Thread_POOL_PRIORITY_HIGH = 0,
+	Thread_POOL_PRIORITY_NORMAL,
+	Thread_POOL_PRIORITY_LOW,
+	Thread_POOL_PRIORITY_COUNT
+} Thread_PoolPriority;
+
+// zero in any field selects the default
+typedef struct Thread_PoolDesc {
+	uint32_t maxWorkers;          // clamped to Thread_CPUUsableCoreCount
+	uint32_t minWorkers;          // workers never retired once started
+	uint32_t spinRounds;          // rounds of looking for work before parking
+	uint32_t retireMs;            // parked time before a worker above minWorkers exits
+	uint32_t queueCapacity;       // per lane shared queue size, rounded up to a power of 2
+	uint32_t reservedHighWorkers; // at most maxWorkers - 1, started by create and never retired
+	uint32_t agingInterval;       // jobs between turns for the lower lanes
+} Thread_PoolDesc;
+
+// desc may be NULL for all defaults
+AL2O3_EXTERN_C Thread_PoolHandle Thread_PoolCreate(Thread_PoolDesc const *desc);
+// runs every queued job then joins the workers, must not be called from a worker
+AL2O3_EXTERN_C void Thread_PoolDestroy(Thread_PoolHandle pool);
+
+// never blocks, if the queues are full the job runs on the calling thread
+// Thread_PoolSubmit uses Thread_POOL_PRIORITY_NORMAL
+AL2O3_EXTERN_C void Thread_PoolSubmit(Thread_PoolHandle pool, Thread_JobFunction func, void *data);
+AL2O3_EXTERN_C void Thread_PoolSubmitPriority(Thread_PoolHandle pool, Thread_PoolPriority priority,
+																							Thread_JobFunction func, void *data);
+
+AL2O3_EXTERN_C uint32_t Thread_PoolMaxWorkerCount(Thread_PoolHandle pool);
+AL2O3_EXTERN_C uint32_t Thread_PoolReservedHighWorkerCount(Thread_PoolHandle pool);
+// worker threads currently alive, parked or not
+AL2O3_EXTERN_C uint32_t Thread_PoolWorkerCount(Thread_PoolHandle pool);
+// approximate number of jobs waiting to run
+AL2O3_EXTERN_C uint32_t Thread_PoolQueueDepth(Thread_PoolHandle pool);
+
+// Per worker slot, cumulative over every thread that has run in the slot.
+// Workers only read the clock when they switch between running jobs, looking
+// for work and parking, so a busy worker pays a counter store per job.
+// Cheap to read at any rate, the OS side of a worker is in Thread_StatsGetAll.
+typedef struct Thread_PoolWorkerStats {
+	uint64_t osThreadId;    // current or last thread, matches Thread_ThreadStats, 0 if never started
+	uint64_t busyNs;        // running jobs
+	uint64_t stealingNs;    // out of work, spinning on the queues and trying to steal
+	uint64_t idleNs;        // parked
+	uint64_t jobsExecuted;
+	uint64_t stealAttempts; // tries on another worker's deque that had work
+	uint64_t steals;        // tries that won a job, over stealAttempts is the success rate
+	bool alive;
+} Thread_PoolWorkerStats;
+
+// writes up to maxCount worker slots in index order, returns Thread_PoolMaxWorkerCount
+AL2O3_EXTERN_C uint32_t Thread_PoolGetWorkerStats(Thread_PoolHandle pool, Thread_PoolWorkerStats *stats,
+																									 uint32_t maxCount);
+
+// pool the calling thread is a worker of or NULL
+AL2O3_EXTERN_C Thread_PoolHandle Thread_PoolGetCurrent(void);
@@ -0,0 +1,35 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+
+// Sequence lock, for state with one writer and many readers.
+// Readers copy the state and retry if a write overlapped the copy. They never
+// write shared memory, so they don't slow each other or the writer down, and
+// the writer never waits on a reader.
+// Best for small snapshots that are read far more than written. Back to back
+// writes that take longer than a copy can starve readers.
+// Only one writer at a time, serialise writers yourself if there are more.
+// Zero initialised is ready to use.
+typedef struct Thread_SeqLock {
+	Thread_Atomic32_t sequence; // odd while a write is in progress
+} Thread_SeqLock;
+
+AL2O3_EXTERN_C bool Thread_SeqLockCreate(Thread_SeqLock *lock);
+AL2O3_EXTERN_C void Thread_SeqLockDestroy(Thread_SeqLock *lock);
+
+// copies a whole blob in or out, shared must be 8 byte aligned
+AL2O3_EXTERN_C void Thread_SeqLockWrite(Thread_SeqLock *lock, void *shared, void const *src, size_t size);
+AL2O3_EXTERN_C void Thread_SeqLockRead(Thread_SeqLock const *lock, void *dst, void const *shared, size_t size);
+
+// The raw protocol, for when a blob copy doesn't fit.
+// Anything read between ReadBegin and ReadRetry can be torn, only use it once
+// ReadRetry returns false. Shared fields should be accessed with relaxed atomics.
+//   uint32_t sequence;
+//   do {
+//     sequence = Thread_SeqLockReadBegin(&lock);
+//     ... copy the fields out ...
+//   } while (Thread_SeqLockReadRetry(&lock, sequence));
+AL2O3_EXTERN_C void Thread_SeqLockWriteBegin(Thread_SeqLock *lock);
+AL2O3_EXTERN_C void Thread_SeqLockWriteEnd(Thread_SeqLock *lock);
+AL2O3_EXTERN_C uint32_t Thread_SeqLockReadBegin(Thread_SeqLock const *lock);
+AL2O3_EXTERN_C bool Thread_SeqLockReadRetry(Thread_SeqLock const *lock, uint32_t sequence);
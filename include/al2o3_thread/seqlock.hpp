@@ -0,0 +1,51 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/seqlock.h"
+#include <type_traits>
+
+namespace Thread {
+
+struct SeqLock {
+	SeqLock() { Thread_SeqLockCreate(&handle); }
+	~SeqLock() { Thread_SeqLockDestroy(&handle); }
+
+	SeqLock(SeqLock const &rhs) = delete;
+	SeqLock &operator=(SeqLock const &rhs) = delete;
+
+	void WriteBegin() { Thread_SeqLockWriteBegin(&handle); }
+	void WriteEnd() { Thread_SeqLockWriteEnd(&handle); }
+	uint32_t ReadBegin() const { return Thread_SeqLockReadBegin(&handle); }
+	bool ReadRetry(uint32_t sequence) const { return Thread_SeqLockReadRetry(&handle, sequence); }
+
+	Thread_SeqLock handle;
+};
+
+// a value published by one writer and copied out by any number of readers,
+// copied as raw bytes so T must be trivially copyable
+template<typename T>
+struct SeqLocked {
+	static_assert(std::is_trivially_copyable<T>::value, "SeqLocked values are copied as raw bytes");
+
+	SeqLocked() : value() { Thread_SeqLockCreate(&handle); }
+	explicit SeqLocked(T const &initial) : value(initial) { Thread_SeqLockCreate(&handle); }
+	~SeqLocked() { Thread_SeqLockDestroy(&handle); }
+
+	SeqLocked(SeqLocked const &rhs) = delete;
+	SeqLocked &operator=(SeqLocked const &rhs) = delete;
+
+	void Store(T const &newValue) { Thread_SeqLockWrite(&handle, &value, &newValue, sizeof(T)); }
+	void Load(T &out) const { Thread_SeqLockRead(&handle, &out, &value, sizeof(T)); }
+	T Load() const {
+		T out;
+		Load(out);
+		return out;
+	}
+
+	Thread_SeqLock handle;
+
+private:
+	// only ever touched through the seqlock's relaxed atomic copies
+	alignas(alignof(T) > 8 ? alignof(T) : 8) T value;
+};
+
+}; // end Thread namespace
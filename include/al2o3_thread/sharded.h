@@ -0,0 +1,40 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+
+// Counters and statistic accumulators split into cache line padded per thread
+// slots, so hot updates never share a cache line between cores.
+// A thread whose Thread_GetCurrentThreadIndex is below the shard count owns its
+// slot outright and updates it with plain relaxed loads and stores. Any other
+// thread uses one of shardCount extra shared slots that no thread owns, with a
+// relaxed atomic read-modify-write.
+// Reads walk every slot, so they are slower and see a recent total rather than
+// an instantaneous one. Reset is only exact when no updates are in flight.
+typedef struct Thread_ShardedCounter *Thread_ShardedCounterHandle;
+typedef struct Thread_ShardedMinMax *Thread_ShardedMinMaxHandle;
+typedef struct Thread_ShardedHistogram *Thread_ShardedHistogramHandle;
+
+// shardCount of 0 uses one shard per CPU core
+AL2O3_EXTERN_C Thread_ShardedCounterHandle Thread_ShardedCounterCreate(uint32_t shardCount);
+AL2O3_EXTERN_C void Thread_ShardedCounterDestroy(Thread_ShardedCounterHandle counter);
+AL2O3_EXTERN_C void Thread_ShardedCounterAdd(Thread_ShardedCounterHandle counter, int64_t value);
+AL2O3_EXTERN_C int64_t Thread_ShardedCounterRead(Thread_ShardedCounterHandle counter);
+AL2O3_EXTERN_C void Thread_ShardedCounterReset(Thread_ShardedCounterHandle counter);
+
+AL2O3_EXTERN_C Thread_ShardedMinMaxHandle Thread_ShardedMinMaxCreate(uint32_t shardCount);
+AL2O3_EXTERN_C void Thread_ShardedMinMaxDestroy(Thread_ShardedMinMaxHandle minMax);
+AL2O3_EXTERN_C void Thread_ShardedMinMaxUpdate(Thread_ShardedMinMaxHandle minMax, uint64_t value);
+// returns false if nothing has been recorded since create/reset
+AL2O3_EXTERN_C bool Thread_ShardedMinMaxRead(Thread_ShardedMinMaxHandle minMax, uint64_t *outMin, uint64_t *outMax);
+AL2O3_EXTERN_C void Thread_ShardedMinMaxReset(Thread_ShardedMinMaxHandle minMax);
+
+// log2 histogram, bucket 0 holds 0 and bucket n holds [2^(n-1), 2^n)
+#define Thread_SHARDED_HISTOGRAM_BUCKET_COUNT 65
+AL2O3_EXTERN_C Thread_ShardedHistogramHandle Thread_ShardedHistogramCreate(uint32_t shardCount);
+AL2O3_EXTERN_C void Thread_ShardedHistogramDestroy(Thread_ShardedHistogramHandle histogram);
+AL2O3_EXTERN_C void Thread_ShardedHistogramRecord(Thread_ShardedHistogramHandle histogram, uint64_t value);
+// outBuckets must hold Thread_SHARDED_HISTOGRAM_BUCKET_COUNT entries, outSum may be NULL
+// returns the total number of recorded values
+AL2O3_EXTERN_C uint64_t Thread_ShardedHistogramRead(Thread_ShardedHistogramHandle histogram, uint64_t *outBuckets, uint64_t *outSum);
+AL2O3_EXTERN_C void Thread_ShardedHistogramReset(Thread_ShardedHistogramHandle histogram);
+AL2O3_EXTERN_C uint32_t Thread_ShardedHistogramBucketOf(uint64_t value);
@@ -0,0 +1,56 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+
+// Busy waiting locks for critical sections of a few dozen instructions, where
+// even an uncontended futex mutex costs more than the work it protects.
+// Waiters never sleep, they pause and after a long wait yield their time
+// slice, so only use these where the holder can't block or be descheduled
+// for long. The FIFO locks hand over to the next waiter even if it isn't
+// running, so with more contenders than cores they degrade far worse than
+// Thread_SpinLock. All are zero initialised when unlocked.
+
+// Test and test-and-set with exponential backoff, smallest and fastest
+// uncontended, no fairness.
+typedef struct Thread_SpinLock {
+	Thread_Atomic32_t locked;
+} Thread_SpinLock;
+
+// FIFO, every waiter reads the same word so each release touches every
+// waiter's cache, best with a handful of contenders.
+typedef struct Thread_TicketLock {
+	Thread_Atomic32_t next;
+	Thread_Atomic32_t serving;
+} Thread_TicketLock;
+
+// FIFO queue lock, each waiter spins on its own node so a release only
+// touches the next waiter's cache line, scales to many contenders.
+// The node is supplied by the caller (usually on the stack) and must stay
+// alive and unmoved from Acquire until the matching Release.
+typedef struct Thread_MCSLockNode {
+	Thread_AtomicPtr_t next;
+	Thread_Atomic32_t locked;
+} Thread_CACHE_LINE_ALIGN Thread_MCSLockNode;
+
+typedef struct Thread_MCSLock {
+	Thread_AtomicPtr_t tail;
+} Thread_MCSLock;
+
+AL2O3_EXTERN_C bool Thread_SpinLockCreate(Thread_SpinLock *lock);
+AL2O3_EXTERN_C void Thread_SpinLockDestroy(Thread_SpinLock *lock);
+AL2O3_EXTERN_C void Thread_SpinLockAcquire(Thread_SpinLock *lock);
+AL2O3_EXTERN_C bool Thread_SpinLockTryAcquire(Thread_SpinLock *lock);
+AL2O3_EXTERN_C void Thread_SpinLockRelease(Thread_SpinLock *lock);
+
+AL2O3_EXTERN_C bool Thread_TicketLockCreate(Thread_TicketLock *lock);
+AL2O3_EXTERN_C void Thread_TicketLockDestroy(Thread_TicketLock *lock);
+AL2O3_EXTERN_C void Thread_TicketLockAcquire(Thread_TicketLock *lock);
+// only succeeds if nobody holds or is waiting for the lock
+AL2O3_EXTERN_C bool Thread_TicketLockTryAcquire(Thread_TicketLock *lock);
+AL2O3_EXTERN_C void Thread_TicketLockRelease(Thread_TicketLock *lock);
+
+AL2O3_EXTERN_C bool Thread_MCSLockCreate(Thread_MCSLock *lock);
+AL2O3_EXTERN_C void Thread_MCSLockDestroy(Thread_MCSLock *lock);
+AL2O3_EXTERN_C void Thread_MCSLockAcquire(Thread_MCSLock *lock, Thread_MCSLockNode *node);
+AL2O3_EXTERN_C bool Thread_MCSLockTryAcquire(Thread_MCSLock *lock, Thread_MCSLockNode *node);
+AL2O3_EXTERN_C void Thread_MCSLockRelease(Thread_MCSLock *lock, Thread_MCSLockNode *node);
@@ -0,0 +1,84 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/spinlock.h"
+
+namespace Thread {
+
+struct SpinLock {
+	SpinLock() { Thread_SpinLockCreate(&handle); }
+	~SpinLock() { Thread_SpinLockDestroy(&handle); }
+
+	SpinLock(SpinLock const &rhs) = delete;
+	SpinLock &operator=(SpinLock const &rhs) = delete;
+
+	void Acquire() { Thread_SpinLockAcquire(&handle); }
+	bool TryAcquire() { return Thread_SpinLockTryAcquire(&handle); }
+	void Release() { Thread_SpinLockRelease(&handle); }
+
+	Thread_SpinLock handle;
+};
+
+struct TicketLock {
+	TicketLock() { Thread_TicketLockCreate(&handle); }
+	~TicketLock() { Thread_TicketLockDestroy(&handle); }
+
+	TicketLock(TicketLock const &rhs) = delete;
+	TicketLock &operator=(TicketLock const &rhs) = delete;
+
+	void Acquire() { Thread_TicketLockAcquire(&handle); }
+	bool TryAcquire() { return Thread_TicketLockTryAcquire(&handle); }
+	void Release() { Thread_TicketLockRelease(&handle); }
+
+	Thread_TicketLock handle;
+};
+
+// the queue node lives in the guard, see MCSLockGuard
+struct MCSLock {
+	MCSLock() { Thread_MCSLockCreate(&handle); }
+	~MCSLock() { Thread_MCSLockDestroy(&handle); }
+
+	MCSLock(MCSLock const &rhs) = delete;
+	MCSLock &operator=(MCSLock const &rhs) = delete;
+
+	void Acquire(Thread_MCSLockNode &node) { Thread_MCSLockAcquire(&handle, &node); }
+	bool TryAcquire(Thread_MCSLockNode &node) { return Thread_MCSLockTryAcquire(&handle, &node); }
+	void Release(Thread_MCSLockNode &node) { Thread_MCSLockRelease(&handle, &node); }
+
+	Thread_MCSLock handle;
+};
+
+struct SpinLockGuard {
+	explicit SpinLockGuard(SpinLock &lock) : mLock(&lock.handle) { Thread_SpinLockAcquire(mLock); }
+	explicit SpinLockGuard(Thread_SpinLock *lock) : mLock(lock) { Thread_SpinLockAcquire(mLock); }
+	~SpinLockGuard() { Thread_SpinLockRelease(mLock); }
+
+	SpinLockGuard(SpinLockGuard const &rhs) = delete;
+	SpinLockGuard &operator=(SpinLockGuard const &rhs) = delete;
+
+	Thread_SpinLock *mLock;
+};
+
+struct TicketLockGuard {
+	explicit TicketLockGuard(TicketLock &lock) : mLock(&lock.handle) { Thread_TicketLockAcquire(mLock); }
+	explicit TicketLockGuard(Thread_TicketLock *lock) : mLock(lock) { Thread_TicketLockAcquire(mLock); }
+	~TicketLockGuard() { Thread_TicketLockRelease(mLock); }
+
+	TicketLockGuard(TicketLockGuard const &rhs) = delete;
+	TicketLockGuard &operator=(TicketLockGuard const &rhs) = delete;
+
+	Thread_TicketLock *mLock;
+};
+
+struct MCSLockGuard {
+	explicit MCSLockGuard(MCSLock &lock) : mLock(&lock.handle) { Thread_MCSLockAcquire(mLock, &mNode); }
+	explicit MCSLockGuard(Thread_MCSLock *lock) : mLock(lock) { Thread_MCSLockAcquire(mLock, &mNode); }
+	~MCSLockGuard() { Thread_MCSLockRelease(mLock, &mNode); }
+
+	MCSLockGuard(MCSLockGuard const &rhs) = delete;
+	MCSLockGuard &operator=(MCSLockGuard const &rhs) = delete;
+
+	Thread_MCSLock *mLock;
+	Thread_MCSLockNode mNode;
+};
+
+}; // end Thread namespace
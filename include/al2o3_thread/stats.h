@@ -0,0 +1,27 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+
+// Per thread runtime statistics from the OS, to tell time lost to scheduling
+// (waiting for a core, preemption) apart from time spent in the work itself.
+// Covers every OS thread started by Thread_ThreadCreate that is still alive,
+// pool workers and cached threads included. Pool workers also keep their own
+// busy/idle/stealing split, see Thread_PoolGetWorkerStats.
+// Values are cumulative since the thread started, diff two samples for rates.
+// A sample costs a couple of small /proc reads per thread on linux, cheap
+// enough for a monitoring thread at 1 Hz, not for a hot loop.
+// Windows has no per thread context switch counts, they read 0 there.
+typedef struct Thread_ThreadStats {
+	uint64_t osThreadId;          // kernel tid on linux, thread id elsewhere
+	uint64_t cpuTimeNs;           // user + system
+	uint64_t voluntarySwitches;   // gave up the core, blocked or yielded
+	uint64_t involuntarySwitches; // preempted
+	int32_t cpu;                  // core it is on or last ran on, -1 if unknown
+} Thread_ThreadStats;
+
+// any thread, library created or not. Cheaper than Thread_StatsGetAll
+AL2O3_EXTERN_C void Thread_StatsGetCurrent(Thread_ThreadStats *stats);
+// writes up to maxCount live library threads and returns how many there are
+AL2O3_EXTERN_C uint32_t Thread_StatsGetAll(Thread_ThreadStats *stats, uint32_t maxCount);
+// the id Thread_ThreadStats reports for the calling thread
+AL2O3_EXTERN_C uint64_t Thread_StatsCurrentOSThreadID(void);
@@ -14,7 +14,6 @@ typedef struct { char dummy[8]; } Thread_ConditionalVariable;
 #endif
 
 typedef unsigned int Thread_ThreadID;
-typedef void* Thread_Thread;
 
 #else
 
@@ -25,12 +24,21 @@ typedef pthread_mutex_t Thread_Mutex;
 typedef pthread_cond_t Thread_ConditionalVariable;
 
 typedef pthread_t Thread_ThreadID;
-typedef pthread_t Thread_Thread;
 
 #endif
 
+// one per Thread_ThreadCreate, the OS thread behind it may be a reused one
+typedef struct Thread_ThreadObject *Thread_Thread;
+
 typedef void (*Thread_JobFunction)(void *);
 
+// thread local storage qualifier for plain data
+#if AL2O3_COMPILER == AL2O3_COMPILER_MSVC
+#define Thread_THREAD_LOCAL __declspec(thread)
+#else
+#define Thread_THREAD_LOCAL __thread
+#endif
+
 AL2O3_EXTERN_C bool Thread_MutexCreate(Thread_Mutex *mutex);
 AL2O3_EXTERN_C void Thread_MutexDestroy(Thread_Mutex *mutex);
 AL2O3_EXTERN_C void Thread_MutexAcquire(Thread_Mutex *mutex);
@@ -41,13 +49,38 @@ AL2O3_EXTERN_C void Thread_ConditionalVariableWait(Thread_ConditionalVariable *c
 AL2O3_EXTERN_C void Thread_ConditionalVariableSet(Thread_ConditionalVariable *cd);
 
 AL2O3_EXTERN_C bool Thread_ThreadCreate(Thread_Thread *thread, Thread_JobFunction func, void *data);
+// joins if not already joined and frees the handle
 AL2O3_EXTERN_C void Thread_ThreadDestroy(Thread_Thread *thread);
+// waits for func to return, can be called more than once and from several
+// threads at once. Destroy must wait until every other join has returned
 AL2O3_EXTERN_C void Thread_ThreadJoin(Thread_Thread *thread);
 
+// Opt-in OS thread reuse. With a non zero size, threads started by
+// Thread_ThreadCreate park in a cache of up to maxCachedThreads once their
+// function returns and are handed the next create instead of a new OS thread.
+// Join/Destroy behave the same either way, thread locals however survive from
+// one job to the next on a reused thread. 0 (the default) disables the cache
+// and lets any parked threads exit.
+AL2O3_EXTERN_C void Thread_ThreadCacheSetSize(uint32_t maxCachedThreads);
+// threads currently parked in the cache
+AL2O3_EXTERN_C uint32_t Thread_ThreadCacheCount(void);
+
 AL2O3_EXTERN_C Thread_ThreadID Thread_GetCurrentThreadID(void);
+// small dense index for the calling thread, unique among live threads and
+// reused once a thread exits. Handy for indexing per thread slots.
+// Only the first Thread_MAX_THREAD_INDICES live threads are unique, any
+// beyond that get an index >= Thread_MAX_THREAD_INDICES which may be shared.
+#define Thread_MAX_THREAD_INDICES 1024
+AL2O3_EXTERN_C uint32_t Thread_GetCurrentThreadIndex(void);
 AL2O3_EXTERN_C void Thread_SetMainThread(void);
 AL2O3_EXTERN_C bool Thread_IsMainThread(void);
 
 AL2O3_EXTERN_C void Thread_Sleep(uint64_t waitms);
+// gives the rest of the time slice to another ready thread, if there is one
+AL2O3_EXTERN_C void Thread_Yield(void);
+// monotonic clock for timeouts and budgets, nanoseconds from an arbitrary start
+AL2O3_EXTERN_C uint64_t Thread_MonotonicNs(void);
 // Note in theory this can change at runtime on some platforms
 AL2O3_EXTERN_C uint32_t Thread_CPUCoreCount(void);
+// cores this process may run on (affinity mask), never more than Thread_CPUCoreCount
+AL2O3_EXTERN_C uint32_t Thread_CPUUsableCoreCount(void);
@@ -53,6 +53,7 @@ struct Thread {
   static bool IsMainThread() { return Thread_IsMainThread(); }
   static void Sleep(uint64_t waitms) { Thread_Sleep(waitms); }
   static uint32_t GetNumCPUCores(void) { return Thread_CPUCoreCount(); };
+  static void SetCacheSize(uint32_t maxCachedThreads) { Thread_ThreadCacheSetSize(maxCachedThreads); }
 
 	Thread_Thread handle;
 };
@@ -0,0 +1,36 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+
+// Wait free triple buffer, one producer hands whole buffers to one consumer.
+// Of the three buffers the producer owns one, the consumer owns one and the
+// third is the spare. Publish swaps the producer's buffer with the spare in a
+// single atomic exchange. Update does the same for the consumer, but only if
+// something was published since it last looked, otherwise it doesn't touch
+// shared memory at all. Neither side ever waits for the other.
+// The consumer always gets the newest buffer, publishes it didn't pick up in
+// time are dropped. The write buffer still holds whatever older publish it
+// was last used for, so the producer has to rewrite all of it.
+// Every buffer starts zeroed.
+typedef struct Thread_TripleBuffer {
+	uint8_t *buffers[3];
+	size_t bufferSize;
+	// index of the spare buffer, plus Thread_TRIPLE_BUFFER_FRESH if the consumer hasn't taken it yet
+	Thread_PaddedAtomic32_t spare;
+	Thread_PaddedAtomic32_t back;  // producer only
+	Thread_PaddedAtomic32_t front; // consumer only
+} Thread_TripleBuffer;
+
+#define Thread_TRIPLE_BUFFER_FRESH 0x4
+
+AL2O3_EXTERN_C bool Thread_TripleBufferCreate(Thread_TripleBuffer *tb, size_t bufferSize);
+AL2O3_EXTERN_C void Thread_TripleBufferDestroy(Thread_TripleBuffer *tb);
+
+// producer side, the buffer to fill and then publish
+AL2O3_EXTERN_C void *Thread_TripleBufferWriteBuffer(Thread_TripleBuffer *tb);
+AL2O3_EXTERN_C void Thread_TripleBufferPublish(Thread_TripleBuffer *tb);
+
+// consumer side, Update swaps in the newest publish and returns false if
+// there wasn't one. ReadBuffer stays valid and unchanged until the next Update
+AL2O3_EXTERN_C bool Thread_TripleBufferUpdate(Thread_TripleBuffer *tb);
+AL2O3_EXTERN_C void const *Thread_TripleBufferReadBuffer(Thread_TripleBuffer *tb);
@@ -0,0 +1,35 @@
+#pragma once
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/triplebuffer.h"
+#include <type_traits>
+
+namespace Thread {
+
+// the buffers are zeroed raw memory, so T must be trivially copyable
+template<typename T>
+struct TripleBuffer {
+	static_assert(std::is_trivially_copyable<T>::value, "TripleBuffer buffers are raw zeroed memory");
+	static_assert(alignof(T) <= Thread_CACHE_LINE_SIZE, "TripleBuffer buffers are only cache line aligned");
+
+	TripleBuffer() { Thread_TripleBufferCreate(&handle, sizeof(T)); }
+	~TripleBuffer() { Thread_TripleBufferDestroy(&handle); }
+
+	TripleBuffer(TripleBuffer const &rhs) = delete;
+	TripleBuffer &operator=(TripleBuffer const &rhs) = delete;
+
+	// producer
+	T &Write() { return *(T *) Thread_TripleBufferWriteBuffer(&handle); }
+	void Publish() { Thread_TripleBufferPublish(&handle); }
+	void Publish(T const &value) {
+		Write() = value;
+		Publish();
+	}
+
+	// consumer
+	bool Update() { return Thread_TripleBufferUpdate(&handle); }
+	T const &Read() { return *(T const *) Thread_TripleBufferReadBuffer(&handle); }
+
+	Thread_TripleBuffer handle;
+};
+
+}; // end Thread namespace
@@ -0,0 +1,61 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/mpsc.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/actor.h"
+
+#define ACTOR_DEFAULT_BATCH_SIZE 32
+
+static void ActorActivate(void *data) {
+	Thread_Actor *actor = (Thread_Actor *) data;
+	uint32_t const pending = Thread_AtomicLoad32Explicit(&actor->pending, Thread_ATOMIC_ACQUIRE);
+	uint32_t const batch = pending < actor->batchSize ? pending : actor->batchSize;
+	for (uint32_t i = 0; i < batch; ++i) {
+		Thread_MPSCNode *message;
+		// every counted message was pushed first, a NULL is a push still linking
+		while (!(message = Thread_MPSCQueuePop(&actor->mailbox))) {
+			Thread_AtomicPause();
+		}
+		actor->handler(actor, message);
+	}
+	// whatever is left over (or arrived meanwhile) needs another activation,
+	// requeueing rather than looping lets other actors at the pool
+	if (Thread_AtomicFetchSub32Explicit(&actor->pending, (int32_t) batch, Thread_ATOMIC_ACQ_REL) != batch) {
+		Thread_PoolSubmit(actor->pool, &ActorActivate, actor);
+	}
+}
+
+AL2O3_EXTERN_C bool Thread_ActorCreate(Thread_Actor *actor, Thread_PoolHandle pool, Thread_ActorHandler handler,
+																			 void *userData, uint32_t batchSize) {
+	ASSERT(actor);
+	ASSERT(pool);
+	ASSERT(handler);
+	if (!Thread_MPSCQueueCreate(&actor->mailbox)) {
+		return false;
+	}
+	Thread_AtomicStore32Explicit(&actor->pending, 0, Thread_ATOMIC_RELAXED);
+	actor->batchSize = batchSize ? batchSize : ACTOR_DEFAULT_BATCH_SIZE;
+	actor->handler = handler;
+	actor->pool = pool;
+	actor->userData = userData;
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_ActorDestroy(Thread_Actor *actor) {
+	ASSERT(actor);
+	ASSERT(Thread_AtomicLoad32Explicit(&actor->pending, Thread_ATOMIC_ACQUIRE) == 0);
+	Thread_MPSCQueueDestroy(&actor->mailbox);
+}
+
+AL2O3_EXTERN_C void Thread_ActorSend(Thread_Actor *actor, Thread_MPSCNode *message) {
+	ASSERT(actor);
+	Thread_MPSCQueuePush(&actor->mailbox, message);
+	if (Thread_AtomicFetchAdd32Explicit(&actor->pending, 1, Thread_ATOMIC_ACQ_REL) == 0) {
+		Thread_PoolSubmit(actor->pool, &ActorActivate, actor);
+	}
+}
+
+AL2O3_EXTERN_C uint32_t Thread_ActorPendingCount(Thread_Actor *actor) {
+	ASSERT(actor);
+	return Thread_AtomicLoad32Explicit(&actor->pending, Thread_ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,150 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+#include "al2o3_thread/barrier.h"
+
+// roughly a few microseconds of pause before giving the core away
+#define SPIN_COUNT_BEFORE_PARK 2048
+
+static uint32_t DefaultSpinCount(void) {
+	// spinning on one core just delays whoever we're waiting for
+	return Thread_CPUCoreCount() > 1 ? SPIN_COUNT_BEFORE_PARK : 0;
+}
+
+// sleepers and the word are both seq_cst so either the waker sees the sleeper
+// or the sleeper sees the new value before it parks
+static void WaitWhileEqual(Thread_Atomic32_t *word, uint32_t value, uint32_t spinCount, Thread_Atomic32_t *sleepers) {
+	for (uint32_t i = 0; i < spinCount; ++i) {
+		if (Thread_AtomicLoad32Explicit(word, Thread_ATOMIC_ACQUIRE) != value) {
+			return;
+		}
+		Thread_AtomicPause();
+	}
+	Thread_AtomicFetchAdd32Explicit(sleepers, 1, Thread_ATOMIC_SEQ_CST);
+	while (Thread_AtomicLoad32Explicit(word, Thread_ATOMIC_SEQ_CST) == value) {
+		Thread_FutexWait(word, value, Thread_FUTEX_WAIT_INFINITE);
+	}
+	Thread_AtomicFetchSub32Explicit(sleepers, 1, Thread_ATOMIC_RELAXED);
+}
+
+static void WaitUntilZero(Thread_Atomic32_t *word, uint32_t spinCount, Thread_Atomic32_t *sleepers) {
+	uint32_t value;
+	for (uint32_t i = 0; i < spinCount; ++i) {
+		if (Thread_AtomicLoad32Explicit(word, Thread_ATOMIC_ACQUIRE) == 0) {
+			return;
+		}
+		Thread_AtomicPause();
+	}
+	Thread_AtomicFetchAdd32Explicit(sleepers, 1, Thread_ATOMIC_SEQ_CST);
+	while ((value = Thread_AtomicLoad32Explicit(word, Thread_ATOMIC_SEQ_CST)) != 0) {
+		Thread_FutexWait(word, value, Thread_FUTEX_WAIT_INFINITE);
+	}
+	Thread_AtomicFetchSub32Explicit(sleepers, 1, Thread_ATOMIC_RELAXED);
+}
+
+AL2O3_EXTERN_C bool Thread_BarrierCreate(Thread_Barrier *barrier, uint32_t count) {
+	ASSERT(barrier);
+	ASSERT(count > 0);
+	Thread_AtomicStore32Relaxed(&barrier->arrived, 0);
+	barrier->count = count;
+	barrier->spinCount = DefaultSpinCount();
+	Thread_AtomicStore32Relaxed(&barrier->generation.value, 0);
+	Thread_AtomicStore32Relaxed(&barrier->sleepers.value, 0);
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_BarrierDestroy(Thread_Barrier *barrier) {
+	ASSERT(barrier);
+	ASSERT(Thread_AtomicLoad32Relaxed(&barrier->arrived) == 0);
+}
+
+AL2O3_EXTERN_C bool Thread_BarrierWait(Thread_Barrier *barrier) {
+	ASSERT(barrier);
+	// the generation can't move on until we arrive, so read it first
+	uint32_t const generation = Thread_AtomicLoad32Explicit(&barrier->generation.value, Thread_ATOMIC_ACQUIRE);
+	uint32_t const arrived = Thread_AtomicFetchAdd32Explicit(&barrier->arrived, 1, Thread_ATOMIC_ACQ_REL) + 1;
+	if (arrived == barrier->count) {
+		// reset before publishing the new generation so the next phase starts at 0
+		Thread_AtomicStore32Explicit(&barrier->arrived, 0, Thread_ATOMIC_RELAXED);
+		Thread_AtomicFetchAdd32Explicit(&barrier->generation.value, 1, Thread_ATOMIC_SEQ_CST);
+		if (Thread_AtomicLoad32Explicit(&barrier->sleepers.value, Thread_ATOMIC_SEQ_CST) != 0) {
+			Thread_FutexWakeAll(&barrier->generation.value);
+		}
+		return true;
+	}
+	WaitWhileEqual(&barrier->generation.value, generation, barrier->spinCount, &barrier->sleepers.value);
+	return false;
+}
+
+AL2O3_EXTERN_C bool Thread_LatchCreate(Thread_Latch *latch, uint32_t count) {
+	ASSERT(latch);
+	Thread_AtomicStore32Relaxed(&latch->count.value, count);
+	Thread_AtomicStore32Relaxed(&latch->sleepers, 0);
+	latch->spinCount = DefaultSpinCount();
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_LatchDestroy(Thread_Latch *latch) {
+	ASSERT(latch);
+	ASSERT(Thread_AtomicLoad32Relaxed(&latch->sleepers) == 0);
+}
+
+AL2O3_EXTERN_C void Thread_LatchCountDown(Thread_Latch *latch, uint32_t n) {
+	Thread_CountdownEventSignal(latch, n);
+}
+
+AL2O3_EXTERN_C bool Thread_LatchTryWait(Thread_Latch *latch) {
+	ASSERT(latch);
+	return Thread_AtomicLoad32Explicit(&latch->count.value, Thread_ATOMIC_ACQUIRE) == 0;
+}
+
+AL2O3_EXTERN_C void Thread_LatchWait(Thread_Latch *latch) {
+	ASSERT(latch);
+	WaitUntilZero(&latch->count.value, latch->spinCount, &latch->sleepers);
+}
+
+AL2O3_EXTERN_C void Thread_LatchArriveAndWait(Thread_Latch *latch, uint32_t n) {
+	if (!Thread_CountdownEventSignal(latch, n)) {
+		Thread_LatchWait(latch);
+	}
+}
+
+AL2O3_EXTERN_C bool Thread_CountdownEventCreate(Thread_CountdownEvent *event, uint32_t count) {
+	return Thread_LatchCreate(event, count);
+}
+
+AL2O3_EXTERN_C void Thread_CountdownEventDestroy(Thread_CountdownEvent *event) {
+	Thread_LatchDestroy(event);
+}
+
+AL2O3_EXTERN_C void Thread_CountdownEventAdd(Thread_CountdownEvent *event, uint32_t n) {
+	ASSERT(event);
+	Thread_AtomicFetchAdd32Explicit(&event->count.value, (int32_t) n, Thread_ATOMIC_RELAXED);
+}
+
+AL2O3_EXTERN_C bool Thread_CountdownEventSignal(Thread_CountdownEvent *event, uint32_t n) {
+	ASSERT(event);
+	uint32_t const previous = Thread_AtomicFetchSub32Explicit(&event->count.value, (int32_t) n, Thread_ATOMIC_SEQ_CST);
+	ASSERT(previous >= n);
+	if (previous != n) {
+		return false;
+	}
+	if (Thread_AtomicLoad32Explicit(&event->sleepers, Thread_ATOMIC_SEQ_CST) != 0) {
+		Thread_FutexWakeAll(&event->count.value);
+	}
+	return true;
+}
+
+AL2O3_EXTERN_C bool Thread_CountdownEventIsSet(Thread_CountdownEvent *event) {
+	return Thread_LatchTryWait(event);
+}
+
+AL2O3_EXTERN_C void Thread_CountdownEventWait(Thread_CountdownEvent *event) {
+	Thread_LatchWait(event);
+}
+
+AL2O3_EXTERN_C void Thread_CountdownEventReset(Thread_CountdownEvent *event, uint32_t count) {
+	ASSERT(event);
+	Thread_AtomicStore32Explicit(&event->count.value, count, Thread_ATOMIC_RELEASE);
+}
@@ -0,0 +1,293 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/bitmap.h"
+#include "al2o3_memory/memory.h"
+#include <string.h>
+
+// 64^6 covers every 32 bit index
+#define BITMAP_MAX_LEVELS 6
+// threads share start hints by thread index modulo this
+#define BITMAP_HINT_COUNT 16
+#define BITMAP_FULL (~0ull)
+
+// Level 0 holds the bits themselves, a bit at level n + 1 is set when word
+// n of the level below is full. Bits past the end of a level start set, so
+// full always means all ones.
+// A summary bit is a hint. Marking a word full rechecks the word afterwards
+// and backs out if a release got in between, so a word with a clear bit is
+// never left marked full. The opposite (full but not marked) is harmless, a
+// search that runs into it marks it.
+typedef struct Thread_AtomicBitmap {
+	uint32_t capacity;
+	uint32_t levelCount;
+	uint32_t levelWords[BITMAP_MAX_LEVELS];
+	Thread_Atomic64_t *levels[BITMAP_MAX_LEVELS];
+	// word index at level 0 each thread group searches from first
+	Thread_PaddedAtomic32_t hints[BITMAP_HINT_COUNT];
+	Thread_Atomic64_t *words;
+} Thread_AtomicBitmap;
+
+typedef struct Thread_SlotAllocator {
+	Thread_AtomicBitmapHandle bitmap;
+	Thread_Atomic32_t *generations;
+} Thread_SlotAllocator;
+
+static uint32_t BitmapCtz64(uint64_t value) {
+#if AL2O3_COMPILER == AL2O3_COMPILER_MSVC
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return (uint32_t) index;
+#else
+	return (uint32_t) __builtin_ctzll(value);
+#endif
+}
+
+static uint64_t BitmapLoad(Thread_AtomicBitmap *bitmap, uint32_t level, uint32_t word) {
+	return Thread_AtomicLoad64Explicit(&bitmap->levels[level][word], Thread_ATOMIC_SEQ_CST);
+}
+
+// word of level just went from full to not full
+static void BitmapMarkNotFull(Thread_AtomicBitmap *bitmap, uint32_t level, uint32_t word) {
+	for (; level + 1 < bitmap->levelCount; ++level, word /= 64) {
+		uint64_t const bit = 1ull << (word % 64);
+		uint64_t const old = Thread_AtomicFetchAnd64Explicit(&bitmap->levels[level + 1][word / 64], ~bit, Thread_ATOMIC_SEQ_CST);
+		if (old != BITMAP_FULL) {
+			return;
+		}
+	}
+}
+
+// word of level was seen full
+static void BitmapMarkFull(Thread_AtomicBitmap *bitmap, uint32_t level, uint32_t word) {
+	for (; level + 1 < bitmap->levelCount; ++level, word /= 64) {
+		uint64_t const bit = 1ull << (word % 64);
+		Thread_Atomic64_t *parent = &bitmap->levels[level + 1][word / 64];
+		uint64_t const old = Thread_AtomicFetchOr64Explicit(parent, bit, Thread_ATOMIC_SEQ_CST);
+		// a release that cleared a bit in the word before our mark was visible
+		// found nothing to unmark, so the recheck has to catch it
+		if (BitmapLoad(bitmap, level, word) != BITMAP_FULL) {
+			if (Thread_AtomicFetchAnd64Explicit(parent, ~bit, Thread_ATOMIC_SEQ_CST) == BITMAP_FULL) {
+				// someone saw the parent full while our bit was in and marked further up
+				BitmapMarkNotFull(bitmap, level + 1, word / 64);
+			}
+			return;
+		}
+		if ((old | bit) != BITMAP_FULL) {
+			return;
+		}
+	}
+}
+
+// a level 0 word under word of level, at or right of bit, that isn't marked full.
+// -1 if there's none
+static int64_t BitmapFindBelow(Thread_AtomicBitmap *bitmap, uint32_t level, uint32_t word, uint32_t bit) {
+	if (level == 0) {
+		return BitmapLoad(bitmap, 0, word) != BITMAP_FULL ? (int64_t) word : -1;
+	}
+	uint64_t free = ~BitmapLoad(bitmap, level, word) & (BITMAP_FULL << bit);
+	while (free) {
+		uint32_t const child = word * 64 + BitmapCtz64(free);
+		int64_t const found = BitmapFindBelow(bitmap, level - 1, child, 0);
+		if (found >= 0) {
+			return found;
+		}
+		free &= free - 1;
+	}
+	return -1;
+}
+
+// a level 0 word that isn't marked full, looking right of start first then
+// wrapping to the beginning
+static int64_t BitmapFind(Thread_AtomicBitmap *bitmap, uint32_t start) {
+	// position is a word index of the level below, at level 0 the word itself
+	uint32_t position = start;
+	for (uint32_t level = 0; level < bitmap->levelCount; ++level) {
+		if (position >= bitmap->levelWords[level ? level - 1 : 0]) {
+			break;
+		}
+		// level 0 checks the word itself, above that the rest of the word holding our path
+		int64_t const found = level == 0 ?
+				BitmapFindBelow(bitmap, 0, position, 0) :
+				BitmapFindBelow(bitmap, level, position / 64, position % 64);
+		if (found >= 0) {
+			return found;
+		}
+		position = level == 0 ? position + 1 : position / 64 + 1;
+	}
+	return BitmapFindBelow(bitmap, bitmap->levelCount - 1, 0, 0);
+}
+
+AL2O3_EXTERN_C Thread_AtomicBitmapHandle Thread_AtomicBitmapCreate(uint32_t capacity) {
+	ASSERT(capacity);
+	Thread_AtomicBitmap *bitmap = (Thread_AtomicBitmap *) MEMORY_AALLOC(sizeof(Thread_AtomicBitmap), Thread_CACHE_LINE_SIZE);
+	if (!bitmap) {
+		return NULL;
+	}
+	memset(bitmap, 0, sizeof(Thread_AtomicBitmap));
+	bitmap->capacity = capacity;
+
+	uint64_t items = capacity;
+	uint64_t totalWords = 0;
+	do {
+		uint32_t const words = (uint32_t) ((items + 63) / 64);
+		bitmap->levelWords[bitmap->levelCount++] = words;
+		totalWords += words;
+		items = words;
+	} while (items > 1);
+
+	bitmap->words = (Thread_Atomic64_t *) MEMORY_AALLOC(sizeof(Thread_Atomic64_t) * totalWords, Thread_CACHE_LINE_SIZE);
+	if (!bitmap->words) {
+		MEMORY_FREE(bitmap);
+		return NULL;
+	}
+	memset(bitmap->words, 0, sizeof(Thread_Atomic64_t) * totalWords);
+	Thread_Atomic64_t *words = bitmap->words;
+	items = capacity;
+	for (uint32_t level = 0; level < bitmap->levelCount; ++level) {
+		bitmap->levels[level] = words;
+		uint32_t const wordCount = bitmap->levelWords[level];
+		// past the end reads as taken
+		if (items % 64) {
+			Thread_AtomicStore64Explicit(&words[wordCount - 1], BITMAP_FULL << (items % 64), Thread_ATOMIC_RELAXED);
+		}
+		words += wordCount;
+		items = wordCount;
+	}
+	for (uint32_t i = 0; i < BITMAP_HINT_COUNT; ++i) {
+		uint32_t const start = (uint32_t) ((uint64_t) bitmap->levelWords[0] * i / BITMAP_HINT_COUNT);
+		Thread_AtomicStore32Explicit(&bitmap->hints[i].value, start, Thread_ATOMIC_RELAXED);
+	}
+	return bitmap;
+}
+
+AL2O3_EXTERN_C void Thread_AtomicBitmapDestroy(Thread_AtomicBitmapHandle bitmap) {
+	if (!bitmap) {
+		return;
+	}
+	MEMORY_FREE(bitmap->words);
+	MEMORY_FREE(bitmap);
+}
+
+AL2O3_EXTERN_C bool Thread_AtomicBitmapAcquire(Thread_AtomicBitmapHandle bitmap, uint32_t *outIndex) {
+	ASSERT(bitmap);
+	ASSERT(outIndex);
+	Thread_Atomic32_t *hint = &bitmap->hints[Thread_GetCurrentThreadIndex() % BITMAP_HINT_COUNT].value;
+	uint32_t start = Thread_AtomicLoad32Explicit(hint, Thread_ATOMIC_RELAXED);
+	for (;;) {
+		int64_t const found = BitmapFind(bitmap, start);
+		if (found < 0) {
+			return false;
+		}
+		uint32_t const word = (uint32_t) found;
+		Thread_Atomic64_t *bits = &bitmap->levels[0][word];
+		uint64_t current = Thread_AtomicLoad64Explicit(bits, Thread_ATOMIC_RELAXED);
+		while (current != BITMAP_FULL) {
+			uint64_t const bit = 1ull << BitmapCtz64(~current);
+			if (Thread_AtomicCompareExchangeWeak64Explicit(bits, &current, current | bit,
+																										 Thread_ATOMIC_SEQ_CST, Thread_ATOMIC_RELAXED)) {
+				if ((current | bit) == BITMAP_FULL) {
+					BitmapMarkFull(bitmap, 0, word);
+				}
+				Thread_AtomicStore32Explicit(hint, word, Thread_ATOMIC_RELAXED);
+				*outIndex = word * 64 + BitmapCtz64(bit);
+				return true;
+			}
+		}
+		// full but not marked yet, mark it so nobody else looks here
+		BitmapMarkFull(bitmap, 0, word);
+		start = word;
+	}
+}
+
+AL2O3_EXTERN_C void Thread_AtomicBitmapRelease(Thread_AtomicBitmapHandle bitmap, uint32_t index) {
+	ASSERT(bitmap);
+	ASSERT(index < bitmap->capacity);
+	uint64_t const bit = 1ull << (index % 64);
+	uint64_t const old = Thread_AtomicFetchAnd64Explicit(&bitmap->levels[0][index / 64], ~bit, Thread_ATOMIC_SEQ_CST);
+	ASSERT(old & bit);
+	if (old == BITMAP_FULL) {
+		BitmapMarkNotFull(bitmap, 0, index / 64);
+	}
+}
+
+AL2O3_EXTERN_C bool Thread_AtomicBitmapIsSet(Thread_AtomicBitmapHandle bitmap, uint32_t index) {
+	ASSERT(bitmap);
+	ASSERT(index < bitmap->capacity);
+	return (Thread_AtomicLoad64Explicit(&bitmap->levels[0][index / 64], Thread_ATOMIC_ACQUIRE) >> (index % 64)) & 1;
+}
+
+AL2O3_EXTERN_C uint32_t Thread_AtomicBitmapCapacity(Thread_AtomicBitmapHandle bitmap) {
+	ASSERT(bitmap);
+	return bitmap->capacity;
+}
+
+AL2O3_EXTERN_C Thread_SlotAllocatorHandle Thread_SlotAllocatorCreate(uint32_t capacity) {
+	Thread_SlotAllocator *allocator = (Thread_SlotAllocator *) MEMORY_CALLOC(1, sizeof(Thread_SlotAllocator));
+	if (!allocator) {
+		return NULL;
+	}
+	allocator->bitmap = Thread_AtomicBitmapCreate(capacity);
+	allocator->generations = (Thread_Atomic32_t *) MEMORY_MALLOC(sizeof(Thread_Atomic32_t) * capacity);
+	if (!allocator->bitmap || !allocator->generations) {
+		Thread_SlotAllocatorDestroy(allocator);
+		return NULL;
+	}
+	// generations start at 1 so no handle is ever 0
+	for (uint32_t i = 0; i < capacity; ++i) {
+		Thread_AtomicStore32Explicit(&allocator->generations[i], 1, Thread_ATOMIC_RELAXED);
+	}
+	return allocator;
+}
+
+AL2O3_EXTERN_C void Thread_SlotAllocatorDestroy(Thread_SlotAllocatorHandle allocator) {
+	if (!allocator) {
+		return;
+	}
+	Thread_AtomicBitmapDestroy(allocator->bitmap);
+	MEMORY_FREE(allocator->generations);
+	MEMORY_FREE(allocator);
+}
+
+AL2O3_EXTERN_C bool Thread_SlotAllocatorAcquire(Thread_SlotAllocatorHandle allocator, Thread_SlotHandle *outHandle) {
+	ASSERT(allocator);
+	ASSERT(outHandle);
+	uint32_t index;
+	if (!Thread_AtomicBitmapAcquire(allocator->bitmap, &index)) {
+		return false;
+	}
+	// the bitmap CAS acquired the generation bump of whoever released the slot
+	uint32_t const generation = Thread_AtomicLoad32Explicit(&allocator->generations[index], Thread_ATOMIC_RELAXED);
+	*outHandle = ((uint64_t) generation << 32) | index;
+	return true;
+}
+
+AL2O3_EXTERN_C bool Thread_SlotAllocatorRelease(Thread_SlotAllocatorHandle allocator, Thread_SlotHandle handle) {
+	ASSERT(allocator);
+	uint32_t const index = Thread_SlotHandleIndex(handle);
+	uint32_t expected = Thread_SlotHandleGeneration(handle);
+	if (index >= allocator->bitmap->capacity || expected == 0) {
+		return false;
+	}
+	// only one release of a handle can win, wrapping skips 0
+	uint32_t const next = expected + 1 ? expected + 1 : 1;
+	if (!Thread_AtomicCompareExchangeStrong32Explicit(&allocator->generations[index], &expected, next,
+																										Thread_ATOMIC_RELAXED, Thread_ATOMIC_RELAXED)) {
+		return false;
+	}
+	Thread_AtomicBitmapRelease(allocator->bitmap, index);
+	return true;
+}
+
+AL2O3_EXTERN_C bool Thread_SlotAllocatorIsValid(Thread_SlotAllocatorHandle allocator, Thread_SlotHandle handle) {
+	ASSERT(allocator);
+	uint32_t const index = Thread_SlotHandleIndex(handle);
+	return index < allocator->bitmap->capacity && Thread_SlotHandleGeneration(handle) != 0 &&
+			Thread_AtomicLoad32Explicit(&allocator->generations[index], Thread_ATOMIC_ACQUIRE) ==
+					Thread_SlotHandleGeneration(handle);
+}
+
+AL2O3_EXTERN_C uint32_t Thread_SlotAllocatorCapacity(Thread_SlotAllocatorHandle allocator) {
+	ASSERT(allocator);
+	return allocator->bitmap->capacity;
+}
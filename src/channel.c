@@ -0,0 +1,413 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+#include "al2o3_thread/channel.h"
+#include "al2o3_memory/memory.h"
+#include <string.h>
+
+// the channel lock only covers a few pointer moves and a memcpy
+#define CHANNEL_LOCK_SPIN_COUNT 128
+#define CHANNEL_PARK_SPIN_COUNT 1024
+
+// a blocked select moves WAITING -> CLAIMED -> DONE, the claim is taken by
+// whoever completes one of its cases, or WAITING -> CANCELLED by its timeout
+#define SELECT_WAITING 0
+#define SELECT_CLAIMED 1
+#define SELECT_DONE 2
+#define SELECT_CANCELLED 3
+
+// lives on the blocked thread's stack
+typedef struct ChannelSelect {
+	Thread_Atomic32_t state;
+	int32_t fired;
+	bool ok;
+} ChannelSelect;
+
+// one per case of a blocked select, linked into its channel's wait queue
+typedef struct ChannelWaiter {
+	struct ChannelWaiter *next;
+	struct ChannelWaiter *prev;
+	ChannelSelect *select;
+	void *value;
+	int32_t caseIndex;
+	bool queued;
+} ChannelWaiter;
+
+typedef struct ChannelWaitQueue {
+	ChannelWaiter *first;
+	ChannelWaiter *last;
+} ChannelWaitQueue;
+
+typedef struct Thread_Channel {
+	// 0 free, 1 locked, 2 locked with sleepers
+	Thread_Atomic32_t lock;
+	uint32_t spinCount;
+	uint32_t elementSize;
+	uint32_t capacity;
+	uint32_t head;
+	uint32_t count;
+	bool closed;
+	ChannelWaitQueue senders;
+	ChannelWaitQueue receivers;
+	uint8_t *ring;
+} Thread_Channel;
+
+static Thread_THREAD_LOCAL uint32_t s_selectSeed;
+
+static void ChannelLock(Thread_Channel *channel) {
+	uint32_t expected = 0;
+	if (Thread_AtomicCompareExchangeStrong32Explicit(&channel->lock, &expected, 1, Thread_ATOMIC_ACQUIRE,
+																									 Thread_ATOMIC_RELAXED)) {
+		return;
+	}
+	for (uint32_t i = 0; i < channel->spinCount; ++i) {
+		expected = 0;
+		if (Thread_AtomicLoad32Explicit(&channel->lock, Thread_ATOMIC_RELAXED) == 0 &&
+				Thread_AtomicCompareExchangeStrong32Explicit(&channel->lock, &expected, 1, Thread_ATOMIC_ACQUIRE,
+																										 Thread_ATOMIC_RELAXED)) {
+			return;
+		}
+		Thread_AtomicPause();
+	}
+	// taking it as 2 is pessimistic, the unlocker may do a wake nobody needs
+	while (Thread_AtomicExchange32Explicit(&channel->lock, 2, Thread_ATOMIC_ACQUIRE) != 0) {
+		Thread_FutexWait(&channel->lock, 2, Thread_FUTEX_WAIT_INFINITE);
+	}
+}
+
+static void ChannelUnlock(Thread_Channel *channel) {
+	if (Thread_AtomicExchange32Explicit(&channel->lock, 0, Thread_ATOMIC_RELEASE) == 2) {
+		Thread_FutexWakeOne(&channel->lock);
+	}
+}
+
+static void ChannelEnqueue(ChannelWaitQueue *queue, ChannelWaiter *waiter) {
+	waiter->next = NULL;
+	waiter->prev = queue->last;
+	if (queue->last) {
+		queue->last->next = waiter;
+	} else {
+		queue->first = waiter;
+	}
+	queue->last = waiter;
+	waiter->queued = true;
+}
+
+static void ChannelUnlink(ChannelWaitQueue *queue, ChannelWaiter *waiter) {
+	if (waiter->prev) {
+		waiter->prev->next = waiter->next;
+	} else {
+		queue->first = waiter->next;
+	}
+	if (waiter->next) {
+		waiter->next->prev = waiter->prev;
+	} else {
+		queue->last = waiter->prev;
+	}
+	waiter->queued = false;
+}
+
+// takes the first waiter whose select hasn't already been completed elsewhere,
+// stale ones are just dropped, their owner skips them when it cleans up
+static ChannelWaiter *ChannelClaimWaiter(ChannelWaitQueue *queue) {
+	ChannelWaiter *waiter;
+	while ((waiter = queue->first)) {
+		ChannelUnlink(queue, waiter);
+		uint32_t expected = SELECT_WAITING;
+		if (Thread_AtomicCompareExchangeStrong32Explicit(&waiter->select->state, &expected, SELECT_CLAIMED,
+																										 Thread_ATOMIC_ACQ_REL, Thread_ATOMIC_ACQUIRE)) {
+			return waiter;
+		}
+	}
+	return NULL;
+}
+
+// called with the channel locked, the woken select locks every one of its
+// channels before returning so the waiter is still alive for the wake
+static void ChannelCompleteWaiter(ChannelWaiter *waiter, bool ok) {
+	ChannelSelect *select = waiter->select;
+	select->fired = waiter->caseIndex;
+	select->ok = ok;
+	Thread_AtomicStore32Explicit(&select->state, SELECT_DONE, Thread_ATOMIC_RELEASE);
+	Thread_FutexWakeOne(&select->state);
+}
+
+static void ChannelCopy(Thread_Channel *channel, void *dst, void const *src) {
+	if (dst && channel->elementSize) {
+		memcpy(dst, src, channel->elementSize);
+	}
+}
+
+static uint8_t *ChannelSlot(Thread_Channel *channel, uint32_t index) {
+	return channel->ring + (size_t) (index % channel->capacity) * channel->elementSize;
+}
+
+// with the channel locked, completes the case if it can go right now
+static bool ChannelTryCase(Thread_ChannelCase *c) {
+	Thread_Channel *channel = c->channel;
+	ChannelWaiter *waiter;
+
+	if (c->op == Thread_CHANNEL_SEND) {
+		ASSERT(c->value || channel->elementSize == 0);
+		if (channel->closed) {
+			c->ok = false;
+			return true;
+		}
+		// a waiting receiver means the ring is empty, hand it over directly
+		if ((waiter = ChannelClaimWaiter(&channel->receivers))) {
+			ChannelCopy(channel, waiter->value, c->value);
+			ChannelCompleteWaiter(waiter, true);
+			c->ok = true;
+			return true;
+		}
+		if (channel->count < channel->capacity) {
+			ChannelCopy(channel, ChannelSlot(channel, channel->head + channel->count), c->value);
+			channel->count++;
+			c->ok = true;
+			return true;
+		}
+		return false;
+	}
+
+	if (channel->count > 0) {
+		ChannelCopy(channel, c->value, ChannelSlot(channel, channel->head));
+		channel->head = (channel->head + 1) % channel->capacity;
+		channel->count--;
+		// a waiting sender means the ring was full, its value takes the free slot
+		if ((waiter = ChannelClaimWaiter(&channel->senders))) {
+			ChannelCopy(channel, ChannelSlot(channel, channel->head + channel->count), waiter->value);
+			channel->count++;
+			ChannelCompleteWaiter(waiter, true);
+		}
+		c->ok = true;
+		return true;
+	}
+	if ((waiter = ChannelClaimWaiter(&channel->senders))) {
+		ChannelCopy(channel, c->value, waiter->value);
+		ChannelCompleteWaiter(waiter, true);
+		c->ok = true;
+		return true;
+	}
+	if (channel->closed) {
+		if (c->value) {
+			memset(c->value, 0, channel->elementSize);
+		}
+		c->ok = false;
+		return true;
+	}
+	return false;
+}
+
+// distinct channels sorted by address, the order every select locks them in
+static uint32_t ChannelLockOrder(Thread_ChannelCase const *cases, uint32_t count, Thread_Channel **order) {
+	uint32_t n = 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		Thread_Channel *channel = cases[i].channel;
+		if (!channel) {
+			continue;
+		}
+		uint32_t j = n;
+		while (j > 0 && order[j - 1] > channel) {
+			j--;
+		}
+		if (j > 0 && order[j - 1] == channel) {
+			continue;
+		}
+		memmove(order + j + 1, order + j, (n - j) * sizeof(Thread_Channel *));
+		order[j] = channel;
+		n++;
+	}
+	return n;
+}
+
+static void ChannelLockAll(Thread_Channel **order, uint32_t n) {
+	for (uint32_t i = 0; i < n; ++i) {
+		ChannelLock(order[i]);
+	}
+}
+
+static void ChannelUnlockAll(Thread_Channel **order, uint32_t n) {
+	for (uint32_t i = n; i > 0; --i) {
+		ChannelUnlock(order[i - 1]);
+	}
+}
+
+// returns the final state, DONE or CANCELLED
+static uint32_t ChannelPark(ChannelSelect *select, uint32_t spinCount, uint64_t timeoutNs) {
+	uint32_t state;
+	for (uint32_t i = 0; i < spinCount; ++i) {
+		state = Thread_AtomicLoad32Explicit(&select->state, Thread_ATOMIC_ACQUIRE);
+		if (state == SELECT_DONE) {
+			return state;
+		}
+		Thread_AtomicPause();
+	}
+	uint64_t const deadline = timeoutNs == Thread_FUTEX_WAIT_INFINITE ? 0 : Thread_MonotonicNs() + timeoutNs;
+	while ((state = Thread_AtomicLoad32Explicit(&select->state, Thread_ATOMIC_ACQUIRE)) != SELECT_DONE) {
+		// once claimed the completer is only a memcpy away
+		if (state == SELECT_CLAIMED || timeoutNs == Thread_FUTEX_WAIT_INFINITE) {
+			Thread_FutexWait(&select->state, state, Thread_FUTEX_WAIT_INFINITE);
+			continue;
+		}
+		uint64_t const now = Thread_MonotonicNs();
+		if (now >= deadline) {
+			uint32_t expected = SELECT_WAITING;
+			if (Thread_AtomicCompareExchangeStrong32Explicit(&select->state, &expected, SELECT_CANCELLED,
+																											 Thread_ATOMIC_ACQ_REL, Thread_ATOMIC_ACQUIRE)) {
+				return SELECT_CANCELLED;
+			}
+			continue;
+		}
+		Thread_FutexWait(&select->state, SELECT_WAITING, deadline - now);
+	}
+	return state;
+}
+
+AL2O3_EXTERN_C Thread_ChannelHandle Thread_ChannelCreate(uint32_t elementSize, uint32_t capacity) {
+	Thread_Channel *channel = (Thread_Channel *) MEMORY_CALLOC(1, sizeof(Thread_Channel) + (size_t) elementSize * capacity);
+	if (!channel) {
+		return NULL;
+	}
+	Thread_AtomicStore32Explicit(&channel->lock, 0, Thread_ATOMIC_RELAXED);
+	// spinning on one core just delays whoever we're waiting for
+	channel->spinCount = Thread_CPUCoreCount() > 1 ? CHANNEL_LOCK_SPIN_COUNT : 0;
+	channel->elementSize = elementSize;
+	channel->capacity = capacity;
+	channel->ring = (uint8_t *) (channel + 1);
+	return channel;
+}
+
+AL2O3_EXTERN_C void Thread_ChannelDestroy(Thread_ChannelHandle channel) {
+	if (!channel) {
+		return;
+	}
+	ASSERT(channel->senders.first == NULL);
+	ASSERT(channel->receivers.first == NULL);
+	MEMORY_FREE(channel);
+}
+
+AL2O3_EXTERN_C void Thread_ChannelClose(Thread_ChannelHandle channel) {
+	ASSERT(channel);
+	ChannelLock(channel);
+	ASSERT(!channel->closed);
+	channel->closed = true;
+	ChannelWaiter *waiter;
+	while ((waiter = ChannelClaimWaiter(&channel->receivers))) {
+		if (waiter->value) {
+			memset(waiter->value, 0, channel->elementSize);
+		}
+		ChannelCompleteWaiter(waiter, false);
+	}
+	while ((waiter = ChannelClaimWaiter(&channel->senders))) {
+		ChannelCompleteWaiter(waiter, false);
+	}
+	ChannelUnlock(channel);
+}
+
+AL2O3_EXTERN_C bool Thread_ChannelSend(Thread_ChannelHandle channel, void const *value) {
+	Thread_ChannelCase c = {channel, Thread_CHANNEL_SEND, (void *) value, false};
+	Thread_ChannelSelect(&c, 1, Thread_FUTEX_WAIT_INFINITE);
+	return c.ok;
+}
+
+AL2O3_EXTERN_C bool Thread_ChannelRecv(Thread_ChannelHandle channel, void *value) {
+	Thread_ChannelCase c = {channel, Thread_CHANNEL_RECV, value, false};
+	Thread_ChannelSelect(&c, 1, Thread_FUTEX_WAIT_INFINITE);
+	return c.ok;
+}
+
+AL2O3_EXTERN_C bool Thread_ChannelTrySend(Thread_ChannelHandle channel, void const *value) {
+	Thread_ChannelCase c = {channel, Thread_CHANNEL_SEND, (void *) value, false};
+	return Thread_ChannelSelect(&c, 1, 0) == 0 && c.ok;
+}
+
+AL2O3_EXTERN_C bool Thread_ChannelTryRecv(Thread_ChannelHandle channel, void *value) {
+	Thread_ChannelCase c = {channel, Thread_CHANNEL_RECV, value, false};
+	return Thread_ChannelSelect(&c, 1, 0) == 0 && c.ok;
+}
+
+AL2O3_EXTERN_C uint32_t Thread_ChannelCount(Thread_ChannelHandle channel) {
+	ASSERT(channel);
+	ChannelLock(channel);
+	uint32_t const count = channel->count;
+	ChannelUnlock(channel);
+	return count;
+}
+
+AL2O3_EXTERN_C bool Thread_ChannelIsClosed(Thread_ChannelHandle channel) {
+	ASSERT(channel);
+	ChannelLock(channel);
+	bool const closed = channel->closed;
+	ChannelUnlock(channel);
+	return closed;
+}
+
+AL2O3_EXTERN_C int32_t Thread_ChannelSelect(Thread_ChannelCase *cases, uint32_t count, uint64_t timeoutNs) {
+	ASSERT(cases || count == 0);
+	ASSERT(count <= Thread_CHANNEL_MAX_SELECT_CASES);
+	Thread_Channel *order[Thread_CHANNEL_MAX_SELECT_CASES];
+	uint32_t const channelCount = ChannelLockOrder(cases, count, order);
+
+	// start somewhere different each time so one busy case can't starve the rest
+	uint32_t start = 0;
+	if (count > 1) {
+		uint32_t seed = s_selectSeed ? s_selectSeed : (uint32_t) (uintptr_t) &s_selectSeed | 1;
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		s_selectSeed = seed;
+		start = seed % count;
+	}
+
+	ChannelLockAll(order, channelCount);
+	for (uint32_t k = 0; k < count; ++k) {
+		uint32_t const i = (start + k) % count;
+		if (cases[i].channel && ChannelTryCase(&cases[i])) {
+			ChannelUnlockAll(order, channelCount);
+			return (int32_t) i;
+		}
+	}
+	// nothing ready, a select with only NULL channels can only time out
+	if (timeoutNs == 0 || (channelCount == 0 && timeoutNs == Thread_FUTEX_WAIT_INFINITE)) {
+		ChannelUnlockAll(order, channelCount);
+		ASSERT(timeoutNs == 0);
+		return -1;
+	}
+
+	ChannelSelect select;
+	Thread_AtomicStore32Explicit(&select.state, SELECT_WAITING, Thread_ATOMIC_RELAXED);
+	select.fired = -1;
+	select.ok = false;
+	ChannelWaiter waiters[Thread_CHANNEL_MAX_SELECT_CASES];
+	for (uint32_t i = 0; i < count; ++i) {
+		Thread_Channel *channel = cases[i].channel;
+		waiters[i].select = &select;
+		waiters[i].value = cases[i].value;
+		waiters[i].caseIndex = (int32_t) i;
+		waiters[i].queued = false;
+		if (channel) {
+			ChannelEnqueue(cases[i].op == Thread_CHANNEL_SEND ? &channel->senders : &channel->receivers, &waiters[i]);
+		}
+	}
+	uint32_t const spinCount = channelCount && order[0]->spinCount ? CHANNEL_PARK_SPIN_COUNT : 0;
+	ChannelUnlockAll(order, channelCount);
+
+	uint32_t const state = ChannelPark(&select, spinCount, timeoutNs);
+
+	// take back the waiters nobody used, this also waits out the completer
+	ChannelLockAll(order, channelCount);
+	for (uint32_t i = 0; i < count; ++i) {
+		if (waiters[i].queued) {
+			Thread_Channel *channel = cases[i].channel;
+			ChannelUnlink(cases[i].op == Thread_CHANNEL_SEND ? &channel->senders : &channel->receivers, &waiters[i]);
+		}
+	}
+	ChannelUnlockAll(order, channelCount);
+
+	if (state == SELECT_CANCELLED) {
+		return -1;
+	}
+	cases[select.fired].ok = select.ok;
+	return select.fired;
+}
@@ -0,0 +1,368 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+#include "al2o3_thread/disruptor.h"
+#include "al2o3_memory/memory.h"
+#include <string.h>
+
+#define DISRUPTOR_DEFAULT_CAPACITY 1024
+// wait rounds spent pausing before yielding or parking
+#define DISRUPTOR_SPIN_ROUNDS 256
+// spinning checks the clock this often
+#define DISRUPTOR_SPIN_TIMEOUT_CHECK 64
+
+typedef struct DisruptorConsumer {
+	// everything below has been released by this consumer
+	Thread_PaddedAtomic64_t cursor;
+	uint32_t dependsOn[Thread_DISRUPTOR_MAX_CONSUMERS];
+	uint32_t dependsOnCount;
+	// nobody depends on it, so producers wait on it directly
+	bool gating;
+	// consumer thread only, known available bound from the last look
+	uint64_t available;
+} Thread_CACHE_LINE_ALIGN DisruptorConsumer;
+
+typedef struct Thread_Disruptor {
+	uint8_t *entries;
+	// multiple producers only, the sequence last published into each slot
+	Thread_Atomic64_t *published;
+	uint64_t mask;
+	uint32_t stride;
+	uint32_t consumerCount;
+	bool singleProducer;
+	Thread_DisruptorWait wait;
+	// next sequence to claim, only the producer touches it with a single producer
+	Thread_PaddedAtomic64_t claimed;
+	// single producer only, everything below is published
+	Thread_PaddedAtomic64_t cursor;
+	// lowest gating consumer cursor seen, may be stale but never too high
+	Thread_PaddedAtomic64_t gate;
+	// park strategy, bumped to wake everyone sleeping on it
+	Thread_PaddedAtomic32_t epoch;
+	Thread_PaddedAtomic32_t sleepers;
+	DisruptorConsumer *consumers;
+} Thread_Disruptor;
+
+typedef struct DisruptorWaiter {
+	uint64_t timeoutNs;
+	uint64_t deadlineNs; // set on first use
+	uint32_t rounds;
+	uint32_t epoch;
+	bool sleeping; // counted in sleepers
+} DisruptorWaiter;
+
+static void DisruptorWaiterInit(DisruptorWaiter *waiter, uint64_t timeoutNs) {
+	memset(waiter, 0, sizeof(DisruptorWaiter));
+	waiter->timeoutNs = timeoutNs;
+}
+
+static bool DisruptorWaiterExpired(DisruptorWaiter *waiter) {
+	if (waiter->timeoutNs == Thread_FUTEX_WAIT_INFINITE) {
+		return false;
+	}
+	uint64_t const now = Thread_MonotonicNs();
+	if (waiter->deadlineNs == 0) {
+		waiter->deadlineNs = now + waiter->timeoutNs;
+	}
+	return now >= waiter->deadlineNs;
+}
+
+// one round of waiting for something the caller checks again afterwards,
+// false once the timeout has passed
+static bool DisruptorWaiterStep(Thread_Disruptor *disruptor, DisruptorWaiter *waiter) {
+	if (waiter->timeoutNs == 0) {
+		return false;
+	}
+	uint32_t const round = waiter->rounds++;
+	if (disruptor->wait == Thread_DISRUPTOR_WAIT_SPIN || round < DISRUPTOR_SPIN_ROUNDS) {
+		Thread_AtomicPause();
+		return (round % DISRUPTOR_SPIN_TIMEOUT_CHECK) != 0 || !DisruptorWaiterExpired(waiter);
+	}
+	if (DisruptorWaiterExpired(waiter)) {
+		return false;
+	}
+	if (disruptor->wait == Thread_DISRUPTOR_WAIT_YIELD) {
+		Thread_Yield();
+		return true;
+	}
+
+	if (!waiter->sleeping) {
+		// announce ourselves then have the caller look once more before the first
+		// sleep, a notify either sees the sleeper or its change is seen here
+		waiter->sleeping = true;
+		Thread_AtomicFetchAdd32Explicit(&disruptor->sleepers.value, 1, Thread_ATOMIC_SEQ_CST);
+		waiter->epoch = Thread_AtomicLoad32Explicit(&disruptor->epoch.value, Thread_ATOMIC_SEQ_CST);
+		return true;
+	}
+	uint64_t remainingNs = Thread_FUTEX_WAIT_INFINITE;
+	if (waiter->timeoutNs != Thread_FUTEX_WAIT_INFINITE) {
+		uint64_t const now = Thread_MonotonicNs();
+		remainingNs = waiter->deadlineNs > now ? waiter->deadlineNs - now : 0;
+	}
+	Thread_FutexWait(&disruptor->epoch.value, waiter->epoch, remainingNs);
+	waiter->epoch = Thread_AtomicLoad32Explicit(&disruptor->epoch.value, Thread_ATOMIC_SEQ_CST);
+	return true;
+}
+
+static void DisruptorWaiterDone(Thread_Disruptor *disruptor, DisruptorWaiter *waiter) {
+	if (waiter->sleeping) {
+		Thread_AtomicFetchSub32Explicit(&disruptor->sleepers.value, 1, Thread_ATOMIC_RELAXED);
+	}
+}
+
+// after any cursor or publish store that a sleeper may be waiting on
+static void DisruptorNotify(Thread_Disruptor *disruptor) {
+	if (disruptor->wait != Thread_DISRUPTOR_WAIT_PARK) {
+		return;
+	}
+	Thread_AtomicThreadFenceExplicit(Thread_ATOMIC_SEQ_CST);
+	if (Thread_AtomicLoad32Explicit(&disruptor->sleepers.value, Thread_ATOMIC_RELAXED)) {
+		Thread_AtomicFetchAdd32Explicit(&disruptor->epoch.value, 1, Thread_ATOMIC_SEQ_CST);
+		Thread_FutexWakeAll(&disruptor->epoch.value);
+	}
+}
+
+static uint64_t DisruptorGate(Thread_Disruptor *disruptor) {
+	uint64_t gate = UINT64_MAX;
+	for (uint32_t i = 0; i < disruptor->consumerCount; ++i) {
+		DisruptorConsumer *consumer = &disruptor->consumers[i];
+		if (consumer->gating) {
+			uint64_t const cursor = Thread_AtomicLoad64Explicit(&consumer->cursor.value, Thread_ATOMIC_ACQUIRE);
+			gate = cursor < gate ? cursor : gate;
+		}
+	}
+	// release passes on what the cursor loads acquired, another producer may
+	// reuse slots on the strength of this cached value alone
+	Thread_AtomicStore64Explicit(&disruptor->gate.value, gate, Thread_ATOMIC_RELEASE);
+	return gate;
+}
+
+// true if [first, end) doesn't overwrite anything a consumer still needs
+static bool DisruptorHasRoom(Thread_Disruptor *disruptor, uint64_t end) {
+	uint64_t const capacity = disruptor->mask + 1;
+	if (end <= capacity) {
+		return true;
+	}
+	// the cached gate first, only rescan the consumers when it's not enough
+	return end - capacity <= Thread_AtomicLoad64Explicit(&disruptor->gate.value, Thread_ATOMIC_ACQUIRE) ||
+			end - capacity <= DisruptorGate(disruptor);
+}
+
+static void DisruptorWaitForRoom(Thread_Disruptor *disruptor, uint64_t end) {
+	if (DisruptorHasRoom(disruptor, end)) {
+		return;
+	}
+	DisruptorWaiter waiter;
+	DisruptorWaiterInit(&waiter, Thread_FUTEX_WAIT_INFINITE);
+	while (!DisruptorHasRoom(disruptor, end)) {
+		DisruptorWaiterStep(disruptor, &waiter);
+	}
+	DisruptorWaiterDone(disruptor, &waiter);
+}
+
+// one past the highest sequence the consumer may read, from is known to be
+// readable up to and scanning stops at limit
+static uint64_t DisruptorAvailable(Thread_Disruptor *disruptor, DisruptorConsumer *consumer, uint64_t from, uint64_t limit) {
+	if (consumer->dependsOnCount) {
+		// dependencies only ever pass published entries
+		uint64_t available = UINT64_MAX;
+		for (uint32_t i = 0; i < consumer->dependsOnCount; ++i) {
+			DisruptorConsumer *dependency = &disruptor->consumers[consumer->dependsOn[i]];
+			uint64_t const cursor = Thread_AtomicLoad64Explicit(&dependency->cursor.value, Thread_ATOMIC_ACQUIRE);
+			available = cursor < available ? cursor : available;
+		}
+		return available;
+	}
+	if (disruptor->singleProducer) {
+		return Thread_AtomicLoad64Explicit(&disruptor->cursor.value, Thread_ATOMIC_ACQUIRE);
+	}
+	// producers publish out of order, stop at the first hole
+	uint64_t const claimed = Thread_AtomicLoad64Explicit(&disruptor->claimed.value, Thread_ATOMIC_RELAXED);
+	uint64_t const end = claimed < limit ? claimed : limit;
+	uint64_t available = from;
+	while (available < end &&
+			Thread_AtomicLoad64Explicit(&disruptor->published[available & disruptor->mask], Thread_ATOMIC_ACQUIRE) == available) {
+		available++;
+	}
+	return available;
+}
+
+AL2O3_EXTERN_C Thread_DisruptorHandle Thread_DisruptorCreate(Thread_DisruptorDesc const *desc) {
+	ASSERT(desc);
+	ASSERT(desc->entrySize);
+	uint64_t capacity = 2;
+	while (capacity < (desc->capacity ? desc->capacity : DISRUPTOR_DEFAULT_CAPACITY)) {
+		capacity <<= 1;
+	}
+
+	Thread_Disruptor *disruptor = (Thread_Disruptor *) MEMORY_AALLOC(sizeof(Thread_Disruptor), Thread_CACHE_LINE_SIZE);
+	if (!disruptor) {
+		return NULL;
+	}
+	memset(disruptor, 0, sizeof(Thread_Disruptor));
+	disruptor->mask = capacity - 1;
+	// 8 byte aligned entries, any bigger alignment is up to the entry size
+	disruptor->stride = (desc->entrySize + 7) & ~7u;
+	disruptor->singleProducer = desc->singleProducer;
+	disruptor->wait = desc->wait;
+	disruptor->entries = (uint8_t *) MEMORY_AALLOC(capacity * disruptor->stride, Thread_CACHE_LINE_SIZE);
+	disruptor->consumers = (DisruptorConsumer *) MEMORY_AALLOC(sizeof(DisruptorConsumer) * Thread_DISRUPTOR_MAX_CONSUMERS,
+																														 Thread_CACHE_LINE_SIZE);
+	if (!desc->singleProducer) {
+		disruptor->published = (Thread_Atomic64_t *) MEMORY_AALLOC(sizeof(Thread_Atomic64_t) * capacity, Thread_CACHE_LINE_SIZE);
+	}
+	if (!disruptor->entries || !disruptor->consumers || (!desc->singleProducer && !disruptor->published)) {
+		Thread_DisruptorDestroy(disruptor);
+		return NULL;
+	}
+	memset(disruptor->entries, 0, capacity * disruptor->stride);
+	memset(disruptor->consumers, 0, sizeof(DisruptorConsumer) * Thread_DISRUPTOR_MAX_CONSUMERS);
+	if (disruptor->published) {
+		// no sequence has been published in any slot yet
+		for (uint64_t i = 0; i < capacity; ++i) {
+			Thread_AtomicStore64Explicit(&disruptor->published[i], UINT64_MAX, Thread_ATOMIC_RELAXED);
+		}
+	}
+	return disruptor;
+}
+
+AL2O3_EXTERN_C void Thread_DisruptorDestroy(Thread_DisruptorHandle disruptor) {
+	if (!disruptor) {
+		return;
+	}
+	MEMORY_FREE(disruptor->published);
+	MEMORY_FREE(disruptor->consumers);
+	MEMORY_FREE(disruptor->entries);
+	MEMORY_FREE(disruptor);
+}
+
+AL2O3_EXTERN_C int32_t Thread_DisruptorAddConsumer(Thread_DisruptorHandle disruptor,
+																									 uint32_t const *dependsOn,
+																									 uint32_t dependsOnCount) {
+	ASSERT(disruptor);
+	ASSERT(dependsOn || dependsOnCount == 0);
+	ASSERT(Thread_AtomicLoad64Explicit(&disruptor->claimed.value, Thread_ATOMIC_RELAXED) == 0);
+	if (disruptor->consumerCount == Thread_DISRUPTOR_MAX_CONSUMERS) {
+		return -1;
+	}
+	uint32_t const index = disruptor->consumerCount;
+	DisruptorConsumer *consumer = &disruptor->consumers[index];
+	consumer->gating = true;
+	for (uint32_t i = 0; i < dependsOnCount; ++i) {
+		// only earlier consumers, so the dependencies can't form a cycle
+		ASSERT(dependsOn[i] < index);
+		consumer->dependsOn[consumer->dependsOnCount++] = dependsOn[i];
+		// whoever waits on us waits on them too
+		disruptor->consumers[dependsOn[i]].gating = false;
+	}
+	disruptor->consumerCount++;
+	return (int32_t) index;
+}
+
+AL2O3_EXTERN_C uint64_t Thread_DisruptorClaim(Thread_DisruptorHandle disruptor, uint32_t count) {
+	ASSERT(disruptor);
+	ASSERT(disruptor->consumerCount);
+	ASSERT(count && count <= disruptor->mask + 1);
+	uint64_t first;
+	if (disruptor->singleProducer) {
+		first = Thread_AtomicLoad64Explicit(&disruptor->claimed.value, Thread_ATOMIC_RELAXED);
+		Thread_AtomicStore64Explicit(&disruptor->claimed.value, first + count, Thread_ATOMIC_RELAXED);
+	} else {
+		first = Thread_AtomicFetchAdd64Explicit(&disruptor->claimed.value, count, Thread_ATOMIC_RELAXED);
+	}
+	DisruptorWaitForRoom(disruptor, first + count);
+	return first;
+}
+
+AL2O3_EXTERN_C bool Thread_DisruptorTryClaim(Thread_DisruptorHandle disruptor, uint32_t count, uint64_t *outFirst) {
+	ASSERT(disruptor);
+	ASSERT(disruptor->consumerCount);
+	ASSERT(count && count <= disruptor->mask + 1);
+	ASSERT(outFirst);
+	uint64_t first = Thread_AtomicLoad64Explicit(&disruptor->claimed.value, Thread_ATOMIC_RELAXED);
+	if (disruptor->singleProducer) {
+		if (!DisruptorHasRoom(disruptor, first + count)) {
+			return false;
+		}
+		Thread_AtomicStore64Explicit(&disruptor->claimed.value, first + count, Thread_ATOMIC_RELAXED);
+		*outFirst = first;
+		return true;
+	}
+	do {
+		if (!DisruptorHasRoom(disruptor, first + count)) {
+			return false;
+		}
+	} while (!Thread_AtomicCompareExchangeWeak64Explicit(&disruptor->claimed.value, &first, first + count,
+																											 Thread_ATOMIC_RELAXED, Thread_ATOMIC_RELAXED));
+	*outFirst = first;
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_DisruptorPublish(Thread_DisruptorHandle disruptor, uint64_t first, uint32_t count) {
+	ASSERT(disruptor);
+	if (disruptor->singleProducer) {
+		ASSERT(Thread_AtomicLoad64Explicit(&disruptor->cursor.value, Thread_ATOMIC_RELAXED) == first);
+		Thread_AtomicStore64Explicit(&disruptor->cursor.value, first + count, Thread_ATOMIC_RELEASE);
+	} else {
+		for (uint64_t sequence = first; sequence < first + count; ++sequence) {
+			Thread_AtomicStore64Explicit(&disruptor->published[sequence & disruptor->mask], sequence, Thread_ATOMIC_RELEASE);
+		}
+	}
+	DisruptorNotify(disruptor);
+}
+
+AL2O3_EXTERN_C uint32_t Thread_DisruptorConsumerWait(Thread_DisruptorHandle disruptor,
+																										 uint32_t consumerIndex,
+																										 uint64_t *outFirst,
+																										 uint32_t maxCount,
+																										 uint64_t timeoutNs) {
+	ASSERT(disruptor);
+	ASSERT(consumerIndex < disruptor->consumerCount);
+	ASSERT(outFirst);
+	ASSERT(maxCount);
+	DisruptorConsumer *consumer = &disruptor->consumers[consumerIndex];
+	uint64_t const next = Thread_AtomicLoad64Explicit(&consumer->cursor.value, Thread_ATOMIC_RELAXED);
+	*outFirst = next;
+
+	// what a previous look found is still there, only look again if it doesn't fill the batch
+	uint64_t available = consumer->available;
+	if (available < next + maxCount) {
+		uint64_t const known = available > next ? available : next;
+		available = DisruptorAvailable(disruptor, consumer, known, next + maxCount);
+		if (available <= next) {
+			DisruptorWaiter waiter;
+			DisruptorWaiterInit(&waiter, timeoutNs);
+			while ((available = DisruptorAvailable(disruptor, consumer, next, next + maxCount)) <= next &&
+					DisruptorWaiterStep(disruptor, &waiter)) {
+			}
+			DisruptorWaiterDone(disruptor, &waiter);
+			if (available <= next) {
+				return 0;
+			}
+		}
+		consumer->available = available;
+	}
+	return available - next < maxCount ? (uint32_t) (available - next) : maxCount;
+}
+
+AL2O3_EXTERN_C void Thread_DisruptorConsumerRelease(Thread_DisruptorHandle disruptor, uint32_t consumerIndex, uint32_t count) {
+	ASSERT(disruptor);
+	ASSERT(consumerIndex < disruptor->consumerCount);
+	DisruptorConsumer *consumer = &disruptor->consumers[consumerIndex];
+	uint64_t const cursor = Thread_AtomicLoad64Explicit(&consumer->cursor.value, Thread_ATOMIC_RELAXED);
+	ASSERT(cursor + count <= consumer->available);
+	// release so producers and dependents see we're done with the entries
+	Thread_AtomicStore64Explicit(&consumer->cursor.value, cursor + count, Thread_ATOMIC_RELEASE);
+	DisruptorNotify(disruptor);
+}
+
+AL2O3_EXTERN_C void *Thread_DisruptorEntry(Thread_DisruptorHandle disruptor, uint64_t sequence) {
+	ASSERT(disruptor);
+	return disruptor->entries + (sequence & disruptor->mask) * disruptor->stride;
+}
+
+AL2O3_EXTERN_C uint32_t Thread_DisruptorCapacity(Thread_DisruptorHandle disruptor) {
+	ASSERT(disruptor);
+	return (uint32_t) (disruptor->mask + 1);
+}
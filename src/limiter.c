@@ -0,0 +1,229 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+#include "al2o3_thread/spinlock.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/limiter.h"
+#include "al2o3_memory/memory.h"
+
+#define LIMITER_NS_PER_SECOND 1000000000ull
+
+typedef struct LimiterJob {
+	struct LimiterJob *next;
+	Thread_JobFunction func;
+	void *data;
+} LimiterJob;
+
+typedef struct Thread_Limiter {
+	Thread_PoolHandle pool;
+	uint32_t maxConcurrent;
+
+	Thread_SpinLock lock;
+	// under lock
+	uint32_t running;
+	uint32_t queued;
+	LimiterJob *head;
+	LimiterJob *tail;
+	LimiterJob *freeJobs;
+
+	// slots submitted to the pool that haven't returned, destroy waits for 0
+	Thread_Atomic32_t live;
+} Thread_Limiter;
+
+// one per running slot, keeps going until the queue is empty
+static void LimiterSlot(void *data) {
+	Thread_Limiter *limiter = (Thread_Limiter *) data;
+	Thread_SpinLockAcquire(&limiter->lock);
+	while (limiter->head) {
+		LimiterJob *job = limiter->head;
+		limiter->head = job->next;
+		if (!limiter->head) {
+			limiter->tail = NULL;
+		}
+		limiter->queued--;
+		Thread_JobFunction const func = job->func;
+		void *const jobData = job->data;
+		job->next = limiter->freeJobs;
+		limiter->freeJobs = job;
+		Thread_SpinLockRelease(&limiter->lock);
+
+		func(jobData);
+
+		Thread_SpinLockAcquire(&limiter->lock);
+	}
+	limiter->running--;
+	Thread_SpinLockRelease(&limiter->lock);
+
+	// the limiter can be freed once this lands, the wake only uses the address
+	if (Thread_AtomicFetchSub32Explicit(&limiter->live, 1, Thread_ATOMIC_RELEASE) == 1) {
+		Thread_FutexWakeAll(&limiter->live);
+	}
+}
+
+AL2O3_EXTERN_C Thread_LimiterHandle Thread_LimiterCreate(Thread_PoolHandle pool, uint32_t maxConcurrent) {
+	ASSERT(pool);
+	ASSERT(maxConcurrent);
+	Thread_Limiter *limiter = (Thread_Limiter *) MEMORY_CALLOC(1, sizeof(Thread_Limiter));
+	if (!limiter) {
+		return NULL;
+	}
+	limiter->pool = pool;
+	limiter->maxConcurrent = maxConcurrent;
+	Thread_SpinLockCreate(&limiter->lock);
+	return limiter;
+}
+
+AL2O3_EXTERN_C void Thread_LimiterDestroy(Thread_LimiterHandle limiter) {
+	if (!limiter) {
+		return;
+	}
+	for (;;) {
+		uint32_t const live = Thread_AtomicLoad32Explicit(&limiter->live, Thread_ATOMIC_ACQUIRE);
+		if (live == 0) {
+			break;
+		}
+		Thread_FutexWait(&limiter->live, live, Thread_FUTEX_WAIT_INFINITE);
+	}
+	ASSERT(!limiter->head);
+	while (limiter->freeJobs) {
+		LimiterJob *job = limiter->freeJobs;
+		limiter->freeJobs = job->next;
+		MEMORY_FREE(job);
+	}
+	Thread_SpinLockDestroy(&limiter->lock);
+	MEMORY_FREE(limiter);
+}
+
+AL2O3_EXTERN_C void Thread_LimiterSubmit(Thread_LimiterHandle limiter, Thread_JobFunction func, void *data) {
+	ASSERT(limiter);
+	ASSERT(func);
+	Thread_SpinLockAcquire(&limiter->lock);
+	LimiterJob *job = limiter->freeJobs;
+	if (job) {
+		limiter->freeJobs = job->next;
+	}
+	Thread_SpinLockRelease(&limiter->lock);
+	if (!job) {
+		job = (LimiterJob *) MEMORY_MALLOC(sizeof(LimiterJob));
+		if (!job) {
+			// like the pool when it can't queue, run it here
+			func(data);
+			return;
+		}
+	}
+	job->next = NULL;
+	job->func = func;
+	job->data = data;
+
+	Thread_SpinLockAcquire(&limiter->lock);
+	if (limiter->tail) {
+		limiter->tail->next = job;
+	} else {
+		limiter->head = job;
+	}
+	limiter->tail = job;
+	limiter->queued++;
+	bool const startSlot = limiter->running < limiter->maxConcurrent;
+	if (startSlot) {
+		limiter->running++;
+	}
+	Thread_SpinLockRelease(&limiter->lock);
+
+	if (startSlot) {
+		Thread_AtomicFetchAdd32Explicit(&limiter->live, 1, Thread_ATOMIC_RELAXED);
+		Thread_PoolSubmit(limiter->pool, &LimiterSlot, limiter);
+	}
+}
+
+AL2O3_EXTERN_C uint32_t Thread_LimiterRunningCount(Thread_LimiterHandle limiter) {
+	ASSERT(limiter);
+	Thread_SpinLockAcquire(&limiter->lock);
+	uint32_t const running = limiter->running;
+	Thread_SpinLockRelease(&limiter->lock);
+	return running;
+}
+
+AL2O3_EXTERN_C uint32_t Thread_LimiterQueuedCount(Thread_LimiterHandle limiter) {
+	ASSERT(limiter);
+	Thread_SpinLockAcquire(&limiter->lock);
+	uint32_t const queued = limiter->queued;
+	Thread_SpinLockRelease(&limiter->lock);
+	return queued;
+}
+
+// tokens the clock has refilled elapsed ns after create, rounded down. Split at whole
+// seconds so nothing overflows for centuries at any rate up to 1e9
+static uint64_t RateTokensAt(Thread_RateLimiter *limiter, uint64_t elapsed) {
+	return (elapsed / LIMITER_NS_PER_SECOND) * limiter->tokensPerSecond +
+			(elapsed % LIMITER_NS_PER_SECOND) * limiter->tokensPerSecond / LIMITER_NS_PER_SECOND;
+}
+
+// ns after create the clock reaches token, rounded up
+static uint64_t RateTokenNs(Thread_RateLimiter *limiter, uint64_t token) {
+	uint64_t const remainder = token % limiter->tokensPerSecond;
+	return (token / limiter->tokensPerSecond) * LIMITER_NS_PER_SECOND +
+			(remainder * LIMITER_NS_PER_SECOND + limiter->tokensPerSecond - 1) / limiter->tokensPerSecond;
+}
+
+AL2O3_EXTERN_C bool Thread_RateLimiterCreate(Thread_RateLimiter *limiter, uint64_t tokensPerSecond, uint32_t burst) {
+	ASSERT(limiter);
+	ASSERT(tokensPerSecond && tokensPerSecond <= LIMITER_NS_PER_SECOND);
+	ASSERT(burst);
+	limiter->startNs = Thread_MonotonicNs();
+	limiter->tokensPerSecond = tokensPerSecond;
+	limiter->burst = burst;
+	// full at token 0, which is now
+	Thread_AtomicStore64Explicit(&limiter->fullAtToken.value, 0, Thread_ATOMIC_RELAXED);
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_RateLimiterDestroy(Thread_RateLimiter *limiter) {
+	ASSERT(limiter);
+}
+
+AL2O3_EXTERN_C bool Thread_RateLimiterTryAcquire(Thread_RateLimiter *limiter, uint32_t tokens) {
+	ASSERT(limiter);
+	ASSERT(tokens <= limiter->burst);
+	uint64_t const elapsed = Thread_MonotonicNs() - limiter->startNs;
+	uint64_t const now = RateTokensAt(limiter, elapsed);
+	uint64_t fullAt = Thread_AtomicLoad64Explicit(&limiter->fullAtToken.value, Thread_ATOMIC_RELAXED);
+	for (;;) {
+		// tokens already owed plus ours can't be more than a full bucket
+		uint64_t const next = (fullAt > now ? fullAt : now) + tokens;
+		if (next - now > limiter->burst) {
+			return false;
+		}
+		if (Thread_AtomicCompareExchangeWeak64Explicit(&limiter->fullAtToken.value, &fullAt, next,
+																									 Thread_ATOMIC_RELAXED, Thread_ATOMIC_RELAXED)) {
+			return true;
+		}
+	}
+}
+
+AL2O3_EXTERN_C uint64_t Thread_RateLimiterReserve(Thread_RateLimiter *limiter, uint32_t tokens) {
+	ASSERT(limiter);
+	uint64_t const elapsed = Thread_MonotonicNs() - limiter->startNs;
+	uint64_t const now = RateTokensAt(limiter, elapsed);
+	uint64_t fullAt = Thread_AtomicLoad64Explicit(&limiter->fullAtToken.value, Thread_ATOMIC_RELAXED);
+	uint64_t next;
+	do {
+		next = (fullAt > now ? fullAt : now) + tokens;
+	} while (!Thread_AtomicCompareExchangeWeak64Explicit(&limiter->fullAtToken.value, &fullAt, next,
+																											 Thread_ATOMIC_RELAXED, Thread_ATOMIC_RELAXED));
+	if (next - now <= limiter->burst) {
+		return 0;
+	}
+	// usable once the clock has refilled what's owed beyond a full bucket
+	uint64_t const readyNs = RateTokenNs(limiter, next - limiter->burst);
+	return readyNs > elapsed ? readyNs - elapsed : 0;
+}
+
+AL2O3_EXTERN_C uint32_t Thread_RateLimiterAvailable(Thread_RateLimiter *limiter) {
+	ASSERT(limiter);
+	uint64_t const elapsed = Thread_MonotonicNs() - limiter->startNs;
+	uint64_t const now = RateTokensAt(limiter, elapsed);
+	uint64_t const fullAt = Thread_AtomicLoad64Explicit(&limiter->fullAtToken.value, Thread_ATOMIC_RELAXED);
+	uint64_t const owed = fullAt > now ? fullAt - now : 0;
+	return owed >= limiter->burst ? 0 : (uint32_t) (limiter->burst - owed);
+}
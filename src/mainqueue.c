@@ -0,0 +1,91 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+#include "al2o3_thread/mpsc.h"
+#include "al2o3_thread/mainqueue.h"
+#include "al2o3_memory/memory.h"
+
+typedef struct MainQueueJob {
+	Thread_MPSCNode node;
+	Thread_JobFunction func;
+	void *data;
+	// set for PostAndWait jobs, which live on the poster's stack
+	Thread_Atomic32_t *done;
+} MainQueueJob;
+
+static Thread_MPSCQueue s_mainQueue = {{&s_mainQueue.stub}, &s_mainQueue.stub, {{NULL}}};
+static Thread_Atomic32_t s_mainQueueCount;
+
+static void MainQueuePush(MainQueueJob *job) {
+	Thread_AtomicFetchAdd32Explicit(&s_mainQueueCount, 1, Thread_ATOMIC_RELAXED);
+	Thread_MPSCQueuePush(&s_mainQueue, &job->node);
+}
+
+AL2O3_EXTERN_C void Thread_MainQueuePost(Thread_JobFunction func, void *data) {
+	ASSERT(func);
+	MainQueueJob *job = (MainQueueJob *) MEMORY_MALLOC(sizeof(MainQueueJob));
+	ASSERT(job);
+	job->func = func;
+	job->data = data;
+	job->done = NULL;
+	MainQueuePush(job);
+}
+
+AL2O3_EXTERN_C void Thread_MainQueuePostAndWait(Thread_JobFunction func, void *data) {
+	ASSERT(func);
+	if (Thread_IsMainThread()) {
+		func(data);
+		return;
+	}
+	Thread_Atomic32_t done;
+	Thread_AtomicStore32Explicit(&done, 0, Thread_ATOMIC_RELAXED);
+	MainQueueJob job;
+	job.func = func;
+	job.data = data;
+	job.done = &done;
+	MainQueuePush(&job);
+	// the main thread may only pump once a frame, no point spinning
+	while (Thread_AtomicLoad32Explicit(&done, Thread_ATOMIC_ACQUIRE) == 0) {
+		Thread_FutexWait(&done, 0, Thread_FUTEX_WAIT_INFINITE);
+	}
+}
+
+AL2O3_EXTERN_C uint32_t Thread_MainQueuePump(uint64_t budgetNs) {
+	// the queue has one consumer, another thread popping would race the main thread
+	if (!Thread_IsMainThread()) {
+		return 0;
+	}
+
+	// only what is already queued, so a job that reposts itself can't keep us here
+	uint32_t const waiting = Thread_AtomicLoad32Explicit(&s_mainQueueCount, Thread_ATOMIC_ACQUIRE);
+	uint64_t const start = waiting ? Thread_MonotonicNs() : 0;
+	uint32_t ran = 0;
+	while (ran < waiting) {
+		// NULL can also be a post half way through, it'll be there next pump
+		MainQueueJob *job = (MainQueueJob *) Thread_MPSCQueuePop(&s_mainQueue);
+		if (!job) {
+			break;
+		}
+		Thread_AtomicFetchSub32Explicit(&s_mainQueueCount, 1, Thread_ATOMIC_RELAXED);
+		job->func(job->data);
+		ran++;
+		if (job->done) {
+			// done is on the poster's stack, which can be gone by the wake,
+			// a wake on a dead address is harmless
+			Thread_Atomic32_t *done = job->done;
+			Thread_AtomicStore32Explicit(done, 1, Thread_ATOMIC_RELEASE);
+			Thread_FutexWakeOne(done);
+		} else {
+			MEMORY_FREE(job);
+		}
+		if (Thread_MonotonicNs() - start >= budgetNs) {
+			break;
+		}
+	}
+	return ran;
+}
+
+AL2O3_EXTERN_C uint32_t Thread_MainQueueCount(void) {
+	return Thread_AtomicLoad32Explicit(&s_mainQueueCount, Thread_ATOMIC_RELAXED);
+}
@@ -0,0 +1,54 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/mpsc.h"
+
+AL2O3_EXTERN_C bool Thread_MPSCQueueCreate(Thread_MPSCQueue *queue) {
+	ASSERT(queue);
+	Thread_AtomicStorePtrExplicit(&queue->stub.next, NULL, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStorePtrExplicit(&queue->head, &queue->stub, Thread_ATOMIC_RELAXED);
+	queue->tail = &queue->stub;
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_MPSCQueueDestroy(Thread_MPSCQueue *queue) {
+	ASSERT(queue);
+}
+
+AL2O3_EXTERN_C void Thread_MPSCQueuePush(Thread_MPSCQueue *queue, Thread_MPSCNode *node) {
+	ASSERT(queue);
+	ASSERT(node);
+	Thread_AtomicStorePtrExplicit(&node->next, NULL, Thread_ATOMIC_RELAXED);
+	Thread_MPSCNode *prev = (Thread_MPSCNode *) Thread_AtomicExchangePtrExplicit(&queue->head, node, Thread_ATOMIC_ACQ_REL);
+	// until this store the consumer can't see node or anything pushed after it
+	Thread_AtomicStorePtrExplicit(&prev->next, node, Thread_ATOMIC_RELEASE);
+}
+
+AL2O3_EXTERN_C Thread_MPSCNode *Thread_MPSCQueuePop(Thread_MPSCQueue *queue) {
+	ASSERT(queue);
+	Thread_MPSCNode *tail = queue->tail;
+	Thread_MPSCNode *next = (Thread_MPSCNode *) Thread_AtomicLoadPtrExplicit(&tail->next, Thread_ATOMIC_ACQUIRE);
+	// the stub is just a placeholder, step over it
+	if (tail == &queue->stub) {
+		if (!next) {
+			return NULL;
+		}
+		queue->tail = next;
+		tail = next;
+		next = (Thread_MPSCNode *) Thread_AtomicLoadPtrExplicit(&next->next, Thread_ATOMIC_ACQUIRE);
+	}
+	if (next) {
+		queue->tail = next;
+		return tail;
+	}
+	// tail is the last linked node, it can only go once something is behind it
+	if (tail != Thread_AtomicLoadPtrExplicit(&queue->head, Thread_ATOMIC_ACQUIRE)) {
+		return NULL;
+	}
+	Thread_MPSCQueuePush(queue, &queue->stub);
+	next = (Thread_MPSCNode *) Thread_AtomicLoadPtrExplicit(&tail->next, Thread_ATOMIC_ACQUIRE);
+	if (next) {
+		queue->tail = next;
+		return tail;
+	}
+	return NULL;
+}
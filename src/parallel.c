@@ -0,0 +1,489 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/barrier.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/parallel.h"
+#include "al2o3_memory/memory.h"
+#include <string.h>
+
+// about half a typical L2, big enough that claiming a block is noise
+#define PARALLEL_BLOCK_BYTES (64 * 1024)
+// blocks handed to each participant when the caller doesn't choose
+#define PARALLEL_DEFAULT_BLOCKS_PER_WORKER 8
+#define PARALLEL_MAX_BLOCKS 0x7fffffffull
+
+#define SORT_INSERTION_RUN 16
+#define SORT_MIN_CHUNK 4096
+#define SORT_CHUNKS_PER_WORKER 4
+
+// one per parallel for with helpers, helpers that start after the last block
+// was claimed still touch it, so the last reference frees it not the caller
+typedef struct ParallelForJob {
+	Thread_ParallelForFunction func;
+	void *data;
+	uint64_t count;
+	uint64_t blockSize;
+	uint64_t blockCount;
+	Thread_Atomic64_t nextBlock;
+	Thread_Atomic32_t refs;
+	Thread_Latch done;
+} ParallelForJob;
+
+static uint64_t BlockElements(uint32_t elementSize) {
+	uint64_t const elements = PARALLEL_BLOCK_BYTES / (elementSize ? elementSize : 1);
+	return elements ? elements : 1;
+}
+
+static uint32_t Participants(Thread_PoolHandle pool) {
+	return pool ? Thread_PoolMaxWorkerCount(pool) + 1 : 1;
+}
+
+static void ParallelForRun(ParallelForJob *job) {
+	uint32_t ran = 0;
+	for (;;) {
+		uint64_t const block = Thread_AtomicFetchAdd64Explicit(&job->nextBlock, 1, Thread_ATOMIC_RELAXED);
+		if (block >= job->blockCount) {
+			break;
+		}
+		uint64_t const begin = block * job->blockSize;
+		uint64_t const end = job->count - begin > job->blockSize ? begin + job->blockSize : job->count;
+		job->func(job->data, begin, end);
+		ran++;
+	}
+	if (ran) {
+		Thread_LatchCountDown(&job->done, ran);
+	}
+}
+
+static void ParallelForRelease(ParallelForJob *job) {
+	if (Thread_AtomicFetchSub32Explicit(&job->refs, 1, Thread_ATOMIC_ACQ_REL) == 1) {
+		Thread_LatchDestroy(&job->done);
+		MEMORY_FREE(job);
+	}
+}
+
+static void ParallelForHelper(void *data) {
+	ParallelForJob *job = (ParallelForJob *) data;
+	ParallelForRun(job);
+	ParallelForRelease(job);
+}
+
+AL2O3_EXTERN_C void Thread_ParallelFor(Thread_PoolHandle pool, uint64_t count, uint64_t blockSize,
+																			 Thread_ParallelForFunction func, void *data) {
+	ASSERT(func);
+	if (count == 0) {
+		return;
+	}
+	uint32_t const participants = Participants(pool);
+	if (blockSize == 0) {
+		blockSize = count / ((uint64_t) participants * PARALLEL_DEFAULT_BLOCKS_PER_WORKER);
+		blockSize = blockSize ? blockSize : 1;
+	}
+	uint64_t blockCount = (count + blockSize - 1) / blockSize;
+	if (blockCount > PARALLEL_MAX_BLOCKS) {
+		blockSize = (count + PARALLEL_MAX_BLOCKS - 1) / PARALLEL_MAX_BLOCKS;
+		blockCount = (count + blockSize - 1) / blockSize;
+	}
+	uint32_t const helpers = (uint32_t) (blockCount - 1 < participants - 1 ? blockCount - 1 : participants - 1);
+
+	ParallelForJob *job = helpers ? (ParallelForJob *) MEMORY_MALLOC(sizeof(ParallelForJob)) : NULL;
+	if (!job) {
+		for (uint64_t begin = 0; begin < count; begin += blockSize) {
+			func(data, begin, count - begin > blockSize ? begin + blockSize : count);
+		}
+		return;
+	}
+	job->func = func;
+	job->data = data;
+	job->count = count;
+	job->blockSize = blockSize;
+	job->blockCount = blockCount;
+	Thread_AtomicStore64Explicit(&job->nextBlock, 0, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&job->refs, helpers + 1, Thread_ATOMIC_RELAXED);
+	Thread_LatchCreate(&job->done, (uint32_t) blockCount);
+	for (uint32_t i = 0; i < helpers; ++i) {
+		Thread_PoolSubmit(pool, &ParallelForHelper, job);
+	}
+	// work alongside the helpers, then only wait for blocks already running
+	ParallelForRun(job);
+	Thread_LatchWait(&job->done);
+	ParallelForRelease(job);
+}
+
+//--------------------------------------------------------------
+//  Sort
+//  Chunks are sorted independently (insertion sorted runs then a bottom up
+//  merge), then merged in pairs round by round. Each merge is cut into
+//  fixed size output segments by binary searching the merge path, so the
+//  last rounds with only a couple of huge runs are as parallel as the first.
+//--------------------------------------------------------------
+typedef struct SortContext {
+	uint8_t *data;
+	uint8_t *tmp;
+	uint64_t count;
+	uint32_t elementSize;
+	Thread_ParallelKeyFunction key;
+	void *userData;
+
+	// current merge round
+	uint8_t const *from;
+	uint8_t *to;
+	uint64_t width;
+	uint64_t segmentSize;
+	uint64_t segmentsPerPair;
+} SortContext;
+
+// constant sizes let the compiler turn these into plain moves
+AL2O3_FORCE_INLINE void SortCopy(void *dst, void const *src, uint32_t size) {
+	switch (size) {
+		case 4: memcpy(dst, src, 4);
+			break;
+		case 8: memcpy(dst, src, 8);
+			break;
+		case 16: memcpy(dst, src, 16);
+			break;
+		default: memcpy(dst, src, size);
+			break;
+	}
+}
+
+AL2O3_FORCE_INLINE uint64_t SortKey(SortContext const *ctx, uint8_t const *base, uint64_t index) {
+	return ctx->key(base + index * ctx->elementSize, ctx->userData);
+}
+
+// stable, ties take from a first
+static void SortMerge(SortContext const *ctx, uint8_t const *a, uint64_t aCount,
+											uint8_t const *b, uint64_t bCount, uint8_t *out) {
+	uint32_t const size = ctx->elementSize;
+	if (aCount && bCount) {
+		uint64_t ka = ctx->key(a, ctx->userData);
+		uint64_t kb = ctx->key(b, ctx->userData);
+		for (;;) {
+			if (kb < ka) {
+				SortCopy(out, b, size);
+				out += size;
+				b += size;
+				if (--bCount == 0) {
+					break;
+				}
+				kb = ctx->key(b, ctx->userData);
+			} else {
+				SortCopy(out, a, size);
+				out += size;
+				a += size;
+				if (--aCount == 0) {
+					break;
+				}
+				ka = ctx->key(a, ctx->userData);
+			}
+		}
+	}
+	memcpy(out, a, (size_t) aCount * size);
+	memcpy(out + (size_t) aCount * size, b, (size_t) bCount * size);
+}
+
+// how many of the first k outputs of merging a and b come from a
+static uint64_t SortCoRank(SortContext const *ctx, uint8_t const *a, uint64_t aCount,
+													 uint8_t const *b, uint64_t bCount, uint64_t k) {
+	uint64_t lo = k > bCount ? k - bCount : 0;
+	uint64_t hi = k < aCount ? k : aCount;
+	while (lo < hi) {
+		uint64_t const i = lo + (hi - lo) / 2;
+		if (SortKey(ctx, a, i) <= SortKey(ctx, b, k - i - 1)) {
+			lo = i + 1;
+		} else {
+			hi = i;
+		}
+	}
+	return lo;
+}
+
+static void SortChunk(void *data, uint64_t begin, uint64_t end) {
+	SortContext const *ctx = (SortContext const *) data;
+	uint32_t const size = ctx->elementSize;
+	uint64_t const n = end - begin;
+	uint8_t *chunk = ctx->data + begin * size;
+	// the chunk's part of tmp is free until the merge passes
+	uint8_t *held = ctx->tmp + begin * size;
+
+	for (uint64_t run = 0; run < n; run += SORT_INSERTION_RUN) {
+		uint64_t const runEnd = n - run > SORT_INSERTION_RUN ? run + SORT_INSERTION_RUN : n;
+		for (uint64_t i = run + 1; i < runEnd; ++i) {
+			uint64_t const k = SortKey(ctx, chunk, i);
+			uint64_t j = i;
+			while (j > run && SortKey(ctx, chunk, j - 1) > k) {
+				j--;
+			}
+			if (j != i) {
+				SortCopy(held, chunk + i * size, size);
+				memmove(chunk + (j + 1) * size, chunk + j * size, (size_t) (i - j) * size);
+				SortCopy(chunk + j * size, held, size);
+			}
+		}
+	}
+
+	uint8_t *from = chunk;
+	uint8_t *to = ctx->tmp + begin * size;
+	for (uint64_t width = SORT_INSERTION_RUN; width < n; width *= 2) {
+		for (uint64_t lo = 0; lo < n; lo += 2 * width) {
+			uint64_t const mid = n - lo > width ? lo + width : n;
+			uint64_t const hi = n - lo > 2 * width ? lo + 2 * width : n;
+			SortMerge(ctx, from + lo * size, mid - lo, from + mid * size, hi - mid, to + lo * size);
+		}
+		uint8_t *swap = from;
+		from = to;
+		to = swap;
+	}
+	if (from != chunk) {
+		memcpy(chunk, from, (size_t) n * size);
+	}
+}
+
+static void SortMergeSegments(void *data, uint64_t begin, uint64_t end) {
+	SortContext const *ctx = (SortContext const *) data;
+	uint32_t const size = ctx->elementSize;
+	uint64_t const n = ctx->count;
+	for (uint64_t index = begin; index < end; ++index) {
+		uint64_t const lo = (index / ctx->segmentsPerPair) * 2 * ctx->width;
+		uint64_t const outBegin = (index % ctx->segmentsPerPair) * ctx->segmentSize;
+		uint64_t const mid = n - lo > ctx->width ? lo + ctx->width : n;
+		uint64_t const hi = n - lo > 2 * ctx->width ? lo + 2 * ctx->width : n;
+		if (outBegin >= hi - lo) {
+			continue;
+		}
+		uint64_t const outEnd = hi - lo - outBegin > ctx->segmentSize ? outBegin + ctx->segmentSize : hi - lo;
+
+		uint8_t const *a = ctx->from + lo * size;
+		uint8_t const *b = ctx->from + mid * size;
+		uint64_t const aCount = mid - lo;
+		uint64_t const bCount = hi - mid;
+		uint64_t const aBegin = SortCoRank(ctx, a, aCount, b, bCount, outBegin);
+		uint64_t const aEnd = SortCoRank(ctx, a, aCount, b, bCount, outEnd);
+		uint64_t const bBegin = outBegin - aBegin;
+		uint64_t const bEnd = outEnd - aEnd;
+		SortMerge(ctx, a + aBegin * size, aEnd - aBegin, b + bBegin * size, bEnd - bBegin,
+							ctx->to + (lo + outBegin) * size);
+	}
+}
+
+static void SortCopyBack(void *data, uint64_t begin, uint64_t end) {
+	SortContext const *ctx = (SortContext const *) data;
+	memcpy(ctx->data + begin * ctx->elementSize, ctx->tmp + begin * ctx->elementSize,
+				 (size_t) (end - begin) * ctx->elementSize);
+}
+
+AL2O3_EXTERN_C bool Thread_ParallelSort(Thread_PoolHandle pool, void *base, uint64_t count, uint32_t elementSize,
+																				Thread_ParallelKeyFunction key, void *userData) {
+	ASSERT(base || count == 0);
+	ASSERT(key);
+	if (count < 2 || elementSize == 0) {
+		return true;
+	}
+
+	SortContext ctx;
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.data = (uint8_t *) base;
+	ctx.tmp = (uint8_t *) MEMORY_MALLOC((size_t) count * elementSize);
+	if (!ctx.tmp) {
+		return false;
+	}
+	ctx.count = count;
+	ctx.elementSize = elementSize;
+	ctx.key = key;
+	ctx.userData = userData;
+
+	uint64_t chunks = 1;
+	if (pool) {
+		uint64_t const wanted = (uint64_t) Participants(pool) * SORT_CHUNKS_PER_WORKER;
+		while (chunks < wanted && count / (chunks * 2) >= SORT_MIN_CHUNK) {
+			chunks *= 2;
+		}
+	}
+	uint64_t const chunkSize = (count + chunks - 1) / chunks;
+	Thread_ParallelFor(pool, count, chunkSize, &SortChunk, &ctx);
+
+	ctx.from = ctx.data;
+	ctx.to = ctx.tmp;
+	ctx.segmentSize = BlockElements(elementSize);
+	for (ctx.width = chunkSize; ctx.width < count; ctx.width *= 2) {
+		uint64_t const pairs = (count + 2 * ctx.width - 1) / (2 * ctx.width);
+		ctx.segmentsPerPair = (2 * ctx.width + ctx.segmentSize - 1) / ctx.segmentSize;
+		Thread_ParallelFor(pool, pairs * ctx.segmentsPerPair, 1, &SortMergeSegments, &ctx);
+		uint8_t *swap = (uint8_t *) ctx.from;
+		ctx.from = ctx.to;
+		ctx.to = swap;
+	}
+	if (ctx.from != ctx.data) {
+		Thread_ParallelFor(pool, count, BlockElements(elementSize), &SortCopyBack, &ctx);
+	}
+	MEMORY_FREE(ctx.tmp);
+	return true;
+}
+
+//--------------------------------------------------------------
+//  Scan
+//  Sum each block, scan the (few) block sums serially, then scan each block
+//  again starting from its offset. The sum pass is a plain reduction the
+//  compiler vectorises for the integer types.
+//--------------------------------------------------------------
+#define PARALLEL_SCAN_BLOCK 16384
+
+#define PARALLEL_SCAN(NAME, TYPE)                                                                                  \
+typedef struct Scan##NAME {                                                                                        \
+	TYPE const *src;                                                                                                 \
+	TYPE *dst;                                                                                                       \
+	TYPE *blockSums;                                                                                                 \
+	bool inclusive;                                                                                                  \
+} Scan##NAME;                                                                                                      \
+                                                                                                                   \
+static void ScanSum##NAME(void *data, uint64_t begin, uint64_t end) {                                              \
+	Scan##NAME *scan = (Scan##NAME *) data;                                                                          \
+	TYPE sum = 0;                                                                                                    \
+	for (uint64_t i = begin; i < end; ++i) {                                                                         \
+		sum += scan->src[i];                                                                                           \
+	}                                                                                                                \
+	scan->blockSums[begin / PARALLEL_SCAN_BLOCK] = sum;                                                              \
+}                                                                                                                  \
+                                                                                                                   \
+/* leaves the block's end total in its block sum slot */                                                           \
+static void ScanApply##NAME(void *data, uint64_t begin, uint64_t end) {                                            \
+	Scan##NAME *scan = (Scan##NAME *) data;                                                                          \
+	TYPE sum = scan->blockSums[begin / PARALLEL_SCAN_BLOCK];                                                         \
+	if (scan->inclusive) {                                                                                           \
+		for (uint64_t i = begin; i < end; ++i) {                                                                       \
+			sum += scan->src[i];                                                                                         \
+			scan->dst[i] = sum;                                                                                          \
+		}                                                                                                              \
+	} else {                                                                                                         \
+		for (uint64_t i = begin; i < end; ++i) {                                                                       \
+			TYPE const value = scan->src[i];                                                                             \
+			scan->dst[i] = sum;                                                                                          \
+			sum += value;                                                                                                \
+		}                                                                                                              \
+	}                                                                                                                \
+	scan->blockSums[begin / PARALLEL_SCAN_BLOCK] = sum;                                                              \
+}                                                                                                                  \
+                                                                                                                   \
+AL2O3_EXTERN_C TYPE Thread_ParallelScan##NAME(Thread_PoolHandle pool, TYPE const *src, TYPE *dst,                  \
+                                              uint64_t count, bool inclusive) {                                    \
+	ASSERT((src && dst) || count == 0);                                                                              \
+	uint64_t const blocks = (count + PARALLEL_SCAN_BLOCK - 1) / PARALLEL_SCAN_BLOCK;                                 \
+	TYPE total = 0;                                                                                                  \
+	Scan##NAME scan = {src, dst, &total, inclusive};                                                                 \
+	if (!pool || blocks <= 1 || !(scan.blockSums = (TYPE *) MEMORY_MALLOC(blocks * sizeof(TYPE)))) {                 \
+		scan.blockSums = &total;                                                                                       \
+		ScanApply##NAME(&scan, 0, count);                                                                              \
+		return total;                                                                                                  \
+	}                                                                                                                \
+	Thread_ParallelFor(pool, count, PARALLEL_SCAN_BLOCK, &ScanSum##NAME, &scan);                                     \
+	for (uint64_t i = 0; i < blocks; ++i) {                                                                          \
+		TYPE const sum = scan.blockSums[i];                                                                            \
+		scan.blockSums[i] = total;                                                                                     \
+		total += sum;                                                                                                  \
+	}                                                                                                                \
+	Thread_ParallelFor(pool, count, PARALLEL_SCAN_BLOCK, &ScanApply##NAME, &scan);                                   \
+	MEMORY_FREE(scan.blockSums);                                                                                     \
+	return total;                                                                                                    \
+}
+
+PARALLEL_SCAN(U32, uint32_t)
+PARALLEL_SCAN(U64, uint64_t)
+PARALLEL_SCAN(F32, float)
+PARALLEL_SCAN(F64, double)
+
+#undef PARALLEL_SCAN
+
+//--------------------------------------------------------------
+//  Partition / compact
+//  Count the passes per block, turn the counts into output offsets, then each
+//  block scatters its passes (and for partition its fails) independently.
+//--------------------------------------------------------------
+typedef struct PartitionContext {
+	uint8_t const *src;
+	uint8_t *dst;
+	uint32_t elementSize;
+	Thread_ParallelPredicateFunction predicate;
+	void *userData;
+	uint64_t blockSize;
+	uint64_t *passed; // per block count, then passes before the block
+	uint64_t totalPassed;
+	bool keepFailed;
+} PartitionContext;
+
+static void PartitionCount(void *data, uint64_t begin, uint64_t end) {
+	PartitionContext *ctx = (PartitionContext *) data;
+	uint64_t passed = 0;
+	for (uint64_t i = begin; i < end; ++i) {
+		passed += ctx->predicate(ctx->src + i * ctx->elementSize, ctx->userData) ? 1 : 0;
+	}
+	ctx->passed[begin / ctx->blockSize] = passed;
+}
+
+static void PartitionScatter(void *data, uint64_t begin, uint64_t end) {
+	PartitionContext *ctx = (PartitionContext *) data;
+	uint32_t const size = ctx->elementSize;
+	uint64_t const passedBefore = ctx->passed[begin / ctx->blockSize];
+	uint8_t *passOut = ctx->dst + passedBefore * size;
+	uint8_t *failOut = ctx->dst + (ctx->totalPassed + begin - passedBefore) * size;
+	for (uint64_t i = begin; i < end; ++i) {
+		uint8_t const *element = ctx->src + i * size;
+		if (ctx->predicate(element, ctx->userData)) {
+			SortCopy(passOut, element, size);
+			passOut += size;
+		} else if (ctx->keepFailed) {
+			SortCopy(failOut, element, size);
+			failOut += size;
+		}
+	}
+}
+
+static uint64_t Partition(Thread_PoolHandle pool, void const *src, void *dst, uint64_t count, uint32_t elementSize,
+													Thread_ParallelPredicateFunction predicate, void *userData, bool keepFailed) {
+	ASSERT((src && dst) || count == 0);
+	ASSERT(predicate);
+	if (count == 0) {
+		return 0;
+	}
+	uint64_t single;
+	PartitionContext ctx;
+	ctx.src = (uint8_t const *) src;
+	ctx.dst = (uint8_t *) dst;
+	ctx.elementSize = elementSize;
+	ctx.predicate = predicate;
+	ctx.userData = userData;
+	ctx.blockSize = BlockElements(elementSize);
+	ctx.keepFailed = keepFailed;
+	uint64_t blocks = (count + ctx.blockSize - 1) / ctx.blockSize;
+	ctx.passed = pool && blocks > 1 ? (uint64_t *) MEMORY_MALLOC(blocks * sizeof(uint64_t)) : NULL;
+	if (!ctx.passed) {
+		ctx.blockSize = count;
+		ctx.passed = &single;
+		blocks = 1;
+	}
+
+	Thread_ParallelFor(pool, count, ctx.blockSize, &PartitionCount, &ctx);
+	ctx.totalPassed = 0;
+	for (uint64_t i = 0; i < blocks; ++i) {
+		uint64_t const passed = ctx.passed[i];
+		ctx.passed[i] = ctx.totalPassed;
+		ctx.totalPassed += passed;
+	}
+	Thread_ParallelFor(pool, count, ctx.blockSize, &PartitionScatter, &ctx);
+
+	if (ctx.passed != &single) {
+		MEMORY_FREE(ctx.passed);
+	}
+	return ctx.totalPassed;
+}
+
+AL2O3_EXTERN_C uint64_t Thread_ParallelPartition(Thread_PoolHandle pool, void const *src, void *dst, uint64_t count,
+																								 uint32_t elementSize, Thread_ParallelPredicateFunction predicate,
+																								 void *userData) {
+	return Partition(pool, src, dst, count, elementSize, predicate, userData, true);
+}
+
+AL2O3_EXTERN_C uint64_t Thread_ParallelCompact(Thread_PoolHandle pool, void const *src, void *dst, uint64_t count,
+																							 uint32_t elementSize, Thread_ParallelPredicateFunction predicate,
+																							 void *userData) {
+	return Partition(pool, src, dst, count, elementSize, predicate, userData, false);
+}
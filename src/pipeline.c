@@ -0,0 +1,293 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/barrier.h"
+#include "al2o3_thread/spinlock.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/pipeline.h"
+#include "al2o3_memory/memory.h"
+#include <string.h>
+
+// in flight items per participant when the caller doesn't choose
+#define PIPELINE_DEFAULT_TOKENS_PER_WORKER 2
+
+typedef struct PipelineToken {
+	struct Pipeline *pipeline;
+	struct PipelineToken *next;
+	void *item;
+	uint64_t sequence;
+	uint32_t stage; // the next stage to run
+} Thread_CACHE_LINE_ALIGN PipelineToken;
+
+// only used by serial stages and the first stage, which also keeps the free tokens
+typedef struct PipelineStage {
+	Thread_SpinLock lock;
+	bool busy;
+	uint64_t nextSequence;
+	// tokens waiting for the stage, in order stages by sequence % maxTokens
+	PipelineToken **inOrder;
+	PipelineToken *head;
+	PipelineToken *tail;
+} Thread_CACHE_LINE_ALIGN PipelineStage;
+
+// jobs that may still run hold a reference, the last one frees it
+typedef struct Pipeline {
+	Thread_PoolHandle pool;
+	Thread_PipelineStage const *descs;
+	uint32_t stageCount;
+	uint32_t maxTokens;
+	PipelineStage *stages;
+	PipelineToken *tokens;
+	PipelineToken **inOrder;
+
+	// under stages[0].lock
+	PipelineToken *freeTokens;
+	uint32_t freeCount;
+	bool inputEnded;
+
+	Thread_Atomic32_t refs;
+	Thread_Latch done;
+} Pipeline;
+
+static void PipelineCarry(Pipeline *pipeline, PipelineToken *token, bool entered);
+
+static void PipelineRunSerial(Thread_PipelineStage const *stages, uint32_t stageCount) {
+	for (;;) {
+		void *item = stages[0].func(NULL, stages[0].userData);
+		if (!item) {
+			return;
+		}
+		for (uint32_t i = 1; i < stageCount; ++i) {
+			item = stages[i].func(item, stages[i].userData);
+		}
+	}
+}
+
+static void PipelineRelease(Pipeline *pipeline) {
+	if (Thread_AtomicFetchSub32Explicit(&pipeline->refs, 1, Thread_ATOMIC_ACQ_REL) != 1) {
+		return;
+	}
+	for (uint32_t i = 0; i < pipeline->stageCount; ++i) {
+		Thread_SpinLockDestroy(&pipeline->stages[i].lock);
+	}
+	Thread_LatchDestroy(&pipeline->done);
+	MEMORY_FREE(pipeline->inOrder);
+	MEMORY_FREE(pipeline->tokens);
+	MEMORY_FREE(pipeline->stages);
+	MEMORY_FREE(pipeline);
+}
+
+static void PipelineCarryJob(void *data) {
+	PipelineToken *token = (PipelineToken *) data;
+	Pipeline *pipeline = token->pipeline;
+	PipelineCarry(pipeline, token, true);
+	PipelineRelease(pipeline);
+}
+
+static void PipelineSubmit(Pipeline *pipeline, Thread_JobFunction func, void *data) {
+	Thread_AtomicFetchAdd32Explicit(&pipeline->refs, 1, Thread_ATOMIC_RELAXED);
+	Thread_PoolSubmit(pipeline->pool, func, data);
+}
+
+static void PipelineInputJob(void *data);
+
+// runs the first stage if it's idle and a token is free, returns the token
+// carrying the new item or NULL
+static PipelineToken *PipelineInput(Pipeline *pipeline) {
+	PipelineStage *input = &pipeline->stages[0];
+	Thread_SpinLockAcquire(&input->lock);
+	if (input->busy || pipeline->inputEnded || !pipeline->freeTokens) {
+		Thread_SpinLockRelease(&input->lock);
+		return NULL;
+	}
+	PipelineToken *token = pipeline->freeTokens;
+	pipeline->freeTokens = token->next;
+	pipeline->freeCount--;
+	input->busy = true;
+	Thread_SpinLockRelease(&input->lock);
+
+	void *item = pipeline->descs[0].func(NULL, pipeline->descs[0].userData);
+
+	Thread_SpinLockAcquire(&input->lock);
+	input->busy = false;
+	if (item) {
+		token->sequence = input->nextSequence++;
+	} else {
+		pipeline->inputEnded = true;
+		token->next = pipeline->freeTokens;
+		pipeline->freeTokens = token;
+		pipeline->freeCount++;
+	}
+	bool const finished = pipeline->inputEnded && pipeline->freeCount == pipeline->maxTokens;
+	// tokens freed while we were reading found the stage busy and left it to us
+	bool const more = item && pipeline->freeTokens;
+	Thread_SpinLockRelease(&input->lock);
+
+	if (finished) {
+		Thread_LatchCountDown(&pipeline->done, 1);
+	}
+	if (!item) {
+		return NULL;
+	}
+	if (more) {
+		PipelineSubmit(pipeline, &PipelineInputJob, pipeline);
+	}
+	token->item = item;
+	token->stage = 1;
+	return token;
+}
+
+static void PipelineInputJob(void *data) {
+	Pipeline *pipeline = (Pipeline *) data;
+	PipelineCarry(pipeline, PipelineInput(pipeline), false);
+	PipelineRelease(pipeline);
+}
+
+// token has left the last stage, returns it and starts the next item on
+// this thread if the first stage is free
+static PipelineToken *PipelineFinish(Pipeline *pipeline, PipelineToken *token) {
+	PipelineStage *input = &pipeline->stages[0];
+	Thread_SpinLockAcquire(&input->lock);
+	token->next = pipeline->freeTokens;
+	pipeline->freeTokens = token;
+	pipeline->freeCount++;
+	bool const finished = pipeline->inputEnded && pipeline->freeCount == pipeline->maxTokens;
+	bool const more = !pipeline->inputEnded && !input->busy;
+	Thread_SpinLockRelease(&input->lock);
+
+	if (finished) {
+		Thread_LatchCountDown(&pipeline->done, 1);
+		return NULL;
+	}
+	return more ? PipelineInput(pipeline) : NULL;
+}
+
+// true if the token may run the serial stage now, else it is left waiting
+// and the thread leaving the stage will pick it up
+static bool PipelineEnter(Pipeline *pipeline, PipelineStage *stage, Thread_PipelineMode mode, PipelineToken *token) {
+	Thread_SpinLockAcquire(&stage->lock);
+	if (!stage->busy && (mode == Thread_PIPELINE_SERIAL_OUT_OF_ORDER || token->sequence == stage->nextSequence)) {
+		stage->busy = true;
+		Thread_SpinLockRelease(&stage->lock);
+		return true;
+	}
+	if (mode == Thread_PIPELINE_SERIAL_IN_ORDER) {
+		// waiting tokens are all within maxTokens of the one the stage wants
+		ASSERT(!stage->inOrder[token->sequence % pipeline->maxTokens]);
+		stage->inOrder[token->sequence % pipeline->maxTokens] = token;
+	} else {
+		token->next = NULL;
+		if (stage->tail) {
+			stage->tail->next = token;
+		} else {
+			stage->head = token;
+		}
+		stage->tail = token;
+	}
+	Thread_SpinLockRelease(&stage->lock);
+	return false;
+}
+
+// hands the stage straight to the next waiting token if there is one
+static void PipelineLeave(Pipeline *pipeline, PipelineStage *stage, Thread_PipelineMode mode) {
+	PipelineToken *next;
+	Thread_SpinLockAcquire(&stage->lock);
+	if (mode == Thread_PIPELINE_SERIAL_IN_ORDER) {
+		stage->nextSequence++;
+		PipelineToken **slot = &stage->inOrder[stage->nextSequence % pipeline->maxTokens];
+		next = *slot;
+		*slot = NULL;
+		ASSERT(!next || next->sequence == stage->nextSequence);
+	} else {
+		next = stage->head;
+		if (next) {
+			stage->head = next->next;
+			if (!stage->head) {
+				stage->tail = NULL;
+			}
+		}
+	}
+	stage->busy = next != NULL;
+	Thread_SpinLockRelease(&stage->lock);
+
+	if (next) {
+		PipelineSubmit(pipeline, &PipelineCarryJob, next);
+	}
+}
+
+// runs token through as many stages as it can on this thread, then keeps
+// going with new items while the first stage is free
+static void PipelineCarry(Pipeline *pipeline, PipelineToken *token, bool entered) {
+	while (token) {
+		if (token->stage == pipeline->stageCount) {
+			token = PipelineFinish(pipeline, token);
+			entered = false;
+			continue;
+		}
+		Thread_PipelineStage const *desc = &pipeline->descs[token->stage];
+		PipelineStage *stage = &pipeline->stages[token->stage];
+		bool const serial = desc->mode != Thread_PIPELINE_PARALLEL;
+		if (serial && !entered && !PipelineEnter(pipeline, stage, desc->mode, token)) {
+			return;
+		}
+		token->item = desc->func(token->item, desc->userData);
+		ASSERT(token->item || token->stage + 1 == pipeline->stageCount);
+		if (serial) {
+			PipelineLeave(pipeline, stage, desc->mode);
+		}
+		token->stage++;
+		entered = false;
+	}
+}
+
+AL2O3_EXTERN_C void Thread_PipelineRun(Thread_PoolHandle pool, uint32_t maxTokens,
+																			 Thread_PipelineStage const *stages, uint32_t stageCount) {
+	ASSERT(stages);
+	ASSERT(stageCount);
+	if (!pool) {
+		PipelineRunSerial(stages, stageCount);
+		return;
+	}
+	if (maxTokens == 0) {
+		maxTokens = (Thread_PoolMaxWorkerCount(pool) + 1) * PIPELINE_DEFAULT_TOKENS_PER_WORKER;
+	}
+
+	Pipeline *pipeline = (Pipeline *) MEMORY_CALLOC(1, sizeof(Pipeline));
+	if (!pipeline) {
+		PipelineRunSerial(stages, stageCount);
+		return;
+	}
+	pipeline->stages = (PipelineStage *) MEMORY_AALLOC(sizeof(PipelineStage) * stageCount, Thread_CACHE_LINE_SIZE);
+	pipeline->tokens = (PipelineToken *) MEMORY_AALLOC(sizeof(PipelineToken) * maxTokens, Thread_CACHE_LINE_SIZE);
+	pipeline->inOrder = (PipelineToken **) MEMORY_CALLOC((size_t) maxTokens * stageCount, sizeof(PipelineToken *));
+	if (!pipeline->stages || !pipeline->tokens || !pipeline->inOrder) {
+		MEMORY_FREE(pipeline->inOrder);
+		MEMORY_FREE(pipeline->tokens);
+		MEMORY_FREE(pipeline->stages);
+		MEMORY_FREE(pipeline);
+		PipelineRunSerial(stages, stageCount);
+		return;
+	}
+	pipeline->pool = pool;
+	pipeline->descs = stages;
+	pipeline->stageCount = stageCount;
+	pipeline->maxTokens = maxTokens;
+	memset(pipeline->stages, 0, sizeof(PipelineStage) * stageCount);
+	for (uint32_t i = 0; i < stageCount; ++i) {
+		Thread_SpinLockCreate(&pipeline->stages[i].lock);
+		pipeline->stages[i].inOrder = pipeline->inOrder + (size_t) maxTokens * i;
+	}
+	memset(pipeline->tokens, 0, sizeof(PipelineToken) * maxTokens);
+	for (uint32_t i = 0; i < maxTokens; ++i) {
+		pipeline->tokens[i].pipeline = pipeline;
+		pipeline->tokens[i].next = i + 1 < maxTokens ? &pipeline->tokens[i + 1] : NULL;
+	}
+	pipeline->freeTokens = pipeline->tokens;
+	pipeline->freeCount = maxTokens;
+	Thread_AtomicStore32Explicit(&pipeline->refs, 1, Thread_ATOMIC_RELAXED);
+	Thread_LatchCreate(&pipeline->done, 1);
+
+	// the caller works like any other thread until it has nothing to carry
+	PipelineCarry(pipeline, PipelineInput(pipeline), false);
+	Thread_LatchWait(&pipeline->done);
+	PipelineRelease(pipeline);
+}
@@ -0,0 +1,822 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/stats.h"
+#include "al2o3_memory/memory.h"
+#include <string.h>
+
+#define POOL_MAX_WORKERS 256
+#define POOL_DEQUE_CAPACITY 512
+#define POOL_PAUSES_PER_ROUND 32
+#define POOL_DEFAULT_SPIN_ROUNDS 32
+#define POOL_DEFAULT_RETIRE_MS 2000
+#define POOL_DEFAULT_QUEUE_CAPACITY 4096
+#define POOL_DEFAULT_AGING_INTERVAL 8
+
+#define POOL_GROUP_RESERVED 0
+#define POOL_GROUP_GENERAL 1
+#define POOL_GROUP_COUNT 2
+
+typedef struct PoolJob {
+	Thread_JobFunction func;
+	void *data;
+} PoolJob;
+
+// bounded multi producer multi consumer queue (Vyukov), a slot's sequence
+// says whether it is ready for the next push or the next pop
+typedef struct PoolQueueSlot {
+	Thread_Atomic64_t sequence;
+	PoolJob job;
+} PoolQueueSlot;
+
+typedef struct PoolQueue {
+	Thread_PaddedAtomic64_t head;
+	Thread_PaddedAtomic64_t tail;
+	uint64_t mask;
+	PoolQueueSlot *slots;
+} PoolQueue;
+
+// Chase-Lev deque, the owner pushes and takes at the bottom, thieves steal from the top
+typedef struct PoolDequeSlot {
+	Thread_AtomicPtr_t func;
+	Thread_AtomicPtr_t data;
+} PoolDequeSlot;
+
+typedef struct PoolDeque {
+	Thread_PaddedAtomic64_t top;
+	Thread_PaddedAtomic64_t bottom;
+	PoolDequeSlot slots[POOL_DEQUE_CAPACITY];
+} PoolDeque;
+
+// workers are split into the reserved high priority group and the general group,
+// each with its own searcher count so a wake always goes to someone who can run the job
+typedef struct PoolGroup {
+	Thread_PaddedAtomic32_t searching;
+	uint32_t first;
+	uint32_t count;
+	uint32_t laneCount; // lanes this group runs, highest priority first
+	uint32_t minWorkers;
+} PoolGroup;
+
+typedef enum PoolWorkerState {
+	POOL_WORKER_BUSY,     // running a job
+	POOL_WORKER_STEALING, // out of work, polling the queues and stealing
+	POOL_WORKER_IDLE,     // parked
+	POOL_WORKER_STOPPED,  // no thread, not timed
+} PoolWorkerState;
+
+// only the worker writes these. The time split changes together so it sits
+// behind a sequence count, odd while the worker is writing, that readers retry on
+typedef struct PoolWorkerStats {
+	Thread_Atomic32_t sequence;
+	Thread_Atomic32_t state;
+	Thread_Atomic64_t since;
+	Thread_Atomic64_t stateNs[POOL_WORKER_STOPPED];
+	Thread_Atomic64_t jobs;
+	Thread_Atomic64_t stealAttempts;
+	Thread_Atomic64_t steals;
+	Thread_Atomic64_t osThreadId;
+} PoolWorkerStats;
+
+typedef struct PoolWorker {
+	PoolDeque deques[Thread_POOL_PRIORITY_COUNT];
+	Thread_PaddedAtomic32_t wake;
+	Thread_Atomic32_t alive;
+	struct Thread_Pool *pool;
+	PoolGroup *group;
+	uint32_t index;
+	uint32_t stealSeed;
+	uint32_t sinceAged;
+	uint32_t agedTurns;
+	bool joinPending; // guarded by spawnMutex
+	Thread_Thread thread;
+	PoolWorkerStats stats;
+} Thread_CACHE_LINE_ALIGN PoolWorker;
+
+typedef struct Thread_Pool {
+	uint32_t maxWorkers;
+	uint32_t spinRounds;
+	uint32_t retireMs;
+	uint32_t agingInterval;
+	PoolQueue queues[Thread_POOL_PRIORITY_COUNT];
+	// a submit only wakes someone when the group has no searcher
+	PoolGroup groups[POOL_GROUP_COUNT];
+	Thread_PaddedAtomic32_t liveWorkers;
+	// 1 + highest worker index ever started, bounds the steal and work scans
+	Thread_PaddedAtomic32_t highWater;
+	Thread_PaddedAtomic32_t shutdown;
+	// one bit per parked worker that nobody has claimed to wake yet
+	Thread_Atomic64_t idle[POOL_MAX_WORKERS / 64];
+	Thread_Mutex spawnMutex;
+	PoolWorker *workers;
+} Thread_Pool;
+
+typedef enum PoolParkResult {
+	POOL_PARK_RESUMED, // found work before sleeping
+	POOL_PARK_WOKEN,   // claimed and woken, counted as searching
+	POOL_PARK_RETIRE,  // parked too long, the thread should exit
+} PoolParkResult;
+
+typedef enum PoolStealResult {
+	POOL_STEAL_EMPTY,
+	POOL_STEAL_LOST, // another thief or the owner got it
+	POOL_STEAL_WON,
+} PoolStealResult;
+
+static Thread_THREAD_LOCAL PoolWorker *s_currentWorker;
+
+static void PoolWorkerMain(void *param);
+
+static uint32_t PoolCtz64(uint64_t value) {
+#if AL2O3_COMPILER == AL2O3_COMPILER_MSVC
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return (uint32_t) index;
+#else
+	return (uint32_t) __builtin_ctzll(value);
+#endif
+}
+
+static uint32_t PoolRoundUpPow2(uint32_t value) {
+	uint32_t result = 2;
+	while (result < value) {
+		result <<= 1;
+	}
+	return result;
+}
+
+static bool PoolQueueCreate(PoolQueue *queue, uint32_t capacity) {
+	queue->slots = (PoolQueueSlot *) MEMORY_AALLOC(sizeof(PoolQueueSlot) * capacity, Thread_CACHE_LINE_SIZE);
+	if (!queue->slots) {
+		return false;
+	}
+	for (uint32_t i = 0; i < capacity; ++i) {
+		Thread_AtomicStore64Explicit(&queue->slots[i].sequence, i, Thread_ATOMIC_RELAXED);
+	}
+	queue->mask = capacity - 1;
+	Thread_AtomicStore64Explicit(&queue->head.value, 0, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore64Explicit(&queue->tail.value, 0, Thread_ATOMIC_RELAXED);
+	return true;
+}
+
+static bool PoolQueuePush(PoolQueue *queue, PoolJob job) {
+	uint64_t pos = Thread_AtomicLoad64Explicit(&queue->tail.value, Thread_ATOMIC_RELAXED);
+	for (;;) {
+		PoolQueueSlot *slot = &queue->slots[pos & queue->mask];
+		int64_t const diff = (int64_t) (Thread_AtomicLoad64Explicit(&slot->sequence, Thread_ATOMIC_ACQUIRE) - pos);
+		if (diff == 0) {
+			if (Thread_AtomicCompareExchangeWeak64Explicit(&queue->tail.value, &pos, pos + 1,
+																										 Thread_ATOMIC_RELAXED, Thread_ATOMIC_RELAXED)) {
+				slot->job = job;
+				Thread_AtomicStore64Explicit(&slot->sequence, pos + 1, Thread_ATOMIC_RELEASE);
+				return true;
+			}
+		} else if (diff < 0) {
+			return false;
+		} else {
+			pos = Thread_AtomicLoad64Explicit(&queue->tail.value, Thread_ATOMIC_RELAXED);
+		}
+	}
+}
+
+static bool PoolQueuePop(PoolQueue *queue, PoolJob *job) {
+	uint64_t pos = Thread_AtomicLoad64Explicit(&queue->head.value, Thread_ATOMIC_RELAXED);
+	for (;;) {
+		PoolQueueSlot *slot = &queue->slots[pos & queue->mask];
+		int64_t const diff = (int64_t) (Thread_AtomicLoad64Explicit(&slot->sequence, Thread_ATOMIC_ACQUIRE) - (pos + 1));
+		if (diff == 0) {
+			if (Thread_AtomicCompareExchangeWeak64Explicit(&queue->head.value, &pos, pos + 1,
+																										 Thread_ATOMIC_RELAXED, Thread_ATOMIC_RELAXED)) {
+				*job = slot->job;
+				Thread_AtomicStore64Explicit(&slot->sequence, pos + queue->mask + 1, Thread_ATOMIC_RELEASE);
+				return true;
+			}
+		} else if (diff < 0) {
+			return false;
+		} else {
+			pos = Thread_AtomicLoad64Explicit(&queue->head.value, Thread_ATOMIC_RELAXED);
+		}
+	}
+}
+
+static uint32_t PoolQueueDepth(PoolQueue *queue) {
+	uint64_t const head = Thread_AtomicLoad64Explicit(&queue->head.value, Thread_ATOMIC_SEQ_CST);
+	uint64_t const tail = Thread_AtomicLoad64Explicit(&queue->tail.value, Thread_ATOMIC_SEQ_CST);
+	return tail > head ? (uint32_t) (tail - head) : 0;
+}
+
+static bool PoolDequePush(PoolDeque *deque, PoolJob job) {
+	int64_t const bottom = (int64_t) Thread_AtomicLoad64Explicit(&deque->bottom.value, Thread_ATOMIC_RELAXED);
+	int64_t const top = (int64_t) Thread_AtomicLoad64Explicit(&deque->top.value, Thread_ATOMIC_ACQUIRE);
+	if (bottom - top >= POOL_DEQUE_CAPACITY) {
+		return false;
+	}
+	PoolDequeSlot *slot = &deque->slots[bottom & (POOL_DEQUE_CAPACITY - 1)];
+	Thread_AtomicStorePtrExplicit(&slot->func, (void *) job.func, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStorePtrExplicit(&slot->data, job.data, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore64Explicit(&deque->bottom.value, (uint64_t) (bottom + 1), Thread_ATOMIC_RELEASE);
+	return true;
+}
+
+static void PoolDequeRead(PoolDeque *deque, int64_t index, PoolJob *job) {
+	PoolDequeSlot *slot = &deque->slots[index & (POOL_DEQUE_CAPACITY - 1)];
+	job->func = (Thread_JobFunction) Thread_AtomicLoadPtrExplicit(&slot->func, Thread_ATOMIC_RELAXED);
+	job->data = Thread_AtomicLoadPtrExplicit(&slot->data, Thread_ATOMIC_RELAXED);
+}
+
+static bool PoolDequeTake(PoolDeque *deque, PoolJob *job) {
+	int64_t const bottom = (int64_t) Thread_AtomicLoad64Explicit(&deque->bottom.value, Thread_ATOMIC_RELAXED) - 1;
+	Thread_AtomicStore64Explicit(&deque->bottom.value, (uint64_t) bottom, Thread_ATOMIC_RELAXED);
+	Thread_AtomicThreadFenceExplicit(Thread_ATOMIC_SEQ_CST);
+	uint64_t top = Thread_AtomicLoad64Explicit(&deque->top.value, Thread_ATOMIC_RELAXED);
+	if ((int64_t) top > bottom) {
+		Thread_AtomicStore64Explicit(&deque->bottom.value, (uint64_t) (bottom + 1), Thread_ATOMIC_RELAXED);
+		return false;
+	}
+	PoolDequeRead(deque, bottom, job);
+	if ((int64_t) top != bottom) {
+		return true;
+	}
+	// last item, race any thief for it
+	bool const won = Thread_AtomicCompareExchangeStrong64Explicit(&deque->top.value, &top, top + 1,
+																																 Thread_ATOMIC_SEQ_CST, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore64Explicit(&deque->bottom.value, (uint64_t) (bottom + 1), Thread_ATOMIC_RELAXED);
+	return won;
+}
+
+static PoolStealResult PoolDequeSteal(PoolDeque *deque, PoolJob *job) {
+	uint64_t top = Thread_AtomicLoad64Explicit(&deque->top.value, Thread_ATOMIC_ACQUIRE);
+	Thread_AtomicThreadFenceExplicit(Thread_ATOMIC_SEQ_CST);
+	int64_t const bottom = (int64_t) Thread_AtomicLoad64Explicit(&deque->bottom.value, Thread_ATOMIC_ACQUIRE);
+	if ((int64_t) top >= bottom) {
+		return POOL_STEAL_EMPTY;
+	}
+	// a torn read here means the slot was reused and the CAS below fails
+	PoolDequeRead(deque, (int64_t) top, job);
+	return Thread_AtomicCompareExchangeStrong64Explicit(&deque->top.value, &top, top + 1,
+																											Thread_ATOMIC_SEQ_CST, Thread_ATOMIC_RELAXED) ?
+			POOL_STEAL_WON : POOL_STEAL_LOST;
+}
+
+static uint32_t PoolDequeDepth(PoolDeque *deque) {
+	int64_t const top = (int64_t) Thread_AtomicLoad64Explicit(&deque->top.value, Thread_ATOMIC_SEQ_CST);
+	int64_t const bottom = (int64_t) Thread_AtomicLoad64Explicit(&deque->bottom.value, Thread_ATOMIC_SEQ_CST);
+	return bottom > top ? (uint32_t) (bottom - top) : 0;
+}
+
+// owner only, so a plain load and store instead of a locked add
+static void PoolStatsAdd(Thread_Atomic64_t *counter, uint64_t amount) {
+	Thread_AtomicStore64Explicit(counter, Thread_AtomicLoad64Explicit(counter, Thread_ATOMIC_RELAXED) + amount,
+															 Thread_ATOMIC_RELAXED);
+}
+
+// the clock is only read on an actual change, a worker running job after job never calls it
+static void PoolStatsEnter(PoolWorker *worker, PoolWorkerState state) {
+	PoolWorkerStats *stats = &worker->stats;
+	uint32_t const current = Thread_AtomicLoad32Explicit(&stats->state, Thread_ATOMIC_RELAXED);
+	if (current == (uint32_t) state) {
+		return;
+	}
+	uint64_t const now = Thread_MonotonicNs();
+	uint32_t const sequence = Thread_AtomicLoad32Explicit(&stats->sequence, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&stats->sequence, sequence + 1, Thread_ATOMIC_RELAXED);
+	Thread_AtomicThreadFenceExplicit(Thread_ATOMIC_RELEASE);
+	if (current != POOL_WORKER_STOPPED) {
+		PoolStatsAdd(&stats->stateNs[current], now - Thread_AtomicLoad64Explicit(&stats->since, Thread_ATOMIC_RELAXED));
+	}
+	Thread_AtomicStore64Explicit(&stats->since, now, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&stats->state, state, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&stats->sequence, sequence + 2, Thread_ATOMIC_RELEASE);
+}
+
+static bool PoolHasWork(Thread_Pool *pool, PoolGroup *group) {
+	uint32_t const count = Thread_AtomicLoad32Explicit(&pool->highWater.value, Thread_ATOMIC_ACQUIRE);
+	for (uint32_t lane = 0; lane < group->laneCount; ++lane) {
+		if (PoolQueueDepth(&pool->queues[lane])) {
+			return true;
+		}
+		for (uint32_t i = 0; i < count; ++i) {
+			if (PoolDequeDepth(&pool->workers[i].deques[lane])) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+static bool PoolSteal(Thread_Pool *pool, PoolWorker *worker, uint32_t lane, PoolJob *job) {
+	uint32_t const count = Thread_AtomicLoad32Explicit(&pool->highWater.value, Thread_ATOMIC_ACQUIRE);
+	if (count < 2) {
+		return false;
+	}
+	// xorshift so thieves don't all start on the same victim
+	uint32_t seed = worker->stealSeed;
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	worker->stealSeed = seed;
+	uint32_t const start = seed % count;
+	// only victims that had work count as attempts, so the success rate
+	// measures contention rather than how often the pool was empty
+	uint32_t attempts = 0;
+	PoolStealResult result = POOL_STEAL_EMPTY;
+	for (uint32_t i = 0; i < count && result != POOL_STEAL_WON; ++i) {
+		PoolWorker *victim = &pool->workers[(start + i) % count];
+		if (victim != worker) {
+			result = PoolDequeSteal(&victim->deques[lane], job);
+			attempts += result != POOL_STEAL_EMPTY;
+		}
+	}
+	if (attempts) {
+		PoolStatsAdd(&worker->stats.stealAttempts, attempts);
+	}
+	if (result != POOL_STEAL_WON) {
+		return false;
+	}
+	PoolStatsAdd(&worker->stats.steals, 1);
+	return true;
+}
+
+static bool PoolFindWorkInLane(Thread_Pool *pool, PoolWorker *worker, uint32_t lane, PoolJob *job) {
+	return PoolDequeTake(&worker->deques[lane], job) ||
+			PoolQueuePop(&pool->queues[lane], job) ||
+			PoolSteal(pool, worker, lane, job);
+}
+
+// lanes are strictly highest first, except every agingInterval jobs a worker
+// starts from one of the lower lanes in turn so background work still progresses
+static bool PoolFindWork(Thread_Pool *pool, PoolWorker *worker, PoolJob *job) {
+	uint32_t const laneCount = worker->group->laneCount;
+	uint32_t start = 0;
+	if (laneCount > 1 && worker->sinceAged >= pool->agingInterval) {
+		start = 1 + worker->agedTurns % (laneCount - 1);
+	}
+	for (uint32_t i = 0; i < laneCount; ++i) {
+		if (PoolFindWorkInLane(pool, worker, (start + i) % laneCount, job)) {
+			if (start) {
+				worker->sinceAged = 0;
+				worker->agedTurns++;
+			} else {
+				worker->sinceAged++;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+static void PoolIdleSet(Thread_Pool *pool, uint32_t index) {
+	Thread_AtomicFetchOr64Explicit(&pool->idle[index / 64], 1ull << (index % 64), Thread_ATOMIC_SEQ_CST);
+}
+
+// true if the caller cleared the bit, so owns waking (or not parking) that worker
+static bool PoolIdleClear(Thread_Pool *pool, uint32_t index) {
+	uint64_t const bit = 1ull << (index % 64);
+	return (Thread_AtomicFetchAnd64Explicit(&pool->idle[index / 64], ~bit, Thread_ATOMIC_SEQ_CST) & bit) != 0;
+}
+
+// idle bits of workers [first, first + count)
+static uint64_t PoolIdleBits(Thread_Pool *pool, uint32_t word, uint32_t first, uint32_t count) {
+	uint64_t bits = Thread_AtomicLoad64Explicit(&pool->idle[word], Thread_ATOMIC_SEQ_CST);
+	uint32_t const wordFirst = word * 64;
+	if (first > wordFirst) {
+		bits &= ~0ull << (first - wordFirst);
+	}
+	if (first + count < wordFirst + 64) {
+		bits &= ~(~0ull << (first + count - wordFirst));
+	}
+	return bits;
+}
+
+static PoolWorker *PoolIdleClaim(Thread_Pool *pool, uint32_t first, uint32_t count) {
+	if (count == 0) {
+		return NULL;
+	}
+	for (uint32_t i = first / 64; i <= (first + count - 1) / 64; ++i) {
+		uint64_t bits = PoolIdleBits(pool, i, first, count);
+		while (bits) {
+			uint32_t const index = i * 64 + PoolCtz64(bits);
+			if (PoolIdleClear(pool, index)) {
+				return &pool->workers[index];
+			}
+			bits = PoolIdleBits(pool, i, first, count);
+		}
+	}
+	return NULL;
+}
+
+static void PoolWorkerNotify(PoolWorker *worker) {
+	Thread_AtomicStore32Explicit(&worker->wake.value, 1, Thread_ATOMIC_RELEASE);
+	Thread_FutexWakeOne(&worker->wake.value);
+}
+
+static bool PoolSpawnWorker(Thread_Pool *pool, PoolGroup *group) {
+	bool spawned = false;
+	Thread_MutexAcquire(&pool->spawnMutex);
+	if (!Thread_AtomicLoad32Explicit(&pool->shutdown.value, Thread_ATOMIC_RELAXED)) {
+		for (uint32_t i = group->first; i < group->first + group->count; ++i) {
+			PoolWorker *worker = &pool->workers[i];
+			// a retiring worker can take its slot back, whoever sets alive first has it
+			uint32_t expected = 0;
+			if (!Thread_AtomicCompareExchangeStrong32Explicit(&worker->alive, &expected, 1,
+																												Thread_ATOMIC_SEQ_CST, Thread_ATOMIC_RELAXED)) {
+				continue;
+			}
+			// a retired worker's thread has finished or is about to
+			if (worker->joinPending) {
+				Thread_ThreadDestroy(&worker->thread);
+				worker->joinPending = false;
+			}
+			Thread_AtomicFetchAdd32Explicit(&pool->liveWorkers.value, 1, Thread_ATOMIC_RELAXED);
+			Thread_AtomicFetchMax32Explicit(&pool->highWater.value, i + 1, Thread_ATOMIC_RELEASE);
+			if (Thread_ThreadCreate(&worker->thread, &PoolWorkerMain, worker)) {
+				worker->joinPending = true;
+				spawned = true;
+			} else {
+				Thread_AtomicFetchSub32Explicit(&pool->liveWorkers.value, 1, Thread_ATOMIC_RELAXED);
+				Thread_AtomicStore32Explicit(&worker->alive, 0, Thread_ATOMIC_RELAXED);
+			}
+			break;
+		}
+	}
+	Thread_MutexRelease(&pool->spawnMutex);
+	return spawned;
+}
+
+// makes sure one worker of the group is searching, by waking a parked one or
+// starting a new one. Returns false if the whole group is busy
+static bool PoolWakeOne(Thread_Pool *pool, PoolGroup *group) {
+	if (group->count == 0) {
+		return false;
+	}
+	// a plain load first keeps submits from writing the shared line while someone searches
+	if (Thread_AtomicLoad32Explicit(&group->searching.value, Thread_ATOMIC_SEQ_CST) != 0) {
+		return true;
+	}
+	uint32_t expected = 0;
+	if (!Thread_AtomicCompareExchangeStrong32Explicit(&group->searching.value, &expected, 1,
+																										Thread_ATOMIC_SEQ_CST, Thread_ATOMIC_RELAXED)) {
+		return true;
+	}
+	PoolWorker *worker = PoolIdleClaim(pool, group->first, group->count);
+	if (worker) {
+		PoolWorkerNotify(worker);
+		return true;
+	}
+	if (PoolSpawnWorker(pool, group)) {
+		return true;
+	}
+	// everyone is busy, they will find the work when they finish
+	Thread_AtomicFetchSub32Explicit(&group->searching.value, 1, Thread_ATOMIC_SEQ_CST);
+	return false;
+}
+
+// high priority work goes to the reserved workers first, any general worker also takes it
+static void PoolWakeForLane(Thread_Pool *pool, uint32_t lane) {
+	if (lane != Thread_POOL_PRIORITY_HIGH || !PoolWakeOne(pool, &pool->groups[POOL_GROUP_RESERVED])) {
+		PoolWakeOne(pool, &pool->groups[POOL_GROUP_GENERAL]);
+	}
+}
+
+static void PoolStopSearching(Thread_Pool *pool, PoolGroup *group) {
+	// the last searcher to find work hands the search on if more is queued,
+	// this is how the active worker count grows with queue depth
+	if (Thread_AtomicFetchSub32Explicit(&group->searching.value, 1, Thread_ATOMIC_SEQ_CST) == 1 &&
+			PoolHasWork(pool, group)) {
+		if (group == &pool->groups[POOL_GROUP_GENERAL] || !PoolWakeOne(pool, group)) {
+			PoolWakeOne(pool, &pool->groups[POOL_GROUP_GENERAL]);
+		}
+	}
+}
+
+static bool PoolSpin(Thread_Pool *pool, PoolWorker *worker, PoolJob *job) {
+	for (uint32_t round = 0; round < pool->spinRounds; ++round) {
+		for (uint32_t i = 0; i < POOL_PAUSES_PER_ROUND; ++i) {
+			Thread_AtomicPause();
+		}
+		if (PoolFindWork(pool, worker, job)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static PoolParkResult PoolPark(Thread_Pool *pool, PoolWorker *worker) {
+	Thread_AtomicStore32Explicit(&worker->wake.value, 0, Thread_ATOMIC_RELAXED);
+	PoolIdleSet(pool, worker->index);
+	// a submit that ran before our idle bit was visible must be seen here
+	if ((PoolHasWork(pool, worker->group) || Thread_AtomicLoad32Explicit(&pool->shutdown.value, Thread_ATOMIC_SEQ_CST)) &&
+			PoolIdleClear(pool, worker->index)) {
+		return POOL_PARK_RESUMED;
+	}
+
+	uint64_t timeoutNs = worker->index - worker->group->first < worker->group->minWorkers ?
+			Thread_FUTEX_WAIT_INFINITE : (uint64_t) pool->retireMs * 1000000ull;
+	while (Thread_AtomicLoad32Explicit(&worker->wake.value, Thread_ATOMIC_ACQUIRE) == 0) {
+		if (!Thread_FutexWait(&worker->wake.value, 0, timeoutNs) && timeoutNs != Thread_FUTEX_WAIT_INFINITE) {
+			if (PoolIdleClear(pool, worker->index)) {
+				return POOL_PARK_RETIRE;
+			}
+			// claimed just as we timed out, the wake is on its way
+			timeoutNs = Thread_FUTEX_WAIT_INFINITE;
+		}
+	}
+	return POOL_PARK_WOKEN;
+}
+
+// gives the slot up then looks once more for work. A submit between our idle bit
+// clearing and alive dropping found nobody to wake and no free slot to spawn into,
+// so either its spawn now sees the slot free or we see its job and take the slot
+// back. Returns false if the worker has its slot back and should carry on
+static bool PoolRetire(Thread_Pool *pool, PoolWorker *worker) {
+	PoolStatsEnter(worker, POOL_WORKER_STOPPED);
+	s_currentWorker = NULL;
+	Thread_AtomicFetchSub32Explicit(&pool->liveWorkers.value, 1, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&worker->alive, 0, Thread_ATOMIC_SEQ_CST);
+	if (!PoolHasWork(pool, worker->group)) {
+		return true;
+	}
+	// a spawn that got the slot first joins this thread and starts another
+	uint32_t expected = 0;
+	if (!Thread_AtomicCompareExchangeStrong32Explicit(&worker->alive, &expected, 1,
+																										Thread_ATOMIC_SEQ_CST, Thread_ATOMIC_RELAXED)) {
+		return true;
+	}
+	Thread_AtomicFetchAdd32Explicit(&pool->liveWorkers.value, 1, Thread_ATOMIC_RELAXED);
+	s_currentWorker = worker;
+	return false;
+}
+
+static void PoolWorkerMain(void *param) {
+	PoolWorker *worker = (PoolWorker *) param;
+	Thread_Pool *pool = worker->pool;
+	PoolGroup *group = worker->group;
+	s_currentWorker = worker;
+	Thread_AtomicStore64Explicit(&worker->stats.osThreadId, Thread_StatsCurrentOSThreadID(), Thread_ATOMIC_RELAXED);
+	PoolStatsEnter(worker, POOL_WORKER_STEALING);
+
+	// whoever started us counted us as searching
+	bool searching = true;
+	for (;;) {
+		PoolJob job;
+		if (!PoolFindWork(pool, worker, &job)) {
+			PoolStatsEnter(worker, POOL_WORKER_STEALING);
+			if (!searching) {
+				searching = true;
+				Thread_AtomicFetchAdd32Explicit(&group->searching.value, 1, Thread_ATOMIC_SEQ_CST);
+			}
+			if (!PoolSpin(pool, worker, &job)) {
+				searching = false;
+				Thread_AtomicFetchSub32Explicit(&group->searching.value, 1, Thread_ATOMIC_SEQ_CST);
+				// pairs with the fence in submit, either it saw searching drop or we see its job
+				if (PoolHasWork(pool, group)) {
+					continue;
+				}
+				if (Thread_AtomicLoad32Explicit(&pool->shutdown.value, Thread_ATOMIC_SEQ_CST)) {
+					break;
+				}
+				PoolStatsEnter(worker, POOL_WORKER_IDLE);
+				PoolParkResult const result = PoolPark(pool, worker);
+				if (result == POOL_PARK_RETIRE) {
+					if (PoolRetire(pool, worker)) {
+						return;
+					}
+					// back like a newly started worker, counted as searching
+					searching = true;
+					Thread_AtomicFetchAdd32Explicit(&group->searching.value, 1, Thread_ATOMIC_SEQ_CST);
+					continue;
+				}
+				PoolStatsEnter(worker, POOL_WORKER_STEALING);
+				searching = result == POOL_PARK_WOKEN;
+				continue;
+			}
+		}
+		if (searching) {
+			searching = false;
+			PoolStopSearching(pool, group);
+		}
+		PoolStatsEnter(worker, POOL_WORKER_BUSY);
+		job.func(job.data);
+		PoolStatsAdd(&worker->stats.jobs, 1);
+	}
+
+	PoolStatsEnter(worker, POOL_WORKER_STOPPED);
+	s_currentWorker = NULL;
+	Thread_AtomicFetchSub32Explicit(&pool->liveWorkers.value, 1, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&worker->alive, 0, Thread_ATOMIC_RELEASE);
+}
+
+static void PoolFreeQueues(Thread_Pool *pool) {
+	for (uint32_t lane = 0; lane < Thread_POOL_PRIORITY_COUNT; ++lane) {
+		MEMORY_FREE(pool->queues[lane].slots);
+	}
+}
+
+AL2O3_EXTERN_C Thread_PoolHandle Thread_PoolCreate(Thread_PoolDesc const *desc) {
+	Thread_PoolDesc config;
+	memset(&config, 0, sizeof(config));
+	if (desc) {
+		config = *desc;
+	}
+
+	uint32_t const usable = Thread_CPUUsableCoreCount();
+	uint32_t maxWorkers = (config.maxWorkers && config.maxWorkers < usable) ? config.maxWorkers : usable;
+	maxWorkers = maxWorkers > POOL_MAX_WORKERS ? POOL_MAX_WORKERS : maxWorkers;
+	maxWorkers = maxWorkers ? maxWorkers : 1;
+	// at least one general worker is always left for the other lanes
+	uint32_t const reserved = config.reservedHighWorkers < maxWorkers ? config.reservedHighWorkers : maxWorkers - 1;
+
+	Thread_Pool *pool = (Thread_Pool *) MEMORY_AALLOC(sizeof(Thread_Pool), Thread_CACHE_LINE_SIZE);
+	if (!pool) {
+		return NULL;
+	}
+	memset(pool, 0, sizeof(Thread_Pool));
+	pool->maxWorkers = maxWorkers;
+	// spinning on a single core only delays whoever would produce the work
+	pool->spinRounds = config.spinRounds ? config.spinRounds : (usable > 1 ? POOL_DEFAULT_SPIN_ROUNDS : 0);
+	pool->retireMs = config.retireMs ? config.retireMs : POOL_DEFAULT_RETIRE_MS;
+	pool->agingInterval = config.agingInterval ? config.agingInterval : POOL_DEFAULT_AGING_INTERVAL;
+
+	// reserved workers are started by create and never retired, so the high lane never waits on a thread start
+	PoolGroup *group = &pool->groups[POOL_GROUP_RESERVED];
+	group->first = 0;
+	group->count = reserved;
+	group->laneCount = 1;
+	group->minWorkers = reserved;
+	group = &pool->groups[POOL_GROUP_GENERAL];
+	group->first = reserved;
+	group->count = maxWorkers - reserved;
+	group->laneCount = Thread_POOL_PRIORITY_COUNT;
+	group->minWorkers = config.minWorkers < group->count ? config.minWorkers : group->count;
+
+	uint32_t const capacity = PoolRoundUpPow2(config.queueCapacity ? config.queueCapacity : POOL_DEFAULT_QUEUE_CAPACITY);
+	for (uint32_t lane = 0; lane < Thread_POOL_PRIORITY_COUNT; ++lane) {
+		if (!PoolQueueCreate(&pool->queues[lane], capacity)) {
+			PoolFreeQueues(pool);
+			MEMORY_FREE(pool);
+			return NULL;
+		}
+	}
+
+	pool->workers = (PoolWorker *) MEMORY_AALLOC(sizeof(PoolWorker) * maxWorkers, Thread_CACHE_LINE_SIZE);
+	if (!pool->workers || !Thread_MutexCreate(&pool->spawnMutex)) {
+		MEMORY_FREE(pool->workers);
+		PoolFreeQueues(pool);
+		MEMORY_FREE(pool);
+		return NULL;
+	}
+	memset(pool->workers, 0, sizeof(PoolWorker) * maxWorkers);
+	for (uint32_t i = 0; i < maxWorkers; ++i) {
+		pool->workers[i].pool = pool;
+		pool->workers[i].group = &pool->groups[i < reserved ? POOL_GROUP_RESERVED : POOL_GROUP_GENERAL];
+		pool->workers[i].index = i;
+		pool->workers[i].stealSeed = (i + 1) * 2654435761u;
+		Thread_AtomicStore32Explicit(&pool->workers[i].stats.state, POOL_WORKER_STOPPED, Thread_ATOMIC_RELAXED);
+	}
+
+	// reserved workers start now rather than on the first high priority submit
+	group = &pool->groups[POOL_GROUP_RESERVED];
+	for (uint32_t i = 0; i < reserved; ++i) {
+		// a new worker is counted as searching by whoever starts it
+		Thread_AtomicFetchAdd32Explicit(&group->searching.value, 1, Thread_ATOMIC_SEQ_CST);
+		if (!PoolSpawnWorker(pool, group)) {
+			Thread_AtomicFetchSub32Explicit(&group->searching.value, 1, Thread_ATOMIC_SEQ_CST);
+		}
+	}
+	return pool;
+}
+
+AL2O3_EXTERN_C void Thread_PoolDestroy(Thread_PoolHandle pool) {
+	if (!pool) {
+		return;
+	}
+	ASSERT(!s_currentWorker || s_currentWorker->pool != pool);
+
+	Thread_AtomicStore32Explicit(&pool->shutdown.value, 1, Thread_ATOMIC_SEQ_CST);
+	// any spawn in flight finishes before this returns and none start after
+	Thread_MutexAcquire(&pool->spawnMutex);
+	Thread_MutexRelease(&pool->spawnMutex);
+
+	// parked workers wake up, drain the queues and exit
+	PoolWorker *worker;
+	while ((worker = PoolIdleClaim(pool, 0, pool->maxWorkers))) {
+		Thread_AtomicFetchAdd32Explicit(&worker->group->searching.value, 1, Thread_ATOMIC_SEQ_CST);
+		PoolWorkerNotify(worker);
+	}
+	for (uint32_t i = 0; i < pool->maxWorkers; ++i) {
+		if (pool->workers[i].joinPending) {
+			Thread_ThreadDestroy(&pool->workers[i].thread);
+		}
+	}
+
+	// only possible if no worker could ever be started
+	PoolJob job;
+	for (uint32_t lane = 0; lane < Thread_POOL_PRIORITY_COUNT; ++lane) {
+		while (PoolQueuePop(&pool->queues[lane], &job)) {
+			job.func(job.data);
+		}
+	}
+
+	Thread_MutexDestroy(&pool->spawnMutex);
+	MEMORY_FREE(pool->workers);
+	PoolFreeQueues(pool);
+	MEMORY_FREE(pool);
+}
+
+AL2O3_EXTERN_C void Thread_PoolSubmit(Thread_PoolHandle pool, Thread_JobFunction func, void *data) {
+	Thread_PoolSubmitPriority(pool, Thread_POOL_PRIORITY_NORMAL, func, data);
+}
+
+AL2O3_EXTERN_C void Thread_PoolSubmitPriority(Thread_PoolHandle pool, Thread_PoolPriority priority,
+																							Thread_JobFunction func, void *data) {
+	ASSERT(pool);
+	ASSERT(func);
+	ASSERT(priority < Thread_POOL_PRIORITY_COUNT);
+	PoolJob const job = {func, data};
+	PoolWorker *worker = s_currentWorker;
+	bool const queued = (worker && worker->pool == pool && PoolDequePush(&worker->deques[priority], job)) ||
+			PoolQueuePush(&pool->queues[priority], job);
+	if (!queued) {
+		func(data);
+		return;
+	}
+	Thread_AtomicThreadFenceExplicit(Thread_ATOMIC_SEQ_CST);
+	PoolWakeForLane(pool, priority);
+}
+
+AL2O3_EXTERN_C uint32_t Thread_PoolMaxWorkerCount(Thread_PoolHandle pool) {
+	ASSERT(pool);
+	return pool->maxWorkers;
+}
+
+AL2O3_EXTERN_C uint32_t Thread_PoolReservedHighWorkerCount(Thread_PoolHandle pool) {
+	ASSERT(pool);
+	return pool->groups[POOL_GROUP_RESERVED].count;
+}
+
+AL2O3_EXTERN_C uint32_t Thread_PoolWorkerCount(Thread_PoolHandle pool) {
+	ASSERT(pool);
+	return Thread_AtomicLoad32Explicit(&pool->liveWorkers.value, Thread_ATOMIC_RELAXED);
+}
+
+AL2O3_EXTERN_C uint32_t Thread_PoolQueueDepth(Thread_PoolHandle pool) {
+	ASSERT(pool);
+	uint32_t depth = 0;
+	uint32_t const count = Thread_AtomicLoad32Explicit(&pool->highWater.value, Thread_ATOMIC_ACQUIRE);
+	for (uint32_t lane = 0; lane < Thread_POOL_PRIORITY_COUNT; ++lane) {
+		depth += PoolQueueDepth(&pool->queues[lane]);
+		for (uint32_t i = 0; i < count; ++i) {
+			depth += PoolDequeDepth(&pool->workers[i].deques[lane]);
+		}
+	}
+	return depth;
+}
+
+AL2O3_EXTERN_C Thread_PoolHandle Thread_PoolGetCurrent(void) {
+	return s_currentWorker ? s_currentWorker->pool : NULL;
+}
+
+AL2O3_EXTERN_C uint32_t Thread_PoolGetWorkerStats(Thread_PoolHandle pool, Thread_PoolWorkerStats *stats, uint32_t maxCount) {
+	ASSERT(pool);
+	ASSERT(stats || maxCount == 0);
+	uint32_t const count = maxCount < pool->maxWorkers ? maxCount : pool->maxWorkers;
+	for (uint32_t i = 0; i < count; ++i) {
+		PoolWorker *worker = &pool->workers[i];
+		PoolWorkerStats *source = &worker->stats;
+		Thread_PoolWorkerStats *out = &stats[i];
+		uint32_t sequence;
+		uint32_t state;
+		uint64_t since;
+		uint64_t stateNs[POOL_WORKER_STOPPED];
+		for (;;) {
+			sequence = Thread_AtomicLoad32Explicit(&source->sequence, Thread_ATOMIC_ACQUIRE);
+			state = Thread_AtomicLoad32Explicit(&source->state, Thread_ATOMIC_RELAXED);
+			since = Thread_AtomicLoad64Explicit(&source->since, Thread_ATOMIC_RELAXED);
+			for (uint32_t j = 0; j < POOL_WORKER_STOPPED; ++j) {
+				stateNs[j] = Thread_AtomicLoad64Explicit(&source->stateNs[j], Thread_ATOMIC_RELAXED);
+			}
+			Thread_AtomicThreadFenceExplicit(Thread_ATOMIC_ACQUIRE);
+			if (!(sequence & 1) && sequence == Thread_AtomicLoad32Explicit(&source->sequence, Thread_ATOMIC_RELAXED)) {
+				break;
+			}
+			Thread_AtomicPause();
+		}
+		// the state in progress counts up to now
+		if (state != POOL_WORKER_STOPPED) {
+			uint64_t const now = Thread_MonotonicNs();
+			stateNs[state] += now > since ? now - since : 0;
+		}
+
+		out->osThreadId = Thread_AtomicLoad64Explicit(&source->osThreadId, Thread_ATOMIC_RELAXED);
+		out->busyNs = stateNs[POOL_WORKER_BUSY];
+		out->stealingNs = stateNs[POOL_WORKER_STEALING];
+		out->idleNs = stateNs[POOL_WORKER_IDLE];
+		out->jobsExecuted = Thread_AtomicLoad64Explicit(&source->jobs, Thread_ATOMIC_RELAXED);
+		out->stealAttempts = Thread_AtomicLoad64Explicit(&source->stealAttempts, Thread_ATOMIC_RELAXED);
+		out->steals = Thread_AtomicLoad64Explicit(&source->steals, Thread_ATOMIC_RELAXED);
+		out->alive = Thread_AtomicLoad32Explicit(&worker->alive, Thread_ATOMIC_RELAXED) != 0;
+	}
+	return pool->maxWorkers;
+}
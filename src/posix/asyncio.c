@@ -0,0 +1,534 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+#include "al2o3_thread/spinlock.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/asyncio.h"
+#include "al2o3_memory/memory.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#define ASYNCIO_HAS_URING 1
+#else
+#define ASYNCIO_HAS_URING 0
+#endif
+
+#define ASYNCIO_DEFAULT_QUEUE_DEPTH 256
+#define ASYNCIO_DEFAULT_FALLBACK_THREADS 4
+// top bit of fallbackQueued, set by destroy
+#define ASYNCIO_FALLBACK_SHUTDOWN 0x80000000u
+
+typedef struct Thread_AsyncIO {
+	Thread_PoolHandle pool;
+	Thread_PoolPriority continuationPriority;
+
+	// blocking fallback, no threads when io_uring is in use
+	uint32_t fallbackThreadCount;
+	Thread_Thread *fallbackThreads;
+	Thread_SpinLock fallbackLock;
+	// under fallbackLock, linked through the requests so it never fills
+	Thread_AsyncIORequest *fallbackHead;
+	Thread_AsyncIORequest *fallbackTail;
+	// requests in the list plus the shutdown bit, idle fallback threads wait on it
+	Thread_PaddedAtomic32_t fallbackQueued;
+
+#if ASYNCIO_HAS_URING
+	int ringFd;
+	void *sqRing;
+	size_t sqRingSize;
+	void *cqRing;
+	size_t cqRingSize;
+	struct io_uring_sqe *sqes;
+	size_t sqesSize;
+
+	// ring words shared with the kernel
+	Thread_Atomic32_t *sqHead;
+	Thread_Atomic32_t *sqTail;
+	uint32_t *sqArray;
+	uint32_t sqMask;
+	uint32_t sqEntries;
+	Thread_Atomic32_t *cqHead;
+	Thread_Atomic32_t *cqTail;
+	struct io_uring_cqe *cqes;
+	uint32_t cqMask;
+	uint32_t cqEntries;
+
+	// the submission ring has a single producer
+	Thread_Mutex submitMutex;
+	// requests in the kernel, kept at or below cqEntries so completions never overflow
+	Thread_PaddedAtomic32_t inflight;
+	Thread_Atomic32_t inflightWaiters;
+	Thread_Atomic32_t shutdown;
+	Thread_Thread reaper;
+#endif
+} Thread_AsyncIO;
+
+static void AsyncIOComplete(Thread_AsyncIO *io, Thread_AsyncIORequest *request, int64_t result) {
+	request->result = result;
+	if (!request->continuation) {
+		return;
+	}
+	if (io->pool) {
+		Thread_PoolSubmitPriority(io->pool, io->continuationPriority, request->continuation, request);
+	} else {
+		request->continuation(request);
+	}
+}
+
+static void AsyncIOBlockingTransfer(Thread_AsyncIORequest *request) {
+	ssize_t result;
+	do {
+		result = request->op == Thread_ASYNCIO_READ ?
+				pread((int) request->file, request->buffer, request->size, (off_t) request->offset) :
+				pwrite((int) request->file, request->buffer, request->size, (off_t) request->offset);
+	} while (result < 0 && errno == EINTR);
+	AsyncIOComplete(request->owner, request, result < 0 ? -(int64_t) errno : (int64_t) result);
+}
+
+// waits for a queued request, NULL once destroy has been called and the queue is empty
+static Thread_AsyncIORequest *AsyncIOFallbackPop(Thread_AsyncIO *io) {
+	uint32_t queued = Thread_AtomicLoad32Explicit(&io->fallbackQueued.value, Thread_ATOMIC_ACQUIRE);
+	for (;;) {
+		if ((queued & ~ASYNCIO_FALLBACK_SHUTDOWN) == 0) {
+			if (queued & ASYNCIO_FALLBACK_SHUTDOWN) {
+				return NULL;
+			}
+			Thread_FutexWait(&io->fallbackQueued.value, queued, Thread_FUTEX_WAIT_INFINITE);
+			queued = Thread_AtomicLoad32Explicit(&io->fallbackQueued.value, Thread_ATOMIC_ACQUIRE);
+			continue;
+		}
+		// the count only goes up after the push, so claiming one means a request is in the list for us
+		if (Thread_AtomicCompareExchangeWeak32Explicit(&io->fallbackQueued.value, &queued, queued - 1,
+																									 Thread_ATOMIC_ACQUIRE, Thread_ATOMIC_ACQUIRE)) {
+			break;
+		}
+	}
+	Thread_SpinLockAcquire(&io->fallbackLock);
+	Thread_AsyncIORequest *request = io->fallbackHead;
+	io->fallbackHead = request->next;
+	if (!io->fallbackHead) {
+		io->fallbackTail = NULL;
+	}
+	Thread_SpinLockRelease(&io->fallbackLock);
+	return request;
+}
+
+static void AsyncIOFallbackThread(void *data) {
+	Thread_AsyncIO *io = (Thread_AsyncIO *) data;
+	Thread_AsyncIORequest *request;
+	while ((request = AsyncIOFallbackPop(io))) {
+		AsyncIOBlockingTransfer(request);
+	}
+}
+
+// the threads spend their time blocked in the kernel, so their count isn't tied to the cores
+static bool AsyncIOFallbackCreate(Thread_AsyncIO *io, uint32_t threadCount) {
+	io->fallbackThreads = (Thread_Thread *) MEMORY_CALLOC(threadCount, sizeof(Thread_Thread));
+	if (!io->fallbackThreads || !Thread_SpinLockCreate(&io->fallbackLock)) {
+		MEMORY_FREE(io->fallbackThreads);
+		return false;
+	}
+	while (io->fallbackThreadCount < threadCount &&
+			Thread_ThreadCreate(&io->fallbackThreads[io->fallbackThreadCount], &AsyncIOFallbackThread, io)) {
+		io->fallbackThreadCount++;
+	}
+	if (io->fallbackThreadCount == 0) {
+		Thread_SpinLockDestroy(&io->fallbackLock);
+		MEMORY_FREE(io->fallbackThreads);
+		return false;
+	}
+	return true;
+}
+
+static void AsyncIOFallbackDestroy(Thread_AsyncIO *io) {
+	// the threads finish everything queued, then see the bit with nothing left and exit
+	Thread_AtomicFetchOr32Explicit(&io->fallbackQueued.value, ASYNCIO_FALLBACK_SHUTDOWN, Thread_ATOMIC_RELEASE);
+	Thread_FutexWakeAll(&io->fallbackQueued.value);
+	for (uint32_t i = 0; i < io->fallbackThreadCount; ++i) {
+		Thread_ThreadDestroy(&io->fallbackThreads[i]);
+	}
+	Thread_SpinLockDestroy(&io->fallbackLock);
+	MEMORY_FREE(io->fallbackThreads);
+}
+
+static void AsyncIOFallbackSubmit(Thread_AsyncIO *io, Thread_AsyncIORequest *const *requests, uint32_t count) {
+	if (count == 0) {
+		return;
+	}
+	for (uint32_t i = 0; i < count; ++i) {
+		requests[i]->next = i + 1 < count ? requests[i + 1] : NULL;
+	}
+	Thread_SpinLockAcquire(&io->fallbackLock);
+	if (io->fallbackTail) {
+		io->fallbackTail->next = requests[0];
+	} else {
+		io->fallbackHead = requests[0];
+	}
+	io->fallbackTail = requests[count - 1];
+	Thread_SpinLockRelease(&io->fallbackLock);
+
+	Thread_AtomicFetchAdd32Explicit(&io->fallbackQueued.value, count, Thread_ATOMIC_RELEASE);
+	if (count == 1) {
+		Thread_FutexWakeOne(&io->fallbackQueued.value);
+	} else {
+		Thread_FutexWakeAll(&io->fallbackQueued.value);
+	}
+}
+
+#if ASYNCIO_HAS_URING
+
+static int AsyncIOEnter(int fd, uint32_t toSubmit, uint32_t minComplete, uint32_t flags) {
+	return (int) syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, NULL, 0);
+}
+
+static void AsyncIOUringFree(Thread_AsyncIO *io) {
+	if (io->sqes) {
+		munmap(io->sqes, io->sqesSize);
+	}
+	if (io->cqRing && io->cqRing != io->sqRing) {
+		munmap(io->cqRing, io->cqRingSize);
+	}
+	if (io->sqRing) {
+		munmap(io->sqRing, io->sqRingSize);
+	}
+	if (io->ringFd >= 0) {
+		close(io->ringFd);
+	}
+	io->ringFd = -1;
+}
+
+static bool AsyncIOUringCreate(Thread_AsyncIO *io, uint32_t queueDepth) {
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	io->ringFd = (int) syscall(__NR_io_uring_setup, queueDepth, &params);
+	if (io->ringFd < 0) {
+		return false;
+	}
+	// plain IORING_OP_READ/WRITE arrived alongside fast poll (5.7)
+	if (!(params.features & IORING_FEAT_FAST_POLL)) {
+		AsyncIOUringFree(io);
+		return false;
+	}
+
+	io->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	io->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		io->sqRingSize = io->cqRingSize > io->sqRingSize ? io->cqRingSize : io->sqRingSize;
+		io->cqRingSize = io->sqRingSize;
+	}
+	io->sqRing = mmap(NULL, io->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, io->ringFd, IORING_OFF_SQ_RING);
+	if (io->sqRing == MAP_FAILED) {
+		io->sqRing = NULL;
+		AsyncIOUringFree(io);
+		return false;
+	}
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		io->cqRing = io->sqRing;
+	} else {
+		io->cqRing = mmap(NULL, io->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, io->ringFd, IORING_OFF_CQ_RING);
+		if (io->cqRing == MAP_FAILED) {
+			io->cqRing = NULL;
+			AsyncIOUringFree(io);
+			return false;
+		}
+	}
+	io->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	io->sqes = (struct io_uring_sqe *) mmap(NULL, io->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, io->ringFd, IORING_OFF_SQES);
+	if (io->sqes == MAP_FAILED) {
+		io->sqes = NULL;
+		AsyncIOUringFree(io);
+		return false;
+	}
+
+	uint8_t *sq = (uint8_t *) io->sqRing;
+	uint8_t *cq = (uint8_t *) io->cqRing;
+	io->sqHead = (Thread_Atomic32_t *) (sq + params.sq_off.head);
+	io->sqTail = (Thread_Atomic32_t *) (sq + params.sq_off.tail);
+	io->sqArray = (uint32_t *) (sq + params.sq_off.array);
+	io->sqMask = *(uint32_t *) (sq + params.sq_off.ring_mask);
+	io->sqEntries = params.sq_entries;
+	io->cqHead = (Thread_Atomic32_t *) (cq + params.cq_off.head);
+	io->cqTail = (Thread_Atomic32_t *) (cq + params.cq_off.tail);
+	io->cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+	io->cqMask = *(uint32_t *) (cq + params.cq_off.ring_mask);
+	io->cqEntries = params.cq_entries;
+	return true;
+}
+
+// hands every queued entry to the kernel, called with submitMutex held.
+// Returns 0 or the errno of a failure that retrying won't clear
+static int AsyncIOFlush(Thread_AsyncIO *io, uint32_t pending) {
+	while (pending) {
+		int const submitted = AsyncIOEnter(io->ringFd, pending, 0, 0);
+		if (submitted < 0) {
+			// EBUSY/EAGAIN clear as the reaper drains completions
+			if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+				return errno;
+			}
+			Thread_Sleep(0);
+			continue;
+		}
+		pending -= (uint32_t) submitted;
+	}
+	return 0;
+}
+
+// takes back every entry the kernel hasn't consumed after a failed flush and
+// returns their requests linked through next. Without SQPOLL the kernel only
+// reads the ring inside enter, so with submitMutex held the tail can move back
+static Thread_AsyncIORequest *AsyncIOUnsubmit(Thread_AsyncIO *io) {
+	uint32_t const head = Thread_AtomicLoad32Explicit(io->sqHead, Thread_ATOMIC_ACQUIRE);
+	uint32_t const tail = Thread_AtomicLoad32Explicit(io->sqTail, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(io->sqTail, head, Thread_ATOMIC_RELEASE);
+	Thread_AsyncIORequest *failed = NULL;
+	for (uint32_t i = tail; i != head; --i) {
+		struct io_uring_sqe *sqe = &io->sqes[io->sqArray[(i - 1) & io->sqMask]];
+		Thread_AsyncIORequest *request = (Thread_AsyncIORequest *) (uintptr_t) sqe->user_data;
+		if (request) {
+			request->next = failed;
+			failed = request;
+		}
+	}
+	Thread_AtomicFetchSub32Explicit(&io->inflight.value, (int32_t) (tail - head), Thread_ATOMIC_SEQ_CST);
+	return failed;
+}
+
+// waits for a completion slot, flushing first so the wait can't be on our own entries.
+// Returns 0 with a slot taken, or the errno of a failed flush without one
+static int AsyncIOReserve(Thread_AsyncIO *io, uint32_t *pending) {
+	for (;;) {
+		uint32_t current = Thread_AtomicLoad32Explicit(&io->inflight.value, Thread_ATOMIC_RELAXED);
+		while (current < io->cqEntries) {
+			if (Thread_AtomicCompareExchangeWeak32Explicit(&io->inflight.value, &current, current + 1,
+																										 Thread_ATOMIC_RELAXED, Thread_ATOMIC_RELAXED)) {
+				return 0;
+			}
+		}
+		int const error = AsyncIOFlush(io, *pending);
+		*pending = 0;
+		if (error) {
+			return error;
+		}
+		Thread_AtomicFetchAdd32Explicit(&io->inflightWaiters, 1, Thread_ATOMIC_SEQ_CST);
+		if (Thread_AtomicLoad32Explicit(&io->inflight.value, Thread_ATOMIC_SEQ_CST) >= io->cqEntries) {
+			Thread_FutexWait(&io->inflight.value, current, Thread_FUTEX_WAIT_INFINITE);
+		}
+		Thread_AtomicFetchSub32Explicit(&io->inflightWaiters, 1, Thread_ATOMIC_SEQ_CST);
+	}
+}
+
+static void AsyncIOPrepare(struct io_uring_sqe *sqe, Thread_AsyncIORequest *request) {
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+	if (!request) {
+		sqe->opcode = IORING_OP_NOP;
+		return;
+	}
+	bool const fixed = request->bufferIndex >= 0;
+	if (request->op == Thread_ASYNCIO_READ) {
+		sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+	} else {
+		sqe->opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+	}
+	sqe->fd = (int32_t) request->file;
+	sqe->off = request->offset;
+	sqe->addr = (uint64_t) (uintptr_t) request->buffer;
+	sqe->len = request->size;
+	sqe->user_data = (uint64_t) (uintptr_t) request;
+	if (fixed) {
+		sqe->buf_index = (uint16_t) request->bufferIndex;
+	}
+}
+
+// a NULL request queues a no-op, used to wake the reaper.
+// If the kernel refuses the entries every request the kernel didn't take
+// completes with the negative errno, after the mutex is released so a
+// continuation can submit again
+static void AsyncIOUringSubmit(Thread_AsyncIO *io, Thread_AsyncIORequest *const *requests, uint32_t count) {
+	Thread_MutexAcquire(&io->submitMutex);
+	uint32_t pending = 0;
+	uint32_t queued = 0;
+	int error = 0;
+	for (; queued < count; ++queued) {
+		error = AsyncIOReserve(io, &pending);
+		if (error) {
+			break;
+		}
+		uint32_t tail = Thread_AtomicLoad32Explicit(io->sqTail, Thread_ATOMIC_RELAXED);
+		if (tail - Thread_AtomicLoad32Explicit(io->sqHead, Thread_ATOMIC_ACQUIRE) == io->sqEntries) {
+			error = AsyncIOFlush(io, pending);
+			pending = 0;
+			if (error) {
+				Thread_AtomicFetchSub32Explicit(&io->inflight.value, 1, Thread_ATOMIC_SEQ_CST);
+				break;
+			}
+		}
+		uint32_t const index = tail & io->sqMask;
+		AsyncIOPrepare(&io->sqes[index], requests ? requests[queued] : NULL);
+		io->sqArray[index] = index;
+		Thread_AtomicStore32Explicit(io->sqTail, tail + 1, Thread_ATOMIC_RELEASE);
+		pending++;
+	}
+	if (!error) {
+		error = AsyncIOFlush(io, pending);
+	}
+	Thread_AsyncIORequest *failed = error ? AsyncIOUnsubmit(io) : NULL;
+	Thread_MutexRelease(&io->submitMutex);
+
+	if (!error) {
+		return;
+	}
+	while (failed) {
+		Thread_AsyncIORequest *request = failed;
+		failed = request->next;
+		AsyncIOComplete(io, request, -(int64_t) error);
+	}
+	for (; requests && queued < count; ++queued) {
+		AsyncIOComplete(io, requests[queued], -(int64_t) error);
+	}
+}
+
+static void AsyncIOReaper(void *data) {
+	Thread_AsyncIO *io = (Thread_AsyncIO *) data;
+	for (;;) {
+		uint32_t head = Thread_AtomicLoad32Explicit(io->cqHead, Thread_ATOMIC_RELAXED);
+		uint32_t const tail = Thread_AtomicLoad32Explicit(io->cqTail, Thread_ATOMIC_ACQUIRE);
+		if (head == tail) {
+			if (Thread_AtomicLoad32Explicit(&io->shutdown, Thread_ATOMIC_ACQUIRE) &&
+					Thread_AtomicLoad32Explicit(&io->inflight.value, Thread_ATOMIC_ACQUIRE) == 0) {
+				break;
+			}
+			AsyncIOEnter(io->ringFd, 0, 1, IORING_ENTER_GETEVENTS);
+			continue;
+		}
+
+		uint32_t const reaped = tail - head;
+		for (; head != tail; ++head) {
+			struct io_uring_cqe *cqe = &io->cqes[head & io->cqMask];
+			Thread_AsyncIORequest *request = (Thread_AsyncIORequest *) (uintptr_t) cqe->user_data;
+			int64_t const result = cqe->res;
+			Thread_AtomicStore32Explicit(io->cqHead, head + 1, Thread_ATOMIC_RELEASE);
+			if (request) {
+				AsyncIOComplete(io, request, result);
+			}
+		}
+		Thread_AtomicFetchSub32Explicit(&io->inflight.value, (int32_t) reaped, Thread_ATOMIC_SEQ_CST);
+		if (Thread_AtomicLoad32Explicit(&io->inflightWaiters, Thread_ATOMIC_SEQ_CST)) {
+			Thread_FutexWakeAll(&io->inflight.value);
+		}
+	}
+}
+
+#endif
+
+AL2O3_EXTERN_C Thread_AsyncIOHandle Thread_AsyncIOCreate(Thread_AsyncIODesc const *desc) {
+	Thread_AsyncIODesc config;
+	memset(&config, 0, sizeof(config));
+	if (desc) {
+		config = *desc;
+	}
+
+	Thread_AsyncIO *io = (Thread_AsyncIO *) MEMORY_AALLOC(sizeof(Thread_AsyncIO), Thread_CACHE_LINE_SIZE);
+	if (!io) {
+		return NULL;
+	}
+	memset(io, 0, sizeof(Thread_AsyncIO));
+	io->pool = config.pool;
+	io->continuationPriority = config.continuationPriority;
+
+#if ASYNCIO_HAS_URING
+	io->ringFd = -1;
+	if (!config.forceFallback &&
+			AsyncIOUringCreate(io, config.queueDepth ? config.queueDepth : ASYNCIO_DEFAULT_QUEUE_DEPTH)) {
+		if (Thread_MutexCreate(&io->submitMutex)) {
+			if (Thread_ThreadCreate(&io->reaper, &AsyncIOReaper, io)) {
+				return io;
+			}
+			Thread_MutexDestroy(&io->submitMutex);
+		}
+		AsyncIOUringFree(io);
+	}
+#endif
+
+	if (!AsyncIOFallbackCreate(io, config.fallbackThreads ? config.fallbackThreads : ASYNCIO_DEFAULT_FALLBACK_THREADS)) {
+		MEMORY_FREE(io);
+		return NULL;
+	}
+	return io;
+}
+
+AL2O3_EXTERN_C void Thread_AsyncIODestroy(Thread_AsyncIOHandle io) {
+	if (!io) {
+		return;
+	}
+	if (io->fallbackThreadCount) {
+		AsyncIOFallbackDestroy(io);
+		MEMORY_FREE(io);
+		return;
+	}
+#if ASYNCIO_HAS_URING
+	// the no-op completion wakes the reaper, which leaves once nothing is in flight
+	Thread_AtomicStore32Explicit(&io->shutdown, 1, Thread_ATOMIC_RELEASE);
+	AsyncIOUringSubmit(io, NULL, 1);
+	Thread_ThreadDestroy(&io->reaper);
+	Thread_MutexDestroy(&io->submitMutex);
+	AsyncIOUringFree(io);
+#endif
+	MEMORY_FREE(io);
+}
+
+AL2O3_EXTERN_C bool Thread_AsyncIOIsUring(Thread_AsyncIOHandle io) {
+	ASSERT(io);
+	return io->fallbackThreadCount == 0;
+}
+
+AL2O3_EXTERN_C bool Thread_AsyncIORegisterBuffers(Thread_AsyncIOHandle io,
+																									void *const *buffers,
+																									size_t const *sizes,
+																									uint32_t count) {
+	ASSERT(io);
+	ASSERT(buffers);
+	ASSERT(sizes);
+	if (io->fallbackThreadCount) {
+		return true;
+	}
+#if ASYNCIO_HAS_URING
+	struct iovec *iovecs = (struct iovec *) MEMORY_MALLOC(sizeof(struct iovec) * count);
+	if (!iovecs) {
+		return false;
+	}
+	for (uint32_t i = 0; i < count; ++i) {
+		iovecs[i].iov_base = buffers[i];
+		iovecs[i].iov_len = sizes[i];
+	}
+	// can fail with ENOMEM if the buffers exceed RLIMIT_MEMLOCK
+	bool const registered = syscall(__NR_io_uring_register, io->ringFd, IORING_REGISTER_BUFFERS, iovecs, count) == 0;
+	MEMORY_FREE(iovecs);
+	return registered;
+#else
+	return false;
+#endif
+}
+
+AL2O3_EXTERN_C void Thread_AsyncIOSubmit(Thread_AsyncIOHandle io, Thread_AsyncIORequest *const *requests, uint32_t count) {
+	ASSERT(io);
+	ASSERT(requests || count == 0);
+	for (uint32_t i = 0; i < count; ++i) {
+		requests[i]->owner = io;
+	}
+	if (io->fallbackThreadCount) {
+		AsyncIOFallbackSubmit(io, requests, count);
+		return;
+	}
+#if ASYNCIO_HAS_URING
+	if (count) {
+		AsyncIOUringSubmit(io, requests, count);
+	}
+#endif
+}
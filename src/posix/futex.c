@@ -0,0 +1,125 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/futex.h"
+#include <errno.h>
+#include <time.h>
+#include <limits.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+AL2O3_EXTERN_C bool Thread_FutexWait(Thread_Atomic32_t *address, uint32_t expected, uint64_t timeoutNs) {
+	ASSERT(address);
+	struct timespec ts;
+	struct timespec *tsp = NULL;
+	if (timeoutNs != Thread_FUTEX_WAIT_INFINITE) {
+		ts.tv_sec = (time_t) (timeoutNs / 1000000000ull);
+		ts.tv_nsec = (long) (timeoutNs % 1000000000ull);
+		tsp = &ts;
+	}
+	// relative timeout for FUTEX_WAIT
+	long const result = syscall(SYS_futex, &address->nonatomic, FUTEX_WAIT_PRIVATE, expected, tsp, NULL, 0);
+	return !(result == -1 && errno == ETIMEDOUT);
+}
+
+AL2O3_EXTERN_C void Thread_FutexWakeOne(Thread_Atomic32_t *address) {
+	ASSERT(address);
+	syscall(SYS_futex, &address->nonatomic, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+AL2O3_EXTERN_C void Thread_FutexWakeAll(Thread_Atomic32_t *address) {
+	ASSERT(address);
+	syscall(SYS_futex, &address->nonatomic, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+#elif defined(__APPLE__)
+
+// the same private but stable interface libc++ uses for std::atomic::wait
+extern int __ulock_wait(uint32_t operation, void *address, uint64_t value, uint32_t timeoutUs);
+extern int __ulock_wake(uint32_t operation, void *address, uint64_t wakeValue);
+#define UL_COMPARE_AND_WAIT 1
+#define ULF_WAKE_ALL 0x00000100
+
+AL2O3_EXTERN_C bool Thread_FutexWait(Thread_Atomic32_t *address, uint32_t expected, uint64_t timeoutNs) {
+	ASSERT(address);
+	uint32_t timeoutUs = 0; // 0 is forever for __ulock_wait
+	if (timeoutNs != Thread_FUTEX_WAIT_INFINITE) {
+		uint64_t const us = (timeoutNs + 999) / 1000;
+		timeoutUs = us == 0 ? 1 : (us > UINT32_MAX ? UINT32_MAX : (uint32_t) us);
+	}
+	int const result = __ulock_wait(UL_COMPARE_AND_WAIT, (void *) &address->nonatomic, expected, timeoutUs);
+	return !(result < 0 && errno == ETIMEDOUT);
+}
+
+AL2O3_EXTERN_C void Thread_FutexWakeOne(Thread_Atomic32_t *address) {
+	ASSERT(address);
+	__ulock_wake(UL_COMPARE_AND_WAIT, (void *) &address->nonatomic, 0);
+}
+
+AL2O3_EXTERN_C void Thread_FutexWakeAll(Thread_Atomic32_t *address) {
+	ASSERT(address);
+	__ulock_wake(UL_COMPARE_AND_WAIT | ULF_WAKE_ALL, (void *) &address->nonatomic, 0);
+}
+
+#else
+
+// no native address wait, park in a hashed table of condition variables
+#include <pthread.h>
+
+#define FUTEX_BUCKET_COUNT 64
+typedef struct FutexBucket {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+} FutexBucket;
+
+static FutexBucket s_futexBuckets[FUTEX_BUCKET_COUNT];
+static pthread_once_t s_futexOnce = PTHREAD_ONCE_INIT;
+
+static void FutexInit(void) {
+	for (uint32_t i = 0; i < FUTEX_BUCKET_COUNT; ++i) {
+		pthread_mutex_init(&s_futexBuckets[i].mutex, NULL);
+		pthread_cond_init(&s_futexBuckets[i].cond, NULL);
+	}
+}
+
+static FutexBucket *FutexBucketOf(Thread_Atomic32_t *address) {
+	pthread_once(&s_futexOnce, &FutexInit);
+	return &s_futexBuckets[((uintptr_t) address >> 2) % FUTEX_BUCKET_COUNT];
+}
+
+AL2O3_EXTERN_C bool Thread_FutexWait(Thread_Atomic32_t *address, uint32_t expected, uint64_t timeoutNs) {
+	ASSERT(address);
+	FutexBucket *bucket = FutexBucketOf(address);
+	bool woken = true;
+	pthread_mutex_lock(&bucket->mutex);
+	if (Thread_AtomicLoad32Explicit(address, Thread_ATOMIC_SEQ_CST) == expected) {
+		if (timeoutNs == Thread_FUTEX_WAIT_INFINITE) {
+			pthread_cond_wait(&bucket->cond, &bucket->mutex);
+		} else {
+			struct timespec ts;
+			clock_gettime(CLOCK_REALTIME, &ts);
+			uint64_t const ns = (uint64_t) ts.tv_nsec + timeoutNs % 1000000000ull;
+			ts.tv_sec += (time_t) (timeoutNs / 1000000000ull + ns / 1000000000ull);
+			ts.tv_nsec = (long) (ns % 1000000000ull);
+			woken = pthread_cond_timedwait(&bucket->cond, &bucket->mutex, &ts) != ETIMEDOUT;
+		}
+	}
+	pthread_mutex_unlock(&bucket->mutex);
+	return woken;
+}
+
+AL2O3_EXTERN_C void Thread_FutexWakeOne(Thread_Atomic32_t *address) {
+	// buckets are shared between addresses so a single wake could go to the wrong waiter
+	Thread_FutexWakeAll(address);
+}
+
+AL2O3_EXTERN_C void Thread_FutexWakeAll(Thread_Atomic32_t *address) {
+	ASSERT(address);
+	FutexBucket *bucket = FutexBucketOf(address);
+	pthread_mutex_lock(&bucket->mutex);
+	pthread_cond_broadcast(&bucket->cond);
+	pthread_mutex_unlock(&bucket->mutex);
+}
+
+#endif
@@ -1,13 +1,31 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// sched_getaffinity, sched_getcpu, RUSAGE_THREAD
+#define _GNU_SOURCE
+#endif
 #include "al2o3_platform/platform.h"
 #include "al2o3_thread/thread.h"
 #include "al2o3_memory/memory.h"
 #include <unistd.h>
-#include <sys/sysctl.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
 #if defined(__linux__)
 #include <sys/sysinfo.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#else
+#include <sys/sysctl.h>
+#endif
+#if defined(__APPLE__)
+#include <mach/mach.h>
 #endif
+#include <sched.h>
 #include <pthread.h>
 #include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+#include "al2o3_thread/stats.h"
 
 AL2O3_EXTERN_C bool Thread_MutexCreate(Thread_Mutex *mutex) {
   ASSERT(mutex);
@@ -58,44 +76,250 @@ AL2O3_EXTERN_C void Thread_ConditionalVariableSet(Thread_ConditionalVariable *cv
   pthread_cond_signal(cv);
 }
 
-struct TrampParam {
-	Thread_JobFunction func;
+struct Thread_ThreadObject {
+  Thread_JobFunction func;
   void *param;
+  // 0 running, 1 finished, 2 finished not yet seen by a waiting joiner
+  Thread_Atomic32_t state;
+  // uncached threads are pthread_joined once, by whichever join clears this
+  Thread_Atomic32_t needsJoin;
+  pthread_t pthread;
 };
 
+// an OS thread that parks in the cache between objects
+typedef struct ThreadCached {
+  Thread_Atomic32_t wake;
+  struct Thread_ThreadObject *object; // next to run, NULL to exit
+  struct ThreadCached *next;
+} ThreadCached;
+
+static pthread_mutex_t s_cacheMutex = PTHREAD_MUTEX_INITIALIZER;
+static ThreadCached *s_cacheHead;
+static uint32_t s_cacheCount;
+static uint32_t s_cacheMax;
+
+// every live OS thread we started, for Thread_StatsGetAll. Nodes live on
+// their thread's stack
+typedef struct ThreadRegistered {
+  struct ThreadRegistered *next;
+  struct ThreadRegistered *prev;
+  pthread_t pthread;
+  uint64_t osThreadId;
+} ThreadRegistered;
+
+static pthread_mutex_t s_registryMutex = PTHREAD_MUTEX_INITIALIZER;
+static ThreadRegistered *s_registryHead;
+static uint32_t s_registryCount;
+
+static void ThreadRegister(ThreadRegistered *self) {
+  self->pthread = pthread_self();
+  self->osThreadId = Thread_StatsCurrentOSThreadID();
+  self->prev = NULL;
+  pthread_mutex_lock(&s_registryMutex);
+  self->next = s_registryHead;
+  if (s_registryHead) {
+    s_registryHead->prev = self;
+  }
+  s_registryHead = self;
+  s_registryCount++;
+  pthread_mutex_unlock(&s_registryMutex);
+}
+
+static void ThreadUnregister(ThreadRegistered *self) {
+  pthread_mutex_lock(&s_registryMutex);
+  if (self->prev) {
+    self->prev->next = self->next;
+  } else {
+    s_registryHead = self->next;
+  }
+  if (self->next) {
+    self->next->prev = self->prev;
+  }
+  s_registryCount--;
+  pthread_mutex_unlock(&s_registryMutex);
+}
+
+static void ThreadObjectRun(struct Thread_ThreadObject *object) {
+  object->func(object->param);
+  // the joiner may free the object as soon as it sees this, a wake on a freed
+  // address is harmless
+  if (Thread_AtomicExchange32Explicit(&object->state, 1, Thread_ATOMIC_ACQ_REL) == 2) {
+    Thread_FutexWakeAll(&object->state);
+  }
+}
+
 static void *FuncTrampoline(void *param) {
-  struct TrampParam *tp = (struct TrampParam *) param;
-  tp->func(tp->param);
-  MEMORY_FREE(tp);
+  ThreadRegistered registered;
+  ThreadRegister(&registered);
+  ThreadObjectRun((struct Thread_ThreadObject *) param);
+  ThreadUnregister(&registered);
+  return NULL;
+}
+
+// parks self in the cache, returns the next object or NULL if the thread should exit
+static struct Thread_ThreadObject *ThreadCacheWait(ThreadCached *self) {
+  Thread_AtomicStore32Explicit(&self->wake, 0, Thread_ATOMIC_RELAXED);
+  self->object = NULL;
+  pthread_mutex_lock(&s_cacheMutex);
+  if (s_cacheCount >= s_cacheMax) {
+    pthread_mutex_unlock(&s_cacheMutex);
+    return NULL;
+  }
+  self->next = s_cacheHead;
+  s_cacheHead = self;
+  s_cacheCount++;
+  pthread_mutex_unlock(&s_cacheMutex);
+
+  while (Thread_AtomicLoad32Explicit(&self->wake, Thread_ATOMIC_ACQUIRE) == 0) {
+    Thread_FutexWait(&self->wake, 0, Thread_FUTEX_WAIT_INFINITE);
+  }
+  return self->object;
+}
+
+static void ThreadCachedWake(ThreadCached *cached, struct Thread_ThreadObject *object) {
+  cached->object = object;
+  Thread_AtomicStore32Explicit(&cached->wake, 1, Thread_ATOMIC_RELEASE);
+  Thread_FutexWakeOne(&cached->wake);
+}
 
+static void *CachedTrampoline(void *param) {
+  ThreadCached *self = (ThreadCached *) param;
+  ThreadRegistered registered;
+  ThreadRegister(&registered);
+  struct Thread_ThreadObject *object = self->object;
+  while (object) {
+    ThreadObjectRun(object);
+    object = ThreadCacheWait(self);
+  }
+  ThreadUnregister(&registered);
+  MEMORY_FREE(self);
   return NULL;
 }
 
 AL2O3_EXTERN_C bool Thread_ThreadCreate(Thread_Thread *thread, Thread_JobFunction func, void *data) {
   ASSERT(thread);
-  struct TrampParam *tp = (struct TrampParam *) MEMORY_MALLOC(sizeof(struct TrampParam));
-  tp->func = func;
-  tp->param = data;
+  struct Thread_ThreadObject *object = (struct Thread_ThreadObject *) MEMORY_CALLOC(1, sizeof(struct Thread_ThreadObject));
+  if (!object) {
+    return false;
+  }
+  object->func = func;
+  object->param = data;
+
+  pthread_mutex_lock(&s_cacheMutex);
+  ThreadCached *cached = s_cacheHead;
+  if (cached) {
+    s_cacheHead = cached->next;
+    s_cacheCount--;
+  }
+  bool const cacheable = s_cacheMax != 0;
+  pthread_mutex_unlock(&s_cacheMutex);
+
+  if (cached) {
+    ThreadCachedWake(cached, object);
+    *thread = object;
+    return true;
+  }
 
-  return pthread_create(thread, NULL, &FuncTrampoline, tp) == 0;
+  bool created;
+  if (cacheable) {
+    cached = (ThreadCached *) MEMORY_CALLOC(1, sizeof(ThreadCached));
+    created = cached != NULL;
+    if (created) {
+      pthread_t pthread;
+      cached->object = object;
+      created = pthread_create(&pthread, NULL, &CachedTrampoline, cached) == 0;
+      if (created) {
+        // nobody joins a cached thread, its handle completion flag does the job
+        pthread_detach(pthread);
+      } else {
+        MEMORY_FREE(cached);
+      }
+    }
+  } else {
+    created = pthread_create(&object->pthread, NULL, &FuncTrampoline, object) == 0;
+    Thread_AtomicStore32Explicit(&object->needsJoin, created, Thread_ATOMIC_RELAXED);
+  }
+
+  if (!created) {
+    MEMORY_FREE(object);
+    *thread = NULL;
+    return false;
+  }
+  *thread = object;
+  return true;
 }
 
 AL2O3_EXTERN_C void Thread_ThreadDestroy(Thread_Thread *thread) {
   ASSERT(thread);
-
-  // should this be detach rather than join?
-  pthread_join(*thread, NULL);
+  if (!*thread) {
+    return;
+  }
+  Thread_ThreadJoin(thread);
+  MEMORY_FREE(*thread);
+  *thread = NULL;
 }
 
 AL2O3_EXTERN_C void Thread_ThreadJoin(Thread_Thread *thread) {
   ASSERT(thread);
-  pthread_join(*thread, NULL);
+  struct Thread_ThreadObject *object = *thread;
+  ASSERT(object);
+  uint32_t state;
+  while ((state = Thread_AtomicLoad32Explicit(&object->state, Thread_ATOMIC_ACQUIRE)) != 1) {
+    if (state == 0 && !Thread_AtomicCompareExchangeStrong32Explicit(&object->state, &state, 2,
+                                                                    Thread_ATOMIC_ACQUIRE, Thread_ATOMIC_ACQUIRE)) {
+      continue;
+    }
+    Thread_FutexWait(&object->state, 2, Thread_FUTEX_WAIT_INFINITE);
+  }
+  // joins can race, joining a pthread twice is undefined so only one of them does
+  uint32_t needsJoin = 1;
+  if (Thread_AtomicCompareExchangeStrong32Explicit(&object->needsJoin, &needsJoin, 0,
+                                                   Thread_ATOMIC_ACQUIRE, Thread_ATOMIC_RELAXED)) {
+    pthread_join(object->pthread, NULL);
+  }
+}
+
+AL2O3_EXTERN_C void Thread_ThreadCacheSetSize(uint32_t maxCachedThreads) {
+  ThreadCached *released = NULL;
+  pthread_mutex_lock(&s_cacheMutex);
+  s_cacheMax = maxCachedThreads;
+  while (s_cacheCount > s_cacheMax) {
+    ThreadCached *cached = s_cacheHead;
+    s_cacheHead = cached->next;
+    s_cacheCount--;
+    cached->next = released;
+    released = cached;
+  }
+  pthread_mutex_unlock(&s_cacheMutex);
+
+  while (released) {
+    ThreadCached *next = released->next;
+    ThreadCachedWake(released, NULL);
+    released = next;
+  }
+}
+
+AL2O3_EXTERN_C uint32_t Thread_ThreadCacheCount(void) {
+  pthread_mutex_lock(&s_cacheMutex);
+  uint32_t const count = s_cacheCount;
+  pthread_mutex_unlock(&s_cacheMutex);
+  return count;
 }
 
 AL2O3_EXTERN_C void Thread_Sleep(uint64_t waitms) {
   usleep((useconds_t) waitms * 1000);
 }
 
+AL2O3_EXTERN_C void Thread_Yield(void) {
+  sched_yield();
+}
+
+AL2O3_EXTERN_C uint64_t Thread_MonotonicNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
 AL2O3_EXTERN_C uint32_t Thread_CPUCoreCount(void) {
 #if defined(__linux__)
  return get_nprocs_conf();
@@ -108,11 +332,25 @@ AL2O3_EXTERN_C uint32_t Thread_CPUCoreCount(void) {
 #endif
 }
 
+AL2O3_EXTERN_C uint32_t Thread_CPUUsableCoreCount(void) {
+#if defined(__linux__)
+  cpu_set_t set;
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    int const count = CPU_COUNT(&set);
+    if (count > 0) {
+      return (uint32_t) count;
+    }
+  }
+#endif
+  return Thread_CPUCoreCount();
+}
+
 static bool s_isMainThreadIDSet = false;
 static Thread_ThreadID s_mainThreadID;
 
 AL2O3_EXTERN_C void Thread_SetMainThread(void) {
-  ASSERT(s_isMainThreadIDSet == false);
+  // calling it again is fine, but the main thread can't change
+  ASSERT(s_isMainThreadIDSet == false || Thread_IsMainThread());
   s_mainThreadID = Thread_GetCurrentThreadID();
   s_isMainThreadIDSet = true;
 }
@@ -125,3 +363,198 @@ AL2O3_EXTERN_C bool Thread_IsMainThread(void) {
   ASSERT(s_isMainThreadIDSet);
   return Thread_GetCurrentThreadID() == s_mainThreadID;
 }
+
+// a set bit is an index owned by a live thread
+static Thread_Atomic64_t s_threadIndexBitmap[Thread_MAX_THREAD_INDICES / 64];
+static Thread_Atomic32_t s_threadIndexOverflow;
+static pthread_key_t s_threadIndexKey;
+static pthread_once_t s_threadIndexOnce = PTHREAD_ONCE_INIT;
+// index + 1 so zero means not assigned yet
+static __thread uint32_t s_threadIndex;
+
+static void ThreadIndexRelease(void *value) {
+  uint32_t const index = (uint32_t) (uintptr_t) value - 1;
+  if (index < Thread_MAX_THREAD_INDICES) {
+    // release so the next owner sees everything written to its per thread slots
+    Thread_AtomicFetchAnd64Explicit(&s_threadIndexBitmap[index / 64], ~(1ull << (index % 64)), Thread_ATOMIC_RELEASE);
+  }
+}
+
+static void ThreadIndexInit(void) {
+  pthread_key_create(&s_threadIndexKey, &ThreadIndexRelease);
+}
+
+static uint32_t ThreadIndexAcquire(void) {
+  for (uint32_t i = 0; i < Thread_MAX_THREAD_INDICES / 64; ++i) {
+    uint64_t bits = Thread_AtomicLoad64Explicit(&s_threadIndexBitmap[i], Thread_ATOMIC_RELAXED);
+    while (bits != ~0ull) {
+      uint32_t const bit = (uint32_t) __builtin_ctzll(~bits);
+      if (Thread_AtomicCompareExchangeWeak64Explicit(&s_threadIndexBitmap[i],
+                                                     &bits,
+                                                     bits | (1ull << bit),
+                                                     Thread_ATOMIC_ACQUIRE,
+                                                     Thread_ATOMIC_RELAXED)) {
+        return i * 64 + bit;
+      }
+    }
+  }
+  // out of unique indices, hand out shared ones past the end
+  return Thread_MAX_THREAD_INDICES + Thread_AtomicFetchAdd32Explicit(&s_threadIndexOverflow, 1, Thread_ATOMIC_RELAXED) % Thread_MAX_THREAD_INDICES;
+}
+
+AL2O3_EXTERN_C uint32_t Thread_GetCurrentThreadIndex(void) {
+  if (s_threadIndex == 0) {
+    pthread_once(&s_threadIndexOnce, &ThreadIndexInit);
+    s_threadIndex = ThreadIndexAcquire() + 1;
+    pthread_setspecific(s_threadIndexKey, (void *) (uintptr_t) s_threadIndex);
+  }
+  return s_threadIndex - 1;
+}
+
+static uint64_t ThreadStatsTimespecNs(struct timespec const *ts) {
+  return (uint64_t) ts->tv_sec * 1000000000ull + (uint64_t) ts->tv_nsec;
+}
+
+#if defined(__linux__)
+static void ThreadStatsProcPath(uint64_t tid, char const *file, char *path, size_t size) {
+  snprintf(path, size, "/proc/self/task/%llu/%s", (unsigned long long) tid, file);
+}
+
+// stat is one bounded line (the name is at most 16 chars) and is generated in one read
+static bool ThreadStatsReadProc(uint64_t tid, char const *file, char *buffer, size_t size) {
+  char path[64];
+  ThreadStatsProcPath(tid, file, path, sizeof(path));
+  int const fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  ssize_t const got = read(fd, buffer, size - 1);
+  close(fd);
+  if (got <= 0) {
+    return false;
+  }
+  buffer[got] = 0;
+  return true;
+}
+
+static void ThreadStatsProcField(char const *line, char const *name, uint64_t *outValue) {
+  size_t const length = strlen(name);
+  if (strncmp(line, name, length) == 0) {
+    *outValue = strtoull(line + length, NULL, 10);
+  }
+}
+
+// status has no size limit, the cpu and node masks grow with the machine,
+// so it's read a line at a time rather than into a fixed buffer
+static void ThreadStatsSampleProcStatus(Thread_ThreadStats *stats) {
+  char path[64];
+  ThreadStatsProcPath(stats->osThreadId, "status", path, sizeof(path));
+  FILE *file = fopen(path, "re");
+  if (!file) {
+    return;
+  }
+  char line[256];
+  bool lineStart = true;
+  while (fgets(line, sizeof(line), file)) {
+    if (lineStart) {
+      ThreadStatsProcField(line, "voluntary_ctxt_switches:", &stats->voluntarySwitches);
+      ThreadStatsProcField(line, "nonvoluntary_ctxt_switches:", &stats->involuntarySwitches);
+    }
+    // a line longer than the buffer comes back in pieces, only the first starts with a name
+    lineStart = strchr(line, '\n') != NULL;
+  }
+  fclose(file);
+}
+
+// context switches and cpu of any thread in this process
+static void ThreadStatsSampleProc(Thread_ThreadStats *stats) {
+  ThreadStatsSampleProcStatus(stats);
+  char buffer[2048];
+  if (ThreadStatsReadProc(stats->osThreadId, "stat", buffer, sizeof(buffer))) {
+    // the name field can hold spaces and ')', so count from the last ')' which ends field 2.
+    // processor is field 39
+    char const *field = strrchr(buffer, ')');
+    for (uint32_t i = 3; field && i <= 39; ++i) {
+      field = strchr(field + 1, ' ');
+    }
+    if (field) {
+      stats->cpu = atoi(field + 1);
+    }
+  }
+}
+#endif
+
+// the cheap part, called with the registry locked so the thread can't exit under us
+static void ThreadStatsSampleRegistered(ThreadRegistered const *registered, Thread_ThreadStats *stats) {
+  memset(stats, 0, sizeof(Thread_ThreadStats));
+  stats->osThreadId = registered->osThreadId;
+  stats->cpu = -1;
+#if defined(__APPLE__)
+  thread_basic_info_data_t info;
+  mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+  if (thread_info(pthread_mach_thread_np(registered->pthread), THREAD_BASIC_INFO, (thread_info_t) &info, &count) == KERN_SUCCESS) {
+    stats->cpuTimeNs = ((uint64_t) info.user_time.seconds + (uint64_t) info.system_time.seconds) * 1000000000ull +
+        ((uint64_t) info.user_time.microseconds + (uint64_t) info.system_time.microseconds) * 1000ull;
+  }
+#else
+  clockid_t clock;
+  struct timespec ts;
+  if (pthread_getcpuclockid(registered->pthread, &clock) == 0 && clock_gettime(clock, &ts) == 0) {
+    stats->cpuTimeNs = ThreadStatsTimespecNs(&ts);
+  }
+#endif
+}
+
+AL2O3_EXTERN_C uint64_t Thread_StatsCurrentOSThreadID(void) {
+#if defined(__linux__)
+  return (uint64_t) syscall(SYS_gettid);
+#elif defined(__APPLE__)
+  uint64_t id = 0;
+  pthread_threadid_np(NULL, &id);
+  return id;
+#else
+  return (uint64_t) (uintptr_t) pthread_self();
+#endif
+}
+
+AL2O3_EXTERN_C void Thread_StatsGetCurrent(Thread_ThreadStats *stats) {
+  ASSERT(stats);
+#if defined(__linux__)
+  memset(stats, 0, sizeof(Thread_ThreadStats));
+  stats->osThreadId = Thread_StatsCurrentOSThreadID();
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+    stats->cpuTimeNs = ThreadStatsTimespecNs(&ts);
+  }
+  struct rusage usage;
+  if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+    stats->voluntarySwitches = (uint64_t) usage.ru_nvcsw;
+    stats->involuntarySwitches = (uint64_t) usage.ru_nivcsw;
+  }
+  stats->cpu = sched_getcpu();
+#else
+  ThreadRegistered self;
+  self.pthread = pthread_self();
+  self.osThreadId = Thread_StatsCurrentOSThreadID();
+  ThreadStatsSampleRegistered(&self, stats);
+#endif
+}
+
+AL2O3_EXTERN_C uint32_t Thread_StatsGetAll(Thread_ThreadStats *stats, uint32_t maxCount) {
+  ASSERT(stats || maxCount == 0);
+  pthread_mutex_lock(&s_registryMutex);
+  uint32_t const count = s_registryCount;
+  uint32_t written = 0;
+  for (ThreadRegistered *registered = s_registryHead; registered && written < maxCount; registered = registered->next) {
+    ThreadStatsSampleRegistered(registered, &stats[written++]);
+  }
+  pthread_mutex_unlock(&s_registryMutex);
+#if defined(__linux__)
+  // file reads outside the lock so thread start and exit never wait on them,
+  // a thread that exits in between keeps the zeros
+  for (uint32_t i = 0; i < written; ++i) {
+    ThreadStatsSampleProc(&stats[i]);
+  }
+#endif
+  return count;
+}
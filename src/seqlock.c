@@ -0,0 +1,106 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/seqlock.h"
+#include <string.h>
+
+// pauses before a reader waiting out a write starts yielding, the writer was
+// probably descheduled mid write
+#define SEQLOCK_PAUSES_BEFORE_YIELD 4096
+
+// the shared side is only touched through relaxed atomics, so a torn copy is
+// just wrong data that ReadRetry throws away rather than a data race
+static void SeqLockCopyIn(void *shared, void const *src, size_t size) {
+	Thread_Atomic64_t *words = (Thread_Atomic64_t *) shared;
+	uint8_t const *in = (uint8_t const *) src;
+	size_t const wordCount = size / 8;
+	for (size_t i = 0; i < wordCount; ++i) {
+		uint64_t word;
+		memcpy(&word, in + i * 8, 8);
+		Thread_AtomicStore64Explicit(&words[i], word, Thread_ATOMIC_RELAXED);
+	}
+	Thread_Atomic8_t *bytes = (Thread_Atomic8_t *) (words + wordCount);
+	for (size_t i = 0; i < size % 8; ++i) {
+		Thread_AtomicStore8Explicit(&bytes[i], in[wordCount * 8 + i], Thread_ATOMIC_RELAXED);
+	}
+}
+
+static void SeqLockCopyOut(void *dst, void const *shared, size_t size) {
+	Thread_Atomic64_t const *words = (Thread_Atomic64_t const *) shared;
+	uint8_t *out = (uint8_t *) dst;
+	size_t const wordCount = size / 8;
+	for (size_t i = 0; i < wordCount; ++i) {
+		uint64_t const word = Thread_AtomicLoad64Explicit(&words[i], Thread_ATOMIC_RELAXED);
+		memcpy(out + i * 8, &word, 8);
+	}
+	Thread_Atomic8_t const *bytes = (Thread_Atomic8_t const *) (words + wordCount);
+	for (size_t i = 0; i < size % 8; ++i) {
+		out[wordCount * 8 + i] = Thread_AtomicLoad8Explicit(&bytes[i], Thread_ATOMIC_RELAXED);
+	}
+}
+
+AL2O3_EXTERN_C bool Thread_SeqLockCreate(Thread_SeqLock *lock) {
+	ASSERT(lock);
+	Thread_AtomicStore32Explicit(&lock->sequence, 0, Thread_ATOMIC_RELAXED);
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_SeqLockDestroy(Thread_SeqLock *lock) {
+	ASSERT(lock);
+	ASSERT((Thread_AtomicLoad32Explicit(&lock->sequence, Thread_ATOMIC_RELAXED) & 1) == 0);
+}
+
+AL2O3_EXTERN_C void Thread_SeqLockWriteBegin(Thread_SeqLock *lock) {
+	ASSERT(lock);
+	uint32_t const sequence = Thread_AtomicLoad32Explicit(&lock->sequence, Thread_ATOMIC_RELAXED);
+	ASSERT((sequence & 1) == 0);
+	Thread_AtomicStore32Explicit(&lock->sequence, sequence + 1, Thread_ATOMIC_RELAXED);
+	// the odd count must be visible before any of the data stores
+	Thread_AtomicThreadFenceExplicit(Thread_ATOMIC_RELEASE);
+}
+
+AL2O3_EXTERN_C void Thread_SeqLockWriteEnd(Thread_SeqLock *lock) {
+	ASSERT(lock);
+	uint32_t const sequence = Thread_AtomicLoad32Explicit(&lock->sequence, Thread_ATOMIC_RELAXED);
+	ASSERT(sequence & 1);
+	Thread_AtomicStore32Explicit(&lock->sequence, sequence + 1, Thread_ATOMIC_RELEASE);
+}
+
+AL2O3_EXTERN_C uint32_t Thread_SeqLockReadBegin(Thread_SeqLock const *lock) {
+	ASSERT(lock);
+	uint32_t paused = 0;
+	uint32_t sequence;
+	while ((sequence = Thread_AtomicLoad32Explicit(&lock->sequence, Thread_ATOMIC_ACQUIRE)) & 1) {
+		if (paused++ < SEQLOCK_PAUSES_BEFORE_YIELD) {
+			Thread_AtomicPause();
+		} else {
+			Thread_Yield();
+		}
+	}
+	return sequence;
+}
+
+AL2O3_EXTERN_C bool Thread_SeqLockReadRetry(Thread_SeqLock const *lock, uint32_t sequence) {
+	ASSERT(lock);
+	// keeps the data loads above from moving below the recheck
+	Thread_AtomicThreadFenceExplicit(Thread_ATOMIC_ACQUIRE);
+	return Thread_AtomicLoad32Explicit(&lock->sequence, Thread_ATOMIC_RELAXED) != sequence;
+}
+
+AL2O3_EXTERN_C void Thread_SeqLockWrite(Thread_SeqLock *lock, void *shared, void const *src, size_t size) {
+	ASSERT(shared && ((uintptr_t) shared & 7) == 0);
+	ASSERT(src || size == 0);
+	Thread_SeqLockWriteBegin(lock);
+	SeqLockCopyIn(shared, src, size);
+	Thread_SeqLockWriteEnd(lock);
+}
+
+AL2O3_EXTERN_C void Thread_SeqLockRead(Thread_SeqLock const *lock, void *dst, void const *shared, size_t size) {
+	ASSERT(shared && ((uintptr_t) shared & 7) == 0);
+	ASSERT(dst || size == 0);
+	uint32_t sequence;
+	do {
+		sequence = Thread_SeqLockReadBegin(lock);
+		SeqLockCopyOut(dst, shared, size);
+	} while (Thread_SeqLockReadRetry(lock, sequence));
+}
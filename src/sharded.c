@@ -0,0 +1,243 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/sharded.h"
+#include "al2o3_memory/memory.h"
+#include <string.h>
+
+typedef struct ShardedMinMaxSlot {
+	Thread_Atomic64_t min;
+	Thread_Atomic64_t max;
+} Thread_CACHE_LINE_ALIGN ShardedMinMaxSlot;
+
+typedef struct ShardedHistogramSlot {
+	Thread_Atomic64_t buckets[Thread_SHARDED_HISTOGRAM_BUCKET_COUNT];
+	Thread_Atomic64_t sum;
+} Thread_CACHE_LINE_ALIGN ShardedHistogramSlot;
+
+// shardCount owned slots then shardCount shared ones, see ShardSlot
+// the header is padded to a cache line by the slot alignment
+typedef struct Thread_ShardedCounter {
+	uint32_t shardCount;
+	Thread_PaddedAtomic64_t slots[];
+} Thread_ShardedCounter;
+
+typedef struct Thread_ShardedMinMax {
+	uint32_t shardCount;
+	ShardedMinMaxSlot slots[];
+} Thread_ShardedMinMax;
+
+typedef struct Thread_ShardedHistogram {
+	uint32_t shardCount;
+	ShardedHistogramSlot slots[];
+} Thread_ShardedHistogram;
+
+static uint32_t ShardCount(uint32_t shardCount) {
+	return shardCount ? shardCount : Thread_CPUCoreCount();
+}
+
+static void *ShardedAlloc(size_t headerSize, size_t slotSize, uint32_t shardCount) {
+	size_t const size = headerSize + slotSize * shardCount * 2;
+	void *mem = MEMORY_AALLOC(size, Thread_CACHE_LINE_SIZE);
+	if (mem) {
+		memset(mem, 0, size);
+		*((uint32_t *) mem) = shardCount;
+	}
+	return mem;
+}
+
+// A thread with an index below shardCount owns that slot and is its only
+// writer. Every other thread goes to one of the shared slots after the owned
+// ones, which nobody owns, so the owner's plain store can't overwrite them.
+AL2O3_FORCE_INLINE uint32_t ShardSlot(uint32_t shardCount, bool *outOwned) {
+	uint32_t const index = Thread_GetCurrentThreadIndex();
+	*outOwned = index < shardCount;
+	return *outOwned ? index : shardCount + index % shardCount;
+}
+
+// an owned slot has no other writer so can skip the locked instruction
+AL2O3_FORCE_INLINE void ShardAdd(Thread_Atomic64_t *slot, bool owned, uint64_t value) {
+	if (owned) {
+		Thread_AtomicStore64Explicit(slot, Thread_AtomicLoad64Explicit(slot, Thread_ATOMIC_RELAXED) + value, Thread_ATOMIC_RELAXED);
+	} else {
+		Thread_AtomicFetchAdd64Explicit(slot, (int64_t) value, Thread_ATOMIC_RELAXED);
+	}
+}
+
+AL2O3_FORCE_INLINE void ShardMin(Thread_Atomic64_t *slot, bool owned, uint64_t value) {
+	if (owned) {
+		if (value < Thread_AtomicLoad64Explicit(slot, Thread_ATOMIC_RELAXED)) {
+			Thread_AtomicStore64Explicit(slot, value, Thread_ATOMIC_RELAXED);
+		}
+	} else {
+		Thread_AtomicFetchMin64Explicit(slot, value, Thread_ATOMIC_RELAXED);
+	}
+}
+
+AL2O3_FORCE_INLINE void ShardMax(Thread_Atomic64_t *slot, bool owned, uint64_t value) {
+	if (owned) {
+		if (value > Thread_AtomicLoad64Explicit(slot, Thread_ATOMIC_RELAXED)) {
+			Thread_AtomicStore64Explicit(slot, value, Thread_ATOMIC_RELAXED);
+		}
+	} else {
+		Thread_AtomicFetchMax64Explicit(slot, value, Thread_ATOMIC_RELAXED);
+	}
+}
+
+AL2O3_EXTERN_C Thread_ShardedCounterHandle Thread_ShardedCounterCreate(uint32_t shardCount) {
+	shardCount = ShardCount(shardCount);
+	return (Thread_ShardedCounterHandle) ShardedAlloc(sizeof(Thread_ShardedCounter), sizeof(Thread_PaddedAtomic64_t), shardCount);
+}
+
+AL2O3_EXTERN_C void Thread_ShardedCounterDestroy(Thread_ShardedCounterHandle counter) {
+	if (!counter) {
+		return;
+	}
+	MEMORY_FREE(counter);
+}
+
+AL2O3_EXTERN_C void Thread_ShardedCounterAdd(Thread_ShardedCounterHandle counter, int64_t value) {
+	ASSERT(counter);
+	bool owned;
+	uint32_t const slot = ShardSlot(counter->shardCount, &owned);
+	ShardAdd(&counter->slots[slot].value, owned, (uint64_t) value);
+}
+
+AL2O3_EXTERN_C int64_t Thread_ShardedCounterRead(Thread_ShardedCounterHandle counter) {
+	ASSERT(counter);
+	uint64_t total = 0;
+	for (uint32_t i = 0; i < counter->shardCount * 2; ++i) {
+		total += Thread_AtomicLoad64Explicit(&counter->slots[i].value, Thread_ATOMIC_RELAXED);
+	}
+	return (int64_t) total;
+}
+
+AL2O3_EXTERN_C void Thread_ShardedCounterReset(Thread_ShardedCounterHandle counter) {
+	ASSERT(counter);
+	for (uint32_t i = 0; i < counter->shardCount * 2; ++i) {
+		Thread_AtomicStore64Explicit(&counter->slots[i].value, 0, Thread_ATOMIC_RELAXED);
+	}
+}
+
+AL2O3_EXTERN_C Thread_ShardedMinMaxHandle Thread_ShardedMinMaxCreate(uint32_t shardCount) {
+	shardCount = ShardCount(shardCount);
+	Thread_ShardedMinMaxHandle minMax =
+			(Thread_ShardedMinMaxHandle) ShardedAlloc(sizeof(Thread_ShardedMinMax), sizeof(ShardedMinMaxSlot), shardCount);
+	if (minMax) {
+		Thread_ShardedMinMaxReset(minMax);
+	}
+	return minMax;
+}
+
+AL2O3_EXTERN_C void Thread_ShardedMinMaxDestroy(Thread_ShardedMinMaxHandle minMax) {
+	if (!minMax) {
+		return;
+	}
+	MEMORY_FREE(minMax);
+}
+
+AL2O3_EXTERN_C void Thread_ShardedMinMaxUpdate(Thread_ShardedMinMaxHandle minMax, uint64_t value) {
+	ASSERT(minMax);
+	bool owned;
+	ShardedMinMaxSlot *slot = &minMax->slots[ShardSlot(minMax->shardCount, &owned)];
+	ShardMin(&slot->min, owned, value);
+	ShardMax(&slot->max, owned, value);
+}
+
+AL2O3_EXTERN_C bool Thread_ShardedMinMaxRead(Thread_ShardedMinMaxHandle minMax, uint64_t *outMin, uint64_t *outMax) {
+	ASSERT(minMax);
+	uint64_t min = UINT64_MAX;
+	uint64_t max = 0;
+	bool any = false;
+	for (uint32_t i = 0; i < minMax->shardCount * 2; ++i) {
+		uint64_t const slotMin = Thread_AtomicLoad64Explicit(&minMax->slots[i].min, Thread_ATOMIC_RELAXED);
+		uint64_t const slotMax = Thread_AtomicLoad64Explicit(&minMax->slots[i].max, Thread_ATOMIC_RELAXED);
+		// an untouched slot still has min > max
+		if (slotMin > slotMax) {
+			continue;
+		}
+		any = true;
+		min = slotMin < min ? slotMin : min;
+		max = slotMax > max ? slotMax : max;
+	}
+	if (outMin) {
+		*outMin = min;
+	}
+	if (outMax) {
+		*outMax = max;
+	}
+	return any;
+}
+
+AL2O3_EXTERN_C void Thread_ShardedMinMaxReset(Thread_ShardedMinMaxHandle minMax) {
+	ASSERT(minMax);
+	for (uint32_t i = 0; i < minMax->shardCount * 2; ++i) {
+		Thread_AtomicStore64Explicit(&minMax->slots[i].min, UINT64_MAX, Thread_ATOMIC_RELAXED);
+		Thread_AtomicStore64Explicit(&minMax->slots[i].max, 0, Thread_ATOMIC_RELAXED);
+	}
+}
+
+AL2O3_EXTERN_C uint32_t Thread_ShardedHistogramBucketOf(uint64_t value) {
+	if (value == 0) {
+		return 0;
+	}
+#if AL2O3_COMPILER == AL2O3_COMPILER_MSVC
+	unsigned long highBit;
+	_BitScanReverse64(&highBit, value);
+	return (uint32_t) highBit + 1;
+#else
+	return 64 - (uint32_t) __builtin_clzll(value);
+#endif
+}
+
+AL2O3_EXTERN_C Thread_ShardedHistogramHandle Thread_ShardedHistogramCreate(uint32_t shardCount) {
+	shardCount = ShardCount(shardCount);
+	return (Thread_ShardedHistogramHandle) ShardedAlloc(sizeof(Thread_ShardedHistogram), sizeof(ShardedHistogramSlot), shardCount);
+}
+
+AL2O3_EXTERN_C void Thread_ShardedHistogramDestroy(Thread_ShardedHistogramHandle histogram) {
+	if (!histogram) {
+		return;
+	}
+	MEMORY_FREE(histogram);
+}
+
+AL2O3_EXTERN_C void Thread_ShardedHistogramRecord(Thread_ShardedHistogramHandle histogram, uint64_t value) {
+	ASSERT(histogram);
+	bool owned;
+	ShardedHistogramSlot *slot = &histogram->slots[ShardSlot(histogram->shardCount, &owned)];
+	ShardAdd(&slot->buckets[Thread_ShardedHistogramBucketOf(value)], owned, 1);
+	ShardAdd(&slot->sum, owned, value);
+}
+
+AL2O3_EXTERN_C uint64_t Thread_ShardedHistogramRead(Thread_ShardedHistogramHandle histogram, uint64_t *outBuckets, uint64_t *outSum) {
+	ASSERT(histogram);
+	ASSERT(outBuckets);
+	memset(outBuckets, 0, sizeof(uint64_t) * Thread_SHARDED_HISTOGRAM_BUCKET_COUNT);
+	uint64_t count = 0;
+	uint64_t sum = 0;
+	for (uint32_t i = 0; i < histogram->shardCount * 2; ++i) {
+		ShardedHistogramSlot *slot = &histogram->slots[i];
+		for (uint32_t j = 0; j < Thread_SHARDED_HISTOGRAM_BUCKET_COUNT; ++j) {
+			uint64_t const bucket = Thread_AtomicLoad64Explicit(&slot->buckets[j], Thread_ATOMIC_RELAXED);
+			outBuckets[j] += bucket;
+			count += bucket;
+		}
+		sum += Thread_AtomicLoad64Explicit(&slot->sum, Thread_ATOMIC_RELAXED);
+	}
+	if (outSum) {
+		*outSum = sum;
+	}
+	return count;
+}
+
+AL2O3_EXTERN_C void Thread_ShardedHistogramReset(Thread_ShardedHistogramHandle histogram) {
+	ASSERT(histogram);
+	for (uint32_t i = 0; i < histogram->shardCount * 2; ++i) {
+		ShardedHistogramSlot *slot = &histogram->slots[i];
+		for (uint32_t j = 0; j < Thread_SHARDED_HISTOGRAM_BUCKET_COUNT; ++j) {
+			Thread_AtomicStore64Explicit(&slot->buckets[j], 0, Thread_ATOMIC_RELAXED);
+		}
+		Thread_AtomicStore64Explicit(&slot->sum, 0, Thread_ATOMIC_RELAXED);
+	}
+}
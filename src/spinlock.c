@@ -0,0 +1,169 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/spinlock.h"
+
+// pauses before a waiter starts giving its time slice away, long enough that
+// a holder that is actually running has finished
+#define SPIN_PAUSES_BEFORE_YIELD 4096
+#define SPIN_MAX_BACKOFF 1024
+// pauses per ticket ahead of us, roughly one short critical section
+#define TICKET_BACKOFF_PER_WAITER 16
+
+typedef struct SpinWait {
+	uint32_t paused;
+} SpinWait;
+
+static void SpinWaitPause(SpinWait *wait, uint32_t count) {
+	if (wait->paused >= SPIN_PAUSES_BEFORE_YIELD) {
+		// the holder (or the next in line) is probably not running
+		Thread_Yield();
+		return;
+	}
+	for (uint32_t i = 0; i < count; ++i) {
+		Thread_AtomicPause();
+	}
+	wait->paused += count;
+}
+
+AL2O3_EXTERN_C bool Thread_SpinLockCreate(Thread_SpinLock *lock) {
+	ASSERT(lock);
+	Thread_AtomicStore32Explicit(&lock->locked, 0, Thread_ATOMIC_RELAXED);
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_SpinLockDestroy(Thread_SpinLock *lock) {
+	ASSERT(lock);
+	ASSERT(Thread_AtomicLoad32Explicit(&lock->locked, Thread_ATOMIC_RELAXED) == 0);
+}
+
+AL2O3_EXTERN_C void Thread_SpinLockAcquire(Thread_SpinLock *lock) {
+	ASSERT(lock);
+	if (Thread_AtomicExchange32Explicit(&lock->locked, 1, Thread_ATOMIC_ACQUIRE) == 0) {
+		return;
+	}
+	SpinWait wait = {0};
+	uint32_t backoff = 1;
+	for (;;) {
+		// spin on a shared copy of the line, only write once it looks free
+		while (Thread_AtomicLoad32Explicit(&lock->locked, Thread_ATOMIC_RELAXED) != 0) {
+			SpinWaitPause(&wait, backoff);
+		}
+		if (Thread_AtomicExchange32Explicit(&lock->locked, 1, Thread_ATOMIC_ACQUIRE) == 0) {
+			return;
+		}
+		// lost the race, back off so the winners don't all collide again
+		SpinWaitPause(&wait, backoff);
+		backoff = backoff < SPIN_MAX_BACKOFF ? backoff * 2 : SPIN_MAX_BACKOFF;
+	}
+}
+
+AL2O3_EXTERN_C bool Thread_SpinLockTryAcquire(Thread_SpinLock *lock) {
+	ASSERT(lock);
+	return Thread_AtomicLoad32Explicit(&lock->locked, Thread_ATOMIC_RELAXED) == 0 &&
+			Thread_AtomicExchange32Explicit(&lock->locked, 1, Thread_ATOMIC_ACQUIRE) == 0;
+}
+
+AL2O3_EXTERN_C void Thread_SpinLockRelease(Thread_SpinLock *lock) {
+	ASSERT(lock);
+	ASSERT(Thread_AtomicLoad32Explicit(&lock->locked, Thread_ATOMIC_RELAXED) != 0);
+	Thread_AtomicStore32Explicit(&lock->locked, 0, Thread_ATOMIC_RELEASE);
+}
+
+AL2O3_EXTERN_C bool Thread_TicketLockCreate(Thread_TicketLock *lock) {
+	ASSERT(lock);
+	Thread_AtomicStore32Explicit(&lock->next, 0, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&lock->serving, 0, Thread_ATOMIC_RELAXED);
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_TicketLockDestroy(Thread_TicketLock *lock) {
+	ASSERT(lock);
+	ASSERT(Thread_AtomicLoad32Explicit(&lock->next, Thread_ATOMIC_RELAXED) ==
+				 Thread_AtomicLoad32Explicit(&lock->serving, Thread_ATOMIC_RELAXED));
+}
+
+AL2O3_EXTERN_C void Thread_TicketLockAcquire(Thread_TicketLock *lock) {
+	ASSERT(lock);
+	uint32_t const ticket = Thread_AtomicFetchAdd32Explicit(&lock->next, 1, Thread_ATOMIC_RELAXED);
+	SpinWait wait = {0};
+	uint32_t serving;
+	while ((serving = Thread_AtomicLoad32Explicit(&lock->serving, Thread_ATOMIC_ACQUIRE)) != ticket) {
+		// back off in proportion to how many are ahead of us
+		SpinWaitPause(&wait, (ticket - serving) * TICKET_BACKOFF_PER_WAITER);
+	}
+}
+
+AL2O3_EXTERN_C bool Thread_TicketLockTryAcquire(Thread_TicketLock *lock) {
+	ASSERT(lock);
+	uint32_t expected = Thread_AtomicLoad32Explicit(&lock->serving, Thread_ATOMIC_RELAXED);
+	return Thread_AtomicCompareExchangeStrong32Explicit(&lock->next, &expected, expected + 1,
+																											 Thread_ATOMIC_ACQUIRE, Thread_ATOMIC_RELAXED);
+}
+
+AL2O3_EXTERN_C void Thread_TicketLockRelease(Thread_TicketLock *lock) {
+	ASSERT(lock);
+	// only the holder writes serving
+	uint32_t const serving = Thread_AtomicLoad32Explicit(&lock->serving, Thread_ATOMIC_RELAXED);
+	ASSERT(serving != Thread_AtomicLoad32Explicit(&lock->next, Thread_ATOMIC_RELAXED));
+	Thread_AtomicStore32Explicit(&lock->serving, serving + 1, Thread_ATOMIC_RELEASE);
+}
+
+AL2O3_EXTERN_C bool Thread_MCSLockCreate(Thread_MCSLock *lock) {
+	ASSERT(lock);
+	Thread_AtomicStorePtrExplicit(&lock->tail, NULL, Thread_ATOMIC_RELAXED);
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_MCSLockDestroy(Thread_MCSLock *lock) {
+	ASSERT(lock);
+	ASSERT(Thread_AtomicLoadPtrExplicit(&lock->tail, Thread_ATOMIC_RELAXED) == NULL);
+}
+
+AL2O3_EXTERN_C void Thread_MCSLockAcquire(Thread_MCSLock *lock, Thread_MCSLockNode *node) {
+	ASSERT(lock);
+	ASSERT(node);
+	Thread_AtomicStorePtrExplicit(&node->next, NULL, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&node->locked, 1, Thread_ATOMIC_RELAXED);
+	// release publishes our node's fields, acquire sees the previous holder's writes
+	Thread_MCSLockNode *prev =
+			(Thread_MCSLockNode *) Thread_AtomicExchangePtrExplicit(&lock->tail, node, Thread_ATOMIC_ACQ_REL);
+	if (!prev) {
+		return;
+	}
+	Thread_AtomicStorePtrExplicit(&prev->next, node, Thread_ATOMIC_RELEASE);
+	SpinWait wait = {0};
+	while (Thread_AtomicLoad32Explicit(&node->locked, Thread_ATOMIC_ACQUIRE) != 0) {
+		SpinWaitPause(&wait, 1);
+	}
+}
+
+AL2O3_EXTERN_C bool Thread_MCSLockTryAcquire(Thread_MCSLock *lock, Thread_MCSLockNode *node) {
+	ASSERT(lock);
+	ASSERT(node);
+	Thread_AtomicStorePtrExplicit(&node->next, NULL, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&node->locked, 1, Thread_ATOMIC_RELAXED);
+	void *expected = NULL;
+	return Thread_AtomicCompareExchangeStrongPtrExplicit(&lock->tail, &expected, node,
+																											 Thread_ATOMIC_ACQ_REL, Thread_ATOMIC_RELAXED);
+}
+
+AL2O3_EXTERN_C void Thread_MCSLockRelease(Thread_MCSLock *lock, Thread_MCSLockNode *node) {
+	ASSERT(lock);
+	ASSERT(node);
+	Thread_MCSLockNode *next = (Thread_MCSLockNode *) Thread_AtomicLoadPtrExplicit(&node->next, Thread_ATOMIC_ACQUIRE);
+	if (!next) {
+		// no visible successor, if we are still the tail the lock is just free
+		void *expected = node;
+		if (Thread_AtomicCompareExchangeStrongPtrExplicit(&lock->tail, &expected, NULL,
+																										 Thread_ATOMIC_RELEASE, Thread_ATOMIC_RELAXED)) {
+			return;
+		}
+		// someone swapped in behind us and is about to link
+		SpinWait wait = {0};
+		while (!(next = (Thread_MCSLockNode *) Thread_AtomicLoadPtrExplicit(&node->next, Thread_ATOMIC_ACQUIRE))) {
+			SpinWaitPause(&wait, 1);
+		}
+	}
+	Thread_AtomicStore32Explicit(&next->locked, 0, Thread_ATOMIC_RELEASE);
+}
@@ -0,0 +1,67 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/triplebuffer.h"
+#include "al2o3_memory/memory.h"
+#include <string.h>
+
+#define TRIPLE_BUFFER_INDEX_MASK 0x3
+
+AL2O3_EXTERN_C bool Thread_TripleBufferCreate(Thread_TripleBuffer *tb, size_t bufferSize) {
+	ASSERT(tb);
+	ASSERT(bufferSize);
+	// each buffer on its own cache lines so the two sides never false share
+	size_t const stride = (bufferSize + Thread_CACHE_LINE_SIZE - 1) & ~((size_t) Thread_CACHE_LINE_SIZE - 1);
+	uint8_t *memory = (uint8_t *) MEMORY_AALLOC(stride * 3, Thread_CACHE_LINE_SIZE);
+	if (!memory) {
+		return false;
+	}
+	memset(memory, 0, stride * 3);
+	for (uint32_t i = 0; i < 3; ++i) {
+		tb->buffers[i] = memory + stride * i;
+	}
+	tb->bufferSize = bufferSize;
+	Thread_AtomicStore32Explicit(&tb->back.value, 0, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&tb->spare.value, 1, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&tb->front.value, 2, Thread_ATOMIC_RELAXED);
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_TripleBufferDestroy(Thread_TripleBuffer *tb) {
+	ASSERT(tb);
+	// the indices move between the sides, the buffers don't, 0 is the allocation
+	MEMORY_FREE(tb->buffers[0]);
+	memset(tb, 0, sizeof(Thread_TripleBuffer));
+}
+
+AL2O3_EXTERN_C void *Thread_TripleBufferWriteBuffer(Thread_TripleBuffer *tb) {
+	ASSERT(tb);
+	return tb->buffers[Thread_AtomicLoad32Explicit(&tb->back.value, Thread_ATOMIC_RELAXED)];
+}
+
+AL2O3_EXTERN_C void Thread_TripleBufferPublish(Thread_TripleBuffer *tb) {
+	ASSERT(tb);
+	uint32_t const back = Thread_AtomicLoad32Explicit(&tb->back.value, Thread_ATOMIC_RELAXED);
+	// release hands over what we wrote, acquire makes sure the consumer has
+	// finished reading the buffer we get back before we write to it
+	uint32_t const spare = Thread_AtomicExchange32Explicit(&tb->spare.value, back | Thread_TRIPLE_BUFFER_FRESH,
+																												 Thread_ATOMIC_ACQ_REL);
+	Thread_AtomicStore32Explicit(&tb->back.value, spare & TRIPLE_BUFFER_INDEX_MASK, Thread_ATOMIC_RELAXED);
+}
+
+AL2O3_EXTERN_C bool Thread_TripleBufferUpdate(Thread_TripleBuffer *tb) {
+	ASSERT(tb);
+	// a plain load so a consumer polling faster than the producer publishes
+	// never writes the shared line
+	if (!(Thread_AtomicLoad32Explicit(&tb->spare.value, Thread_ATOMIC_RELAXED) & Thread_TRIPLE_BUFFER_FRESH)) {
+		return false;
+	}
+	uint32_t const front = Thread_AtomicLoad32Explicit(&tb->front.value, Thread_ATOMIC_RELAXED);
+	uint32_t const spare = Thread_AtomicExchange32Explicit(&tb->spare.value, front, Thread_ATOMIC_ACQ_REL);
+	Thread_AtomicStore32Explicit(&tb->front.value, spare & TRIPLE_BUFFER_INDEX_MASK, Thread_ATOMIC_RELAXED);
+	return true;
+}
+
+AL2O3_EXTERN_C void const *Thread_TripleBufferReadBuffer(Thread_TripleBuffer *tb) {
+	ASSERT(tb);
+	return tb->buffers[Thread_AtomicLoad32Explicit(&tb->front.value, Thread_ATOMIC_RELAXED)];
+}
@@ -0,0 +1,181 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_platform/windows.h"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+#include "al2o3_thread/spinlock.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/asyncio.h"
+#include "al2o3_memory/memory.h"
+#include <string.h>
+
+// windows always uses the blocking fallback
+#define ASYNCIO_DEFAULT_FALLBACK_THREADS 4
+// top bit of fallbackQueued, set by destroy
+#define ASYNCIO_FALLBACK_SHUTDOWN 0x80000000u
+
+typedef struct Thread_AsyncIO {
+	Thread_PoolHandle pool;
+	Thread_PoolPriority continuationPriority;
+
+	uint32_t fallbackThreadCount;
+	Thread_Thread *fallbackThreads;
+	Thread_SpinLock fallbackLock;
+	// under fallbackLock, linked through the requests so it never fills
+	Thread_AsyncIORequest *fallbackHead;
+	Thread_AsyncIORequest *fallbackTail;
+	// requests in the list plus the shutdown bit, idle fallback threads wait on it
+	Thread_PaddedAtomic32_t fallbackQueued;
+} Thread_AsyncIO;
+
+static void AsyncIOBlockingTransfer(Thread_AsyncIORequest *request) {
+	Thread_AsyncIO *io = request->owner;
+
+	OVERLAPPED overlapped;
+	memset(&overlapped, 0, sizeof(overlapped));
+	overlapped.Offset = (DWORD) request->offset;
+	overlapped.OffsetHigh = (DWORD) (request->offset >> 32);
+	DWORD transferred = 0;
+	BOOL const ok = request->op == Thread_ASYNCIO_READ ?
+			ReadFile((HANDLE) request->file, request->buffer, request->size, &transferred, &overlapped) :
+			WriteFile((HANDLE) request->file, request->buffer, request->size, &transferred, &overlapped);
+	// reading at or past the end is a 0 byte read, like pread
+	DWORD const error = ok ? ERROR_SUCCESS : GetLastError();
+	request->result = (ok || error == ERROR_HANDLE_EOF) ? (int64_t) transferred : -(int64_t) error;
+
+	if (!request->continuation) {
+		return;
+	}
+	if (io->pool) {
+		Thread_PoolSubmitPriority(io->pool, io->continuationPriority, request->continuation, request);
+	} else {
+		request->continuation(request);
+	}
+}
+
+// waits for a queued request, NULL once destroy has been called and the queue is empty
+static Thread_AsyncIORequest *AsyncIOFallbackPop(Thread_AsyncIO *io) {
+	uint32_t queued = Thread_AtomicLoad32Explicit(&io->fallbackQueued.value, Thread_ATOMIC_ACQUIRE);
+	for (;;) {
+		if ((queued & ~ASYNCIO_FALLBACK_SHUTDOWN) == 0) {
+			if (queued & ASYNCIO_FALLBACK_SHUTDOWN) {
+				return NULL;
+			}
+			Thread_FutexWait(&io->fallbackQueued.value, queued, Thread_FUTEX_WAIT_INFINITE);
+			queued = Thread_AtomicLoad32Explicit(&io->fallbackQueued.value, Thread_ATOMIC_ACQUIRE);
+			continue;
+		}
+		// the count only goes up after the push, so claiming one means a request is in the list for us
+		if (Thread_AtomicCompareExchangeWeak32Explicit(&io->fallbackQueued.value, &queued, queued - 1,
+																									 Thread_ATOMIC_ACQUIRE, Thread_ATOMIC_ACQUIRE)) {
+			break;
+		}
+	}
+	Thread_SpinLockAcquire(&io->fallbackLock);
+	Thread_AsyncIORequest *request = io->fallbackHead;
+	io->fallbackHead = request->next;
+	if (!io->fallbackHead) {
+		io->fallbackTail = NULL;
+	}
+	Thread_SpinLockRelease(&io->fallbackLock);
+	return request;
+}
+
+static void AsyncIOFallbackThread(void *data) {
+	Thread_AsyncIO *io = (Thread_AsyncIO *) data;
+	Thread_AsyncIORequest *request;
+	while ((request = AsyncIOFallbackPop(io))) {
+		AsyncIOBlockingTransfer(request);
+	}
+}
+
+AL2O3_EXTERN_C Thread_AsyncIOHandle Thread_AsyncIOCreate(Thread_AsyncIODesc const *desc) {
+	Thread_AsyncIODesc config;
+	memset(&config, 0, sizeof(config));
+	if (desc) {
+		config = *desc;
+	}
+
+	Thread_AsyncIO *io = (Thread_AsyncIO *) MEMORY_AALLOC(sizeof(Thread_AsyncIO), Thread_CACHE_LINE_SIZE);
+	if (!io) {
+		return NULL;
+	}
+	memset(io, 0, sizeof(Thread_AsyncIO));
+	io->pool = config.pool;
+	io->continuationPriority = config.continuationPriority;
+
+	// the threads spend their time blocked in the kernel, so their count isn't tied to the cores
+	uint32_t const threadCount = config.fallbackThreads ? config.fallbackThreads : ASYNCIO_DEFAULT_FALLBACK_THREADS;
+	io->fallbackThreads = (Thread_Thread *) MEMORY_CALLOC(threadCount, sizeof(Thread_Thread));
+	if (!io->fallbackThreads || !Thread_SpinLockCreate(&io->fallbackLock)) {
+		MEMORY_FREE(io->fallbackThreads);
+		MEMORY_FREE(io);
+		return NULL;
+	}
+	while (io->fallbackThreadCount < threadCount &&
+			Thread_ThreadCreate(&io->fallbackThreads[io->fallbackThreadCount], &AsyncIOFallbackThread, io)) {
+		io->fallbackThreadCount++;
+	}
+	if (io->fallbackThreadCount == 0) {
+		Thread_SpinLockDestroy(&io->fallbackLock);
+		MEMORY_FREE(io->fallbackThreads);
+		MEMORY_FREE(io);
+		return NULL;
+	}
+	return io;
+}
+
+AL2O3_EXTERN_C void Thread_AsyncIODestroy(Thread_AsyncIOHandle io) {
+	if (!io) {
+		return;
+	}
+	// the threads finish everything queued, then see the bit with nothing left and exit
+	Thread_AtomicFetchOr32Explicit(&io->fallbackQueued.value, ASYNCIO_FALLBACK_SHUTDOWN, Thread_ATOMIC_RELEASE);
+	Thread_FutexWakeAll(&io->fallbackQueued.value);
+	for (uint32_t i = 0; i < io->fallbackThreadCount; ++i) {
+		Thread_ThreadDestroy(&io->fallbackThreads[i]);
+	}
+	Thread_SpinLockDestroy(&io->fallbackLock);
+	MEMORY_FREE(io->fallbackThreads);
+	MEMORY_FREE(io);
+}
+
+AL2O3_EXTERN_C bool Thread_AsyncIOIsUring(Thread_AsyncIOHandle io) {
+	ASSERT(io);
+	return false;
+}
+
+AL2O3_EXTERN_C bool Thread_AsyncIORegisterBuffers(Thread_AsyncIOHandle io,
+																									void *const *buffers,
+																									size_t const *sizes,
+																									uint32_t count) {
+	ASSERT(io);
+	return true;
+}
+
+AL2O3_EXTERN_C void Thread_AsyncIOSubmit(Thread_AsyncIOHandle io, Thread_AsyncIORequest *const *requests, uint32_t count) {
+	ASSERT(io);
+	ASSERT(requests || count == 0);
+	if (count == 0) {
+		return;
+	}
+	for (uint32_t i = 0; i < count; ++i) {
+		requests[i]->owner = io;
+		requests[i]->next = i + 1 < count ? requests[i + 1] : NULL;
+	}
+	Thread_SpinLockAcquire(&io->fallbackLock);
+	if (io->fallbackTail) {
+		io->fallbackTail->next = requests[0];
+	} else {
+		io->fallbackHead = requests[0];
+	}
+	io->fallbackTail = requests[count - 1];
+	Thread_SpinLockRelease(&io->fallbackLock);
+
+	Thread_AtomicFetchAdd32Explicit(&io->fallbackQueued.value, count, Thread_ATOMIC_RELEASE);
+	if (count == 1) {
+		Thread_FutexWakeOne(&io->fallbackQueued.value);
+	} else {
+		Thread_FutexWakeAll(&io->fallbackQueued.value);
+	}
+}
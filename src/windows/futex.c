@@ -0,0 +1,27 @@
+#include "al2o3_platform/platform.h"
+#include "al2o3_platform/windows.h"
+#include "al2o3_thread/futex.h"
+
+// WaitOnAddress lives in Synchronization.lib (Windows 8+)
+AL2O3_EXTERN_C bool Thread_FutexWait(Thread_Atomic32_t *address, uint32_t expected, uint64_t timeoutNs) {
+	ASSERT(address);
+	DWORD timeoutMs = INFINITE;
+	if (timeoutNs != Thread_FUTEX_WAIT_INFINITE) {
+		uint64_t const ms = (timeoutNs + 999999) / 1000000;
+		timeoutMs = ms >= INFINITE ? INFINITE - 1 : (DWORD) ms;
+	}
+	if (WaitOnAddress((volatile void *) &address->nonatomic, &expected, sizeof(uint32_t), timeoutMs)) {
+		return true;
+	}
+	return GetLastError() != ERROR_TIMEOUT;
+}
+
+AL2O3_EXTERN_C void Thread_FutexWakeOne(Thread_Atomic32_t *address) {
+	ASSERT(address);
+	WakeByAddressSingle((void *) &address->nonatomic);
+}
+
+AL2O3_EXTERN_C void Thread_FutexWakeAll(Thread_Atomic32_t *address) {
+	ASSERT(address);
+	WakeByAddressAll((void *) &address->nonatomic);
+}
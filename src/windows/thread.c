@@ -2,7 +2,11 @@
 #include "al2o3_platform/windows.h"
 #include "al2o3_thread/thread.h"
 #include <stdlib.h>
+#include <string.h>
 #include "al2o3_memory/memory.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+#include "al2o3_thread/stats.h"
 
 static_assert(sizeof(CRITICAL_SECTION) == sizeof(Thread_Mutex), "Mutex size failure in windows/thread.c");
 static_assert(sizeof(CONDITION_VARIABLE) == sizeof(Thread_ConditionalVariable), "Condition Variable size failure in windows/thread.c");
@@ -37,35 +41,238 @@ AL2O3_EXTERN_C void Thread_ConditionalVariableSet(Thread_ConditionalVariable *cv
   WakeConditionVariable((CONDITION_VARIABLE *) cv);
 }
 
-struct TrampParam {
-	Thread_JobFunction func;
+struct Thread_ThreadObject {
+  Thread_JobFunction func;
   void *param;
+  // 0 running, 1 finished, 2 finished not yet seen by a waiting joiner
+  Thread_Atomic32_t state;
+  // uncached threads are waited on and closed once, by whichever join takes this
+  Thread_AtomicPtr_t handle;
 };
 
+// an OS thread that parks in the cache between objects
+typedef struct ThreadCached {
+  Thread_Atomic32_t wake;
+  struct Thread_ThreadObject *object; // next to run, NULL to exit
+  struct ThreadCached *next;
+} ThreadCached;
+
+static SRWLOCK s_cacheLock = SRWLOCK_INIT;
+static ThreadCached *s_cacheHead;
+static uint32_t s_cacheCount;
+static uint32_t s_cacheMax;
+
+// every live OS thread we started, for Thread_StatsGetAll. Nodes live on
+// their thread's stack
+typedef struct ThreadRegistered {
+  struct ThreadRegistered *next;
+  struct ThreadRegistered *prev;
+  HANDLE handle;
+  uint64_t osThreadId;
+} ThreadRegistered;
+
+static SRWLOCK s_registryLock = SRWLOCK_INIT;
+static ThreadRegistered *s_registryHead;
+static uint32_t s_registryCount;
+
+static void ThreadRegister(ThreadRegistered *self) {
+  // GetCurrentThread is a pseudo handle that means whoever uses it, others need a real one
+  self->handle = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, GetCurrentThreadId());
+  self->osThreadId = GetCurrentThreadId();
+  self->prev = NULL;
+  AcquireSRWLockExclusive(&s_registryLock);
+  self->next = s_registryHead;
+  if (s_registryHead) {
+    s_registryHead->prev = self;
+  }
+  s_registryHead = self;
+  s_registryCount++;
+  ReleaseSRWLockExclusive(&s_registryLock);
+}
+
+static void ThreadUnregister(ThreadRegistered *self) {
+  AcquireSRWLockExclusive(&s_registryLock);
+  if (self->prev) {
+    self->prev->next = self->next;
+  } else {
+    s_registryHead = self->next;
+  }
+  if (self->next) {
+    self->next->prev = self->prev;
+  }
+  s_registryCount--;
+  ReleaseSRWLockExclusive(&s_registryLock);
+  if (self->handle) {
+    CloseHandle(self->handle);
+  }
+}
+
+static void ThreadObjectRun(struct Thread_ThreadObject *object) {
+  object->func(object->param);
+  // the joiner may free the object as soon as it sees this, a wake on a freed
+  // address is harmless
+  if (Thread_AtomicExchange32Explicit(&object->state, 1, Thread_ATOMIC_ACQ_REL) == 2) {
+    Thread_FutexWakeAll(&object->state);
+  }
+}
+
 static DWORD WINAPI FuncTrampoline(void *param) {
-  struct TrampParam *tp = (struct TrampParam *) param;
-  tp->func(tp->param);
-  MEMORY_FREE(tp);
+  ThreadRegistered registered;
+  ThreadRegister(&registered);
+  ThreadObjectRun((struct Thread_ThreadObject *) param);
+  ThreadUnregister(&registered);
+  return 0;
+}
+
+// parks self in the cache, returns the next object or NULL if the thread should exit
+static struct Thread_ThreadObject *ThreadCacheWait(ThreadCached *self) {
+  Thread_AtomicStore32Explicit(&self->wake, 0, Thread_ATOMIC_RELAXED);
+  self->object = NULL;
+  AcquireSRWLockExclusive(&s_cacheLock);
+  if (s_cacheCount >= s_cacheMax) {
+    ReleaseSRWLockExclusive(&s_cacheLock);
+    return NULL;
+  }
+  self->next = s_cacheHead;
+  s_cacheHead = self;
+  s_cacheCount++;
+  ReleaseSRWLockExclusive(&s_cacheLock);
+
+  while (Thread_AtomicLoad32Explicit(&self->wake, Thread_ATOMIC_ACQUIRE) == 0) {
+    Thread_FutexWait(&self->wake, 0, Thread_FUTEX_WAIT_INFINITE);
+  }
+  return self->object;
+}
+
+static void ThreadCachedWake(ThreadCached *cached, struct Thread_ThreadObject *object) {
+  cached->object = object;
+  Thread_AtomicStore32Explicit(&cached->wake, 1, Thread_ATOMIC_RELEASE);
+  Thread_FutexWakeOne(&cached->wake);
+}
+
+static DWORD WINAPI CachedTrampoline(void *param) {
+  ThreadCached *self = (ThreadCached *) param;
+  ThreadRegistered registered;
+  ThreadRegister(&registered);
+  struct Thread_ThreadObject *object = self->object;
+  while (object) {
+    ThreadObjectRun(object);
+    object = ThreadCacheWait(self);
+  }
+  ThreadUnregister(&registered);
+  MEMORY_FREE(self);
   return 0;
 }
 
 AL2O3_EXTERN_C bool Thread_ThreadCreate(Thread_Thread *thread, Thread_JobFunction func, void *data) {
   ASSERT(thread);
-  struct TrampParam *tp = (struct TrampParam *) MEMORY_MALLOC(sizeof(struct TrampParam));
-  tp->func = func;
-  tp->param = data;
-  *thread = CreateThread(0, 0, &FuncTrampoline, tp, 0, 0);
-  
-  return (*thread != NULL);
+  struct Thread_ThreadObject *object = (struct Thread_ThreadObject *) MEMORY_CALLOC(1, sizeof(struct Thread_ThreadObject));
+  if (!object) {
+    return false;
+  }
+  object->func = func;
+  object->param = data;
+
+  AcquireSRWLockExclusive(&s_cacheLock);
+  ThreadCached *cached = s_cacheHead;
+  if (cached) {
+    s_cacheHead = cached->next;
+    s_cacheCount--;
+  }
+  bool const cacheable = s_cacheMax != 0;
+  ReleaseSRWLockExclusive(&s_cacheLock);
+
+  if (cached) {
+    ThreadCachedWake(cached, object);
+    *thread = object;
+    return true;
+  }
+
+  bool created;
+  if (cacheable) {
+    cached = (ThreadCached *) MEMORY_CALLOC(1, sizeof(ThreadCached));
+    created = cached != NULL;
+    if (created) {
+      cached->object = object;
+      HANDLE handle = CreateThread(0, 0, &CachedTrampoline, cached, 0, 0);
+      created = handle != NULL;
+      if (created) {
+        // nobody waits on a cached thread, its handle completion flag does the job
+        CloseHandle(handle);
+      } else {
+        MEMORY_FREE(cached);
+      }
+    }
+  } else {
+    HANDLE const handle = CreateThread(0, 0, &FuncTrampoline, object, 0, 0);
+    Thread_AtomicStorePtrExplicit(&object->handle, handle, Thread_ATOMIC_RELAXED);
+    created = handle != NULL;
+  }
+
+  if (!created) {
+    MEMORY_FREE(object);
+    *thread = NULL;
+    return false;
+  }
+  *thread = object;
+  return true;
 }
 
 AL2O3_EXTERN_C void Thread_ThreadDestroy(Thread_Thread *thread) {
   ASSERT(thread);
-  WaitForSingleObject((HANDLE) *thread, INFINITE);
-  CloseHandle((HANDLE) *thread);
+  if (!*thread) {
+    return;
+  }
+  Thread_ThreadJoin(thread);
+  MEMORY_FREE(*thread);
+  *thread = NULL;
 }
+
 AL2O3_EXTERN_C void Thread_ThreadJoin(Thread_Thread *thread) {
-  WaitForSingleObject((HANDLE) *thread, INFINITE);
+  ASSERT(thread);
+  struct Thread_ThreadObject *object = *thread;
+  ASSERT(object);
+  uint32_t state;
+  while ((state = Thread_AtomicLoad32Explicit(&object->state, Thread_ATOMIC_ACQUIRE)) != 1) {
+    if (state == 0 && !Thread_AtomicCompareExchangeStrong32Explicit(&object->state, &state, 2,
+                                                                    Thread_ATOMIC_ACQUIRE, Thread_ATOMIC_ACQUIRE)) {
+      continue;
+    }
+    Thread_FutexWait(&object->state, 2, Thread_FUTEX_WAIT_INFINITE);
+  }
+  // joins can race, only the one that takes the handle waits on and closes it
+  HANDLE const handle = (HANDLE) Thread_AtomicExchangePtrExplicit(&object->handle, NULL, Thread_ATOMIC_ACQUIRE);
+  if (handle) {
+    WaitForSingleObject(handle, INFINITE);
+    CloseHandle(handle);
+  }
+}
+
+AL2O3_EXTERN_C void Thread_ThreadCacheSetSize(uint32_t maxCachedThreads) {
+  ThreadCached *released = NULL;
+  AcquireSRWLockExclusive(&s_cacheLock);
+  s_cacheMax = maxCachedThreads;
+  while (s_cacheCount > s_cacheMax) {
+    ThreadCached *cached = s_cacheHead;
+    s_cacheHead = cached->next;
+    s_cacheCount--;
+    cached->next = released;
+    released = cached;
+  }
+  ReleaseSRWLockExclusive(&s_cacheLock);
+
+  while (released) {
+    ThreadCached *next = released->next;
+    ThreadCachedWake(released, NULL);
+    released = next;
+  }
+}
+
+AL2O3_EXTERN_C uint32_t Thread_ThreadCacheCount(void) {
+  AcquireSRWLockShared(&s_cacheLock);
+  uint32_t const count = s_cacheCount;
+  ReleaseSRWLockShared(&s_cacheLock);
+  return count;
 }
 
 static bool s_isMainThreadIDSet = false;
@@ -75,7 +282,8 @@ AL2O3_EXTERN_C Thread_ThreadID Thread_GetCurrentThreadID(void) {
   return GetCurrentThreadId();
 }
 AL2O3_EXTERN_C void Thread_SetMainThread(void) {
-  ASSERT(s_isMainThreadIDSet == false);
+  // calling it again is fine, but the main thread can't change
+  ASSERT(s_isMainThreadIDSet == false || Thread_IsMainThread());
   s_mainThreadID = GetCurrentThreadId();
   s_isMainThreadIDSet = true;
 }
@@ -85,11 +293,126 @@ AL2O3_EXTERN_C bool Thread_IsMainThread(void) {
   return Thread_GetCurrentThreadID() == s_mainThreadID;
 }
 
+// a set bit is an index owned by a live thread
+static Thread_Atomic64_t s_threadIndexBitmap[Thread_MAX_THREAD_INDICES / 64];
+static Thread_Atomic32_t s_threadIndexOverflow;
+static DWORD s_threadIndexFls;
+static INIT_ONCE s_threadIndexOnce = INIT_ONCE_STATIC_INIT;
+// index + 1 so zero means not assigned yet
+static __declspec(thread) uint32_t s_threadIndex;
+
+static void WINAPI ThreadIndexRelease(void *value) {
+  uint32_t const index = (uint32_t) (uintptr_t) value - 1;
+  if (index < Thread_MAX_THREAD_INDICES) {
+    // release so the next owner sees everything written to its per thread slots
+    Thread_AtomicFetchAnd64Explicit(&s_threadIndexBitmap[index / 64], ~(1ull << (index % 64)), Thread_ATOMIC_RELEASE);
+  }
+}
+
+static BOOL CALLBACK ThreadIndexInit(PINIT_ONCE initOnce, void *param, void **context) {
+  s_threadIndexFls = FlsAlloc(&ThreadIndexRelease);
+  return TRUE;
+}
+
+static uint32_t ThreadIndexAcquire(void) {
+  for (uint32_t i = 0; i < Thread_MAX_THREAD_INDICES / 64; ++i) {
+    uint64_t bits = Thread_AtomicLoad64Explicit(&s_threadIndexBitmap[i], Thread_ATOMIC_RELAXED);
+    while (bits != ~0ull) {
+      unsigned long bit;
+      _BitScanForward64(&bit, ~bits);
+      if (Thread_AtomicCompareExchangeWeak64Explicit(&s_threadIndexBitmap[i],
+                                                     &bits,
+                                                     bits | (1ull << bit),
+                                                     Thread_ATOMIC_ACQUIRE,
+                                                     Thread_ATOMIC_RELAXED)) {
+        return i * 64 + bit;
+      }
+    }
+  }
+  // out of unique indices, hand out shared ones past the end
+  return Thread_MAX_THREAD_INDICES + Thread_AtomicFetchAdd32Explicit(&s_threadIndexOverflow, 1, Thread_ATOMIC_RELAXED) % Thread_MAX_THREAD_INDICES;
+}
+
+AL2O3_EXTERN_C uint32_t Thread_GetCurrentThreadIndex(void) {
+  if (s_threadIndex == 0) {
+    InitOnceExecuteOnce(&s_threadIndexOnce, &ThreadIndexInit, NULL, NULL);
+    s_threadIndex = ThreadIndexAcquire() + 1;
+    FlsSetValue(s_threadIndexFls, (void *) (uintptr_t) s_threadIndex);
+  }
+  return s_threadIndex - 1;
+}
+
 AL2O3_EXTERN_C void Thread_Sleep(uint64_t waitms) {
   Sleep((DWORD) waitms);
 }
+
+AL2O3_EXTERN_C void Thread_Yield(void) {
+  SwitchToThread();
+}
+
+AL2O3_EXTERN_C uint64_t Thread_MonotonicNs(void) {
+  static LARGE_INTEGER frequency;
+  if (frequency.QuadPart == 0) {
+    QueryPerformanceFrequency(&frequency);
+  }
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  // split to keep the multiply from overflowing
+  uint64_t const seconds = (uint64_t) (counter.QuadPart / frequency.QuadPart);
+  uint64_t const remainder = (uint64_t) (counter.QuadPart % frequency.QuadPart);
+  return seconds * 1000000000ull + remainder * 1000000000ull / (uint64_t) frequency.QuadPart;
+}
 AL2O3_EXTERN_C uint32_t Thread_CPUCoreCount(void) {
   SYSTEM_INFO systemInfo;
   GetSystemInfo(&systemInfo);
   return systemInfo.dwNumberOfProcessors;
-}
\ No newline at end of file
+}
+
+AL2O3_EXTERN_C uint32_t Thread_CPUUsableCoreCount(void) {
+  DWORD_PTR processMask;
+  DWORD_PTR systemMask;
+  if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask) && processMask != 0) {
+    uint32_t count = 0;
+    for (; processMask; processMask &= processMask - 1) {
+      ++count;
+    }
+    return count;
+  }
+  return Thread_CPUCoreCount();
+}
+// windows keeps no per thread context switch counts outside of the kernel
+// debugging interfaces, so those stay 0
+static void ThreadStatsSample(HANDLE handle, uint64_t osThreadId, Thread_ThreadStats *stats) {
+  memset(stats, 0, sizeof(Thread_ThreadStats));
+  stats->osThreadId = osThreadId;
+  stats->cpu = -1;
+  FILETIME creation, exit, kernel, user;
+  if (handle && GetThreadTimes(handle, &creation, &exit, &kernel, &user)) {
+    // 100ns units
+    uint64_t const kernelTime = ((uint64_t) kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+    uint64_t const userTime = ((uint64_t) user.dwHighDateTime << 32) | user.dwLowDateTime;
+    stats->cpuTimeNs = (kernelTime + userTime) * 100;
+  }
+}
+
+AL2O3_EXTERN_C uint64_t Thread_StatsCurrentOSThreadID(void) {
+  return GetCurrentThreadId();
+}
+
+AL2O3_EXTERN_C void Thread_StatsGetCurrent(Thread_ThreadStats *stats) {
+  ASSERT(stats);
+  ThreadStatsSample(GetCurrentThread(), GetCurrentThreadId(), stats);
+  stats->cpu = (int32_t) GetCurrentProcessorNumber();
+}
+
+AL2O3_EXTERN_C uint32_t Thread_StatsGetAll(Thread_ThreadStats *stats, uint32_t maxCount) {
+  ASSERT(stats || maxCount == 0);
+  AcquireSRWLockShared(&s_registryLock);
+  uint32_t const count = s_registryCount;
+  uint32_t written = 0;
+  for (ThreadRegistered *registered = s_registryHead; registered && written < maxCount; registered = registered->next) {
+    ThreadStatsSample(registered->handle, registered->osThreadId, &stats[written++]);
+  }
+  ReleaseSRWLockShared(&s_registryLock);
+  return count;
+}
@@ -0,0 +1,131 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/barrier.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/mpsc.h"
+#include "al2o3_thread/actor.h"
+
+#define PRODUCER_COUNT 4
+#define NODES_PER_PRODUCER 10000
+
+typedef struct TestNode {
+	Thread_MPSCNode node; // first so a node pointer is a TestNode pointer
+	uint32_t producer;
+	uint32_t sequence;
+} TestNode;
+
+static Thread_MPSCQueue s_queue;
+static TestNode s_nodes[PRODUCER_COUNT][NODES_PER_PRODUCER];
+
+static void Producer(void *data) {
+	uint32_t const producer = (uint32_t) (uintptr_t) data;
+	for (uint32_t i = 0; i < NODES_PER_PRODUCER; ++i) {
+		s_nodes[producer][i].producer = producer;
+		s_nodes[producer][i].sequence = i;
+		Thread_MPSCQueuePush(&s_queue, &s_nodes[producer][i].node);
+	}
+}
+
+TEST_CASE("MPSC queue", "[al2o3 thread]") {
+	REQUIRE(Thread_MPSCQueueCreate(&s_queue));
+	REQUIRE(Thread_MPSCQueuePop(&s_queue) == NULL);
+
+	Thread_Thread threads[PRODUCER_COUNT];
+	for (uint32_t i = 0; i < PRODUCER_COUNT; ++i) {
+		REQUIRE(Thread_ThreadCreate(&threads[i], &Producer, (void *) (uintptr_t) i));
+	}
+	// each producer's nodes come out in the order it pushed them
+	uint32_t next[PRODUCER_COUNT] = {};
+	uint32_t popped = 0;
+	bool ordered = true;
+	while (popped < PRODUCER_COUNT * NODES_PER_PRODUCER) {
+		TestNode *node = (TestNode *) Thread_MPSCQueuePop(&s_queue);
+		if (!node) {
+			Thread_AtomicPause();
+			continue;
+		}
+		ordered &= node->sequence == next[node->producer];
+		next[node->producer] = node->sequence + 1;
+		popped++;
+	}
+	for (uint32_t i = 0; i < PRODUCER_COUNT; ++i) {
+		Thread_ThreadDestroy(&threads[i]);
+	}
+	REQUIRE(ordered);
+	REQUIRE(Thread_MPSCQueuePop(&s_queue) == NULL);
+
+	// empty then refilled reuses the stub
+	Thread_MPSCQueuePush(&s_queue, &s_nodes[0][0].node);
+	REQUIRE(Thread_MPSCQueuePop(&s_queue) == &s_nodes[0][0].node);
+	REQUIRE(Thread_MPSCQueuePop(&s_queue) == NULL);
+	Thread_MPSCQueueDestroy(&s_queue);
+}
+
+#define ACTOR_COUNT 1000
+#define MESSAGES_PER_SENDER 4
+#define SENDER_COUNT 64
+
+typedef struct TestActor {
+	Thread_Actor actor;
+	Thread_Atomic32_t inside;
+	uint32_t handled; // only touched by the handler
+	bool overlapped;
+} TestActor;
+
+typedef struct TestMessage {
+	Thread_MPSCNode node;
+} TestMessage;
+
+static TestActor s_actors[ACTOR_COUNT];
+static TestMessage s_messages[SENDER_COUNT][ACTOR_COUNT][MESSAGES_PER_SENDER];
+static Thread_CountdownEvent s_handledAll;
+
+static void Handler(Thread_Actor *actor, Thread_MPSCNode *message) {
+	TestActor *self = (TestActor *) actor->userData;
+	if (Thread_AtomicFetchAdd32Explicit(&self->inside, 1, Thread_ATOMIC_ACQUIRE) != 0) {
+		self->overlapped = true;
+	}
+	self->handled++;
+	Thread_AtomicFetchSub32Explicit(&self->inside, 1, Thread_ATOMIC_RELEASE);
+	Thread_CountdownEventSignal(&s_handledAll, 1);
+}
+
+static void Sender(void *data) {
+	uint32_t const sender = (uint32_t) (uintptr_t) data;
+	for (uint32_t j = 0; j < MESSAGES_PER_SENDER; ++j) {
+		for (uint32_t i = 0; i < ACTOR_COUNT; ++i) {
+			Thread_ActorSend(&s_actors[i].actor, &s_messages[sender][i][j].node);
+		}
+	}
+}
+
+TEST_CASE("Actors", "[al2o3 thread]") {
+	Thread_PoolHandle pool = Thread_PoolCreate(NULL);
+	REQUIRE(pool);
+	REQUIRE(Thread_CountdownEventCreate(&s_handledAll, SENDER_COUNT * ACTOR_COUNT * MESSAGES_PER_SENDER));
+	for (uint32_t i = 0; i < ACTOR_COUNT; ++i) {
+		Thread_AtomicStore32Relaxed(&s_actors[i].inside, 0);
+		s_actors[i].handled = 0;
+		s_actors[i].overlapped = false;
+		// small batches so actors get rescheduled
+		REQUIRE(Thread_ActorCreate(&s_actors[i].actor, pool, &Handler, &s_actors[i], 3));
+	}
+	for (uint32_t i = 0; i < SENDER_COUNT; ++i) {
+		Thread_PoolSubmit(pool, &Sender, (void *) (uintptr_t) i);
+	}
+	Thread_CountdownEventWait(&s_handledAll);
+	Thread_PoolDestroy(pool);
+
+	bool overlapped = false;
+	bool allHandled = true;
+	for (uint32_t i = 0; i < ACTOR_COUNT; ++i) {
+		overlapped |= s_actors[i].overlapped;
+		allHandled &= s_actors[i].handled == SENDER_COUNT * MESSAGES_PER_SENDER;
+		REQUIRE(Thread_ActorPendingCount(&s_actors[i].actor) == 0);
+		Thread_ActorDestroy(&s_actors[i].actor);
+	}
+	REQUIRE(!overlapped);
+	REQUIRE(allHandled);
+	Thread_CountdownEventDestroy(&s_handledAll);
+}
@@ -0,0 +1,205 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/barrier.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/asyncio.h"
+#include <stdio.h>
+#include <string.h>
+#if AL2O3_PLATFORM == AL2O3_PLATFORM_WINDOWS
+#include <io.h>
+#endif
+
+#define BLOCK_SIZE 4096
+#define BLOCK_COUNT 64
+
+static Thread_CountdownEvent s_ioDone;
+static Thread_Atomic32_t s_ioErrors;
+static Thread_Atomic32_t s_offPool;
+static Thread_PoolHandle s_ioPool;
+
+static void IOContinuation(void *data) {
+	Thread_AsyncIORequest *request = (Thread_AsyncIORequest *) data;
+	if (request->result != request->size) {
+		Thread_AtomicFetchAdd32Explicit(&s_ioErrors, 1, Thread_ATOMIC_RELAXED);
+	}
+	if (s_ioPool && Thread_PoolGetCurrent() != s_ioPool) {
+		Thread_AtomicFetchAdd32Explicit(&s_offPool, 1, Thread_ATOMIC_RELAXED);
+	}
+	Thread_CountdownEventSignal(&s_ioDone, 1);
+}
+
+static intptr_t FileOf(FILE *file) {
+#if AL2O3_PLATFORM == AL2O3_PLATFORM_WINDOWS
+	return (intptr_t) _get_osfhandle(_fileno(file));
+#else
+	return (intptr_t) fileno(file);
+#endif
+}
+
+static void TransferAll(Thread_AsyncIOHandle io, Thread_AsyncIOOp op, intptr_t file, uint8_t *memory, int32_t bufferIndex) {
+	static Thread_AsyncIORequest requests[BLOCK_COUNT];
+	Thread_AsyncIORequest *batch[BLOCK_COUNT];
+	Thread_CountdownEventReset(&s_ioDone, BLOCK_COUNT);
+	for (uint32_t i = 0; i < BLOCK_COUNT; ++i) {
+		memset(&requests[i], 0, sizeof(Thread_AsyncIORequest));
+		requests[i].op = op;
+		requests[i].file = file;
+		requests[i].buffer = memory + i * BLOCK_SIZE;
+		requests[i].offset = (uint64_t) i * BLOCK_SIZE;
+		requests[i].size = BLOCK_SIZE;
+		requests[i].bufferIndex = bufferIndex;
+		requests[i].continuation = &IOContinuation;
+		batch[i] = &requests[i];
+	}
+	// two batches to cover more than one submission
+	Thread_AsyncIOSubmit(io, batch, BLOCK_COUNT / 2);
+	Thread_AsyncIOSubmit(io, batch + BLOCK_COUNT / 2, BLOCK_COUNT / 2);
+	Thread_CountdownEventWait(&s_ioDone);
+}
+
+static void RoundTrip(bool forceFallback, bool usePool, bool registerBuffers) {
+	s_ioPool = usePool ? Thread_PoolCreate(NULL) : NULL;
+	Thread_AsyncIODesc desc = {};
+	desc.pool = s_ioPool;
+	desc.forceFallback = forceFallback;
+	Thread_AsyncIOHandle io = Thread_AsyncIOCreate(&desc);
+	REQUIRE(io);
+	if (forceFallback) {
+		REQUIRE(!Thread_AsyncIOIsUring(io));
+	}
+
+	static uint8_t source[BLOCK_SIZE * BLOCK_COUNT];
+	static uint8_t dest[BLOCK_SIZE * BLOCK_COUNT];
+	for (uint32_t i = 0; i < sizeof(source); ++i) {
+		source[i] = (uint8_t) (i * 31 + i / BLOCK_SIZE);
+	}
+	memset(dest, 0, sizeof(dest));
+	int32_t bufferIndex = -1;
+	if (registerBuffers) {
+		void *buffers[] = {source, dest};
+		size_t sizes[] = {sizeof(source), sizeof(dest)};
+		// locked memory limits can refuse this, the unregistered path still runs
+		if (Thread_AsyncIORegisterBuffers(io, buffers, sizes, 2)) {
+			bufferIndex = 0;
+		}
+	}
+
+	FILE *file = tmpfile();
+	REQUIRE(file);
+	REQUIRE(Thread_CountdownEventCreate(&s_ioDone, 0));
+	Thread_AtomicStore32Relaxed(&s_ioErrors, 0);
+	Thread_AtomicStore32Relaxed(&s_offPool, 0);
+
+	TransferAll(io, Thread_ASYNCIO_WRITE, FileOf(file), source, bufferIndex);
+	TransferAll(io, Thread_ASYNCIO_READ, FileOf(file), dest, bufferIndex < 0 ? -1 : 1);
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_ioErrors) == 0);
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_offPool) == 0);
+	REQUIRE(memcmp(source, dest, sizeof(source)) == 0);
+
+	Thread_AsyncIODestroy(io);
+	Thread_PoolDestroy(s_ioPool);
+	Thread_CountdownEventDestroy(&s_ioDone);
+	fclose(file);
+}
+
+TEST_CASE("Async IO round trip", "[al2o3 thread]") {
+	RoundTrip(false, true, false);
+	RoundTrip(false, false, false);
+	RoundTrip(false, true, true);
+}
+
+TEST_CASE("Async IO blocking fallback", "[al2o3 thread]") {
+	RoundTrip(true, true, false);
+	RoundTrip(true, false, true);
+}
+
+static void ReadPastEnd(void *data) {
+	Thread_CountdownEventSignal(&s_ioDone, 1);
+}
+
+TEST_CASE("Async IO short and failed transfers", "[al2o3 thread]") {
+	Thread_AsyncIOHandle io = Thread_AsyncIOCreate(NULL);
+	REQUIRE(io);
+	REQUIRE(Thread_CountdownEventCreate(&s_ioDone, 2));
+	FILE *file = tmpfile();
+	REQUIRE(file);
+
+	static uint8_t buffer[16];
+	Thread_AsyncIORequest eof = {};
+	eof.op = Thread_ASYNCIO_READ;
+	eof.file = FileOf(file);
+	eof.buffer = buffer;
+	eof.size = sizeof(buffer);
+	eof.offset = 1024;
+	eof.bufferIndex = -1;
+	eof.continuation = &ReadPastEnd;
+	Thread_AsyncIORequest bad = eof;
+	bad.file = -1;
+	Thread_AsyncIORequest *batch[] = {&eof, &bad};
+	Thread_AsyncIOSubmit(io, batch, 2);
+	Thread_CountdownEventWait(&s_ioDone);
+	REQUIRE(eof.result == 0);
+	REQUIRE(bad.result < 0);
+
+	Thread_AsyncIODestroy(io);
+	Thread_CountdownEventDestroy(&s_ioDone);
+	fclose(file);
+}
+
+// more than the old fallback pool's queue held
+#define FLOOD_COUNT 5000
+
+static Thread_Latch s_floodGate;
+static uint32_t s_floodSubmitter;
+static Thread_Atomic32_t s_floodOnSubmitter;
+
+static void FloodGated(void *data) {
+	Thread_LatchWait(&s_floodGate);
+	Thread_CountdownEventSignal(&s_ioDone, 1);
+}
+
+static void FloodCount(void *data) {
+	if (Thread_GetCurrentThreadIndex() == s_floodSubmitter) {
+		Thread_AtomicFetchAdd32Explicit(&s_floodOnSubmitter, 1, Thread_ATOMIC_RELAXED);
+	}
+	Thread_CountdownEventSignal(&s_ioDone, 1);
+}
+
+TEST_CASE("Async IO fallback queues without doing the transfer on submit", "[al2o3 thread]") {
+	Thread_AsyncIODesc desc = {};
+	desc.forceFallback = true;
+	desc.fallbackThreads = 2;
+	Thread_AsyncIOHandle io = Thread_AsyncIOCreate(&desc);
+	REQUIRE(io);
+	FILE *file = tmpfile();
+	REQUIRE(file);
+	REQUIRE(Thread_LatchCreate(&s_floodGate, 1));
+	REQUIRE(Thread_CountdownEventCreate(&s_ioDone, FLOOD_COUNT));
+	s_floodSubmitter = Thread_GetCurrentThreadIndex();
+	Thread_AtomicStore32Relaxed(&s_floodOnSubmitter, 0);
+
+	static uint8_t buffer[16];
+	static Thread_AsyncIORequest requests[FLOOD_COUNT];
+	static Thread_AsyncIORequest *batch[FLOOD_COUNT];
+	for (uint32_t i = 0; i < FLOOD_COUNT; ++i) {
+		memset(&requests[i], 0, sizeof(Thread_AsyncIORequest));
+		requests[i].op = Thread_ASYNCIO_READ;
+		requests[i].file = FileOf(file);
+		requests[i].buffer = buffer;
+		requests[i].size = sizeof(buffer);
+		requests[i].bufferIndex = -1;
+		// the first ones hold both I/O threads until everything is queued
+		requests[i].continuation = i < desc.fallbackThreads ? &FloodGated : &FloodCount;
+		batch[i] = &requests[i];
+	}
+	Thread_AsyncIOSubmit(io, batch, FLOOD_COUNT);
+	Thread_LatchCountDown(&s_floodGate, 1);
+	Thread_CountdownEventWait(&s_ioDone);
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_floodOnSubmitter) == 0);
+
+	Thread_AsyncIODestroy(io);
+	Thread_LatchDestroy(&s_floodGate);
+	Thread_CountdownEventDestroy(&s_ioDone);
+	fclose(file);
+}
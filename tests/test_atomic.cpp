@@ -0,0 +1,207 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/atomic.hpp"
+#include <string.h>
+
+TEST_CASE("Explicit atomics single thread", "[al2o3 thread]") {
+	Thread_Atomic32_t a32;
+	Thread_AtomicStore32Explicit(&a32, 10, Thread_ATOMIC_SEQ_CST);
+	REQUIRE(Thread_AtomicLoad32Explicit(&a32, Thread_ATOMIC_ACQUIRE) == 10);
+	REQUIRE(Thread_AtomicFetchSub32Explicit(&a32, 3, Thread_ATOMIC_ACQ_REL) == 10);
+	REQUIRE(Thread_AtomicFetchXor32Explicit(&a32, 0xF, Thread_ATOMIC_RELEASE) == 7);
+	REQUIRE(Thread_AtomicLoad32Explicit(&a32, Thread_ATOMIC_RELAXED) == 8);
+
+	uint32_t expected = 5;
+	REQUIRE(!Thread_AtomicCompareExchangeStrong32Explicit(&a32, &expected, 20, Thread_ATOMIC_ACQ_REL, Thread_ATOMIC_ACQUIRE));
+	REQUIRE(expected == 8);
+	REQUIRE(Thread_AtomicCompareExchangeStrong32Explicit(&a32, &expected, 20, Thread_ATOMIC_ACQ_REL, Thread_ATOMIC_ACQUIRE));
+	REQUIRE(Thread_AtomicLoad32Explicit(&a32, Thread_ATOMIC_SEQ_CST) == 20);
+
+	expected = 20;
+	while (!Thread_AtomicCompareExchangeWeak32Explicit(&a32, &expected, 21, Thread_ATOMIC_RELEASE, Thread_ATOMIC_RELAXED)) {
+		REQUIRE(expected == 20);
+	}
+	REQUIRE(Thread_AtomicExchange32Explicit(&a32, 4, Thread_ATOMIC_SEQ_CST) == 21);
+
+	REQUIRE(Thread_AtomicFetchMin32Explicit(&a32, 6, Thread_ATOMIC_RELAXED) == 4);
+	REQUIRE(Thread_AtomicLoad32Explicit(&a32, Thread_ATOMIC_RELAXED) == 4);
+	REQUIRE(Thread_AtomicFetchMin32Explicit(&a32, 2, Thread_ATOMIC_RELAXED) == 4);
+	REQUIRE(Thread_AtomicFetchMax32Explicit(&a32, 9, Thread_ATOMIC_RELAXED) == 2);
+	REQUIRE(Thread_AtomicLoad32Explicit(&a32, Thread_ATOMIC_RELAXED) == 9);
+
+	Thread_Atomic8_t a8;
+	Thread_AtomicStore8Explicit(&a8, 0xFF, Thread_ATOMIC_RELAXED);
+	REQUIRE(Thread_AtomicFetchAdd8Explicit(&a8, 1, Thread_ATOMIC_SEQ_CST) == 0xFF);
+	REQUIRE(Thread_AtomicLoad8Explicit(&a8, Thread_ATOMIC_CONSUME) == 0);
+
+	Thread_Atomic64_t a64;
+	Thread_AtomicStore64Explicit(&a64, 1ull << 40, Thread_ATOMIC_RELEASE);
+	REQUIRE(Thread_AtomicFetchMax64Explicit(&a64, 1ull << 41, Thread_ATOMIC_ACQ_REL) == 1ull << 40);
+	REQUIRE(Thread_AtomicFetchAnd64Explicit(&a64, 0, Thread_ATOMIC_ACQ_REL) == 1ull << 41);
+
+	int values[2];
+	Thread_AtomicPtr_t ptr;
+	Thread_AtomicStorePtrExplicit(&ptr, &values[0], Thread_ATOMIC_RELEASE);
+	void *expectedPtr = &values[1];
+	REQUIRE(!Thread_AtomicCompareExchangeStrongPtrExplicit(&ptr, &expectedPtr, NULL, Thread_ATOMIC_SEQ_CST, Thread_ATOMIC_SEQ_CST));
+	REQUIRE(expectedPtr == &values[0]);
+	REQUIRE(Thread_AtomicFetchAddPtrExplicit(&ptr, sizeof(int), Thread_ATOMIC_ACQ_REL) == &values[0]);
+	REQUIRE(Thread_AtomicLoadPtrExplicit(&ptr, Thread_ATOMIC_ACQUIRE) == &values[1]);
+	Thread_AtomicThreadFenceExplicit(Thread_ATOMIC_SEQ_CST);
+}
+
+static Thread_Atomic64_t s_counter;
+static Thread_Atomic64_t s_maximum;
+
+static void CountJob(void *data) {
+	uint64_t const base = (uint64_t) data;
+	for (uint64_t i = 0; i < 10000; ++i) {
+		Thread_AtomicFetchAdd64Explicit(&s_counter, 1, Thread_ATOMIC_RELAXED);
+		Thread_AtomicFetchMax64Explicit(&s_maximum, base + i, Thread_ATOMIC_RELAXED);
+	}
+}
+
+TEST_CASE("Explicit atomics multi thread", "[al2o3 thread]") {
+	Thread_AtomicStore64Explicit(&s_counter, 0, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore64Explicit(&s_maximum, 0, Thread_ATOMIC_RELAXED);
+
+	Thread_Thread threads[4];
+	for (uint64_t i = 0; i < 4; ++i) {
+		REQUIRE(Thread_ThreadCreate(&threads[i], &CountJob, (void *) (i * 100000)));
+	}
+	for (uint64_t i = 0; i < 4; ++i) {
+		Thread_ThreadDestroy(&threads[i]);
+	}
+	REQUIRE(Thread_AtomicLoad64Explicit(&s_counter, Thread_ATOMIC_ACQUIRE) == 40000);
+	REQUIRE(Thread_AtomicLoad64Explicit(&s_maximum, Thread_ATOMIC_ACQUIRE) == 309999);
+}
+
+static platform_uint128_t Make128(uint64_t lo, uint64_t hi) {
+	uint64_t halves[2] = { lo, hi };
+	platform_uint128_t result;
+	memcpy(&result, halves, sizeof(result));
+	return result;
+}
+static void Split128(platform_uint128_t value, uint64_t *lo, uint64_t *hi) {
+	uint64_t halves[2];
+	memcpy(halves, &value, sizeof(halves));
+	*lo = halves[0];
+	*hi = halves[1];
+}
+
+TEST_CASE("128 bit atomics single thread", "[al2o3 thread]") {
+	Thread_Atomic128_t a;
+	Thread_AtomicStore128(&a, Make128(1, 2), Thread_MEMORY_ORDER_RELEASE);
+
+	uint64_t lo, hi;
+	Split128(Thread_AtomicLoad128(&a, Thread_MEMORY_ORDER_ACQUIRE), &lo, &hi);
+	REQUIRE(lo == 1);
+	REQUIRE(hi == 2);
+
+	platform_uint128_t expected = Make128(3, 4);
+	REQUIRE(!Thread_AtomicCompareExchangeWeak128(&a, &expected, Make128(5, 6), Thread_MEMORY_ORDER_ACQ_REL));
+	Split128(expected, &lo, &hi);
+	REQUIRE(lo == 1);
+	REQUIRE(hi == 2);
+	while (!Thread_AtomicCompareExchangeWeak128(&a, &expected, Make128(5, 6), Thread_MEMORY_ORDER_ACQ_REL)) {
+	}
+
+	Split128(Thread_AtomicExchange128(&a, Make128(7, 8), Thread_MEMORY_ORDER_ACQ_REL), &lo, &hi);
+	REQUIRE(lo == 5);
+	REQUIRE(hi == 6);
+	Split128(Thread_AtomicLoad128Relaxed(&a), &lo, &hi);
+	REQUIRE(lo == 7);
+	REQUIRE(hi == 8);
+}
+
+static Thread_Atomic128_t s_pair;
+static Thread_Atomic32_t s_tornReads;
+
+static void PairWriterJob(void *data) {
+	for (uint64_t i = 0; i < 10000; ++i) {
+		platform_uint128_t expected = Thread_AtomicLoad128Relaxed(&s_pair);
+		uint64_t lo, hi;
+		do {
+			Split128(expected, &lo, &hi);
+		} while (!Thread_AtomicCompareExchangeWeak128(&s_pair, &expected, Make128(lo + 1, hi + 1), Thread_MEMORY_ORDER_ACQ_REL));
+	}
+}
+
+static void PairReaderJob(void *data) {
+	for (uint64_t i = 0; i < 10000; ++i) {
+		uint64_t lo, hi;
+		Split128(Thread_AtomicLoad128(&s_pair, Thread_MEMORY_ORDER_ACQUIRE), &lo, &hi);
+		if (lo != hi) {
+			Thread_AtomicFetchAdd32Explicit(&s_tornReads, 1, Thread_ATOMIC_RELAXED);
+		}
+	}
+}
+
+TEST_CASE("128 bit atomics multi thread", "[al2o3 thread]") {
+	Thread_AtomicStore128Relaxed(&s_pair, Make128(0, 0));
+	Thread_AtomicStore32Explicit(&s_tornReads, 0, Thread_ATOMIC_RELAXED);
+
+	Thread_Thread threads[4];
+	REQUIRE(Thread_ThreadCreate(&threads[0], &PairWriterJob, NULL));
+	REQUIRE(Thread_ThreadCreate(&threads[1], &PairWriterJob, NULL));
+	REQUIRE(Thread_ThreadCreate(&threads[2], &PairReaderJob, NULL));
+	REQUIRE(Thread_ThreadCreate(&threads[3], &PairReaderJob, NULL));
+	for (uint32_t i = 0; i < 4; ++i) {
+		Thread_ThreadDestroy(&threads[i]);
+	}
+
+	uint64_t lo, hi;
+	Split128(Thread_AtomicLoad128Relaxed(&s_pair), &lo, &hi);
+	REQUIRE(lo == 20000);
+	REQUIRE(hi == 20000);
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_tornReads, Thread_ATOMIC_RELAXED) == 0);
+}
+
+struct TestPair {
+	uint64_t a;
+	uint64_t b;
+};
+
+TEST_CASE("Thread::Atomic<T>", "[al2o3 thread]") {
+	Thread::Atomic<int32_t> i32(5);
+	REQUIRE(i32.Load<Thread_ATOMIC_ACQUIRE>() == 5);
+	REQUIRE(i32++ == 5);
+	REQUIRE(++i32 == 7);
+	REQUIRE((i32 -= 10) == -3);
+	REQUIRE(i32.FetchMin<Thread_ATOMIC_RELAXED>(-8) == -3);
+	REQUIRE(i32.FetchMax(4) == -8);
+	REQUIRE(i32 == 4);
+	int32_t expected = 3;
+	REQUIRE(!i32.CompareExchangeStrong<Thread_ATOMIC_ACQ_REL>(expected, 9));
+	REQUIRE(expected == 4);
+	REQUIRE(i32.CompareExchangeStrong<Thread_ATOMIC_ACQ_REL>(expected, 9));
+	REQUIRE(i32.Exchange<Thread_ATOMIC_RELEASE>(1) == 9);
+
+	Thread::Atomic<uint8_t> u8(0xF0);
+	REQUIRE((u8 |= 0x0F) == 0xFF);
+	REQUIRE((u8 ^= 0xF0) == 0x0F);
+	REQUIRE((u8 &= 0x03) == 0x03);
+
+	Thread::Atomic<bool> flag(false);
+	flag = true;
+	REQUIRE(flag.Load<Thread_ATOMIC_ACQUIRE>());
+
+	int values[4] = {};
+	Thread::Atomic<int *> ptr(&values[0]);
+	REQUIRE(ptr++ == &values[0]);
+	REQUIRE((ptr += 2) == &values[3]);
+	REQUIRE(--ptr == &values[2]);
+
+	Thread::Atomic<TestPair> pair(TestPair{1, 2});
+	TestPair observed = pair.Load<Thread_ATOMIC_ACQUIRE>();
+	REQUIRE(observed.a == 1);
+	REQUIRE(observed.b == 2);
+	TestPair wrong = {3, 4};
+	REQUIRE(!pair.CompareExchangeStrong(wrong, TestPair{5, 6}));
+	REQUIRE(wrong.a == 1);
+	REQUIRE(pair.CompareExchangeStrong(wrong, TestPair{5, 6}));
+	REQUIRE(pair.Exchange(TestPair{7, 8}).b == 6);
+	pair.Store<Thread_ATOMIC_RELEASE>(TestPair{9, 10});
+	REQUIRE(TestPair(pair).a == 9);
+}
@@ -0,0 +1,95 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/futex.h"
+#include "al2o3_thread/barrier.hpp"
+
+#define PHASE_THREADS 4
+#define PHASE_COUNT 200
+
+static Thread_Barrier s_barrier;
+static Thread_Atomic32_t s_phaseCounts[PHASE_COUNT];
+static Thread_Atomic32_t s_serialCount;
+static Thread_Atomic32_t s_phaseErrors;
+
+static void PhaseJob(void *data) {
+	for (uint32_t phase = 0; phase < PHASE_COUNT; ++phase) {
+		Thread_AtomicFetchAdd32Explicit(&s_phaseCounts[phase], 1, Thread_ATOMIC_RELAXED);
+		if (Thread_BarrierWait(&s_barrier)) {
+			Thread_AtomicFetchAdd32Explicit(&s_serialCount, 1, Thread_ATOMIC_RELAXED);
+		}
+		// everyone must have finished this phase before anyone leaves the barrier
+		if (Thread_AtomicLoad32Explicit(&s_phaseCounts[phase], Thread_ATOMIC_RELAXED) != PHASE_THREADS) {
+			Thread_AtomicFetchAdd32Explicit(&s_phaseErrors, 1, Thread_ATOMIC_RELAXED);
+		}
+	}
+}
+
+TEST_CASE("Barrier", "[al2o3 thread]") {
+	REQUIRE(Thread_BarrierCreate(&s_barrier, PHASE_THREADS));
+	for (uint32_t i = 0; i < PHASE_COUNT; ++i) {
+		Thread_AtomicStore32Relaxed(&s_phaseCounts[i], 0);
+	}
+	Thread_AtomicStore32Relaxed(&s_serialCount, 0);
+	Thread_AtomicStore32Relaxed(&s_phaseErrors, 0);
+
+	Thread_Thread threads[PHASE_THREADS];
+	for (uint32_t i = 0; i < PHASE_THREADS; ++i) {
+		REQUIRE(Thread_ThreadCreate(&threads[i], &PhaseJob, NULL));
+	}
+	for (uint32_t i = 0; i < PHASE_THREADS; ++i) {
+		Thread_ThreadDestroy(&threads[i]);
+	}
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_serialCount) == PHASE_COUNT);
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_phaseErrors) == 0);
+	Thread_BarrierDestroy(&s_barrier);
+}
+
+static void LatchJob(void *data) {
+	Thread::CountdownEventSignalGuard guard(*(Thread::CountdownEvent *) data);
+	Thread_Sleep(1);
+}
+
+static void LatchWaitJob(void *data) {
+	((Thread::Latch *) data)->ArriveAndWait();
+}
+
+TEST_CASE("Latch and countdown event", "[al2o3 thread]") {
+	Thread::Latch latch(3);
+	REQUIRE(!latch.TryWait());
+	Thread_Thread threads[2];
+	for (uint32_t i = 0; i < 2; ++i) {
+		REQUIRE(Thread_ThreadCreate(&threads[i], &LatchWaitJob, &latch));
+	}
+	latch.ArriveAndWait();
+	REQUIRE(latch.TryWait());
+	for (uint32_t i = 0; i < 2; ++i) {
+		Thread_ThreadDestroy(&threads[i]);
+	}
+
+	Thread::CountdownEvent event;
+	REQUIRE(event.IsSet());
+	Thread_Thread workers[4];
+	for (uint32_t i = 0; i < 4; ++i) {
+		event.Add();
+		REQUIRE(Thread_ThreadCreate(&workers[i], &LatchJob, &event));
+	}
+	event.Wait();
+	REQUIRE(event.IsSet());
+	for (uint32_t i = 0; i < 4; ++i) {
+		Thread_ThreadDestroy(&workers[i]);
+	}
+	event.Reset(1);
+	REQUIRE(!event.IsSet());
+	REQUIRE(event.Signal());
+}
+
+TEST_CASE("Futex", "[al2o3 thread]") {
+	Thread_Atomic32_t word;
+	Thread_AtomicStore32Relaxed(&word, 1);
+	// value mismatch returns straight away, a timeout reports false
+	REQUIRE(Thread_FutexWait(&word, 0, Thread_FUTEX_WAIT_INFINITE));
+	REQUIRE(!Thread_FutexWait(&word, 1, 1000000));
+	Thread_FutexWakeOne(&word);
+	Thread_FutexWakeAll(&word);
+}
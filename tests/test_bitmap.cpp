@@ -0,0 +1,154 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/bitmap.h"
+#include <stdlib.h>
+
+static void FillAndDrain(uint32_t capacity) {
+	Thread_AtomicBitmapHandle bitmap = Thread_AtomicBitmapCreate(capacity);
+	REQUIRE(bitmap);
+	REQUIRE(Thread_AtomicBitmapCapacity(bitmap) == capacity);
+
+	bool *seen = (bool *) calloc(capacity, sizeof(bool));
+	for (uint32_t i = 0; i < capacity; ++i) {
+		uint32_t index = ~0u;
+		REQUIRE(Thread_AtomicBitmapAcquire(bitmap, &index));
+		REQUIRE(index < capacity);
+		REQUIRE(!seen[index]);
+		REQUIRE(Thread_AtomicBitmapIsSet(bitmap, index));
+		seen[index] = true;
+	}
+	uint32_t index;
+	REQUIRE(!Thread_AtomicBitmapAcquire(bitmap, &index));
+
+	// a released bit is found again wherever it is
+	uint32_t const probes[] = {0, capacity / 2, capacity - 1};
+	for (uint32_t probe : probes) {
+		Thread_AtomicBitmapRelease(bitmap, probe);
+		REQUIRE(!Thread_AtomicBitmapIsSet(bitmap, probe));
+		REQUIRE(Thread_AtomicBitmapAcquire(bitmap, &index));
+		REQUIRE(index == probe);
+		REQUIRE(!Thread_AtomicBitmapAcquire(bitmap, &index));
+	}
+
+	for (uint32_t i = 0; i < capacity; ++i) {
+		Thread_AtomicBitmapRelease(bitmap, i);
+	}
+	for (uint32_t i = 0; i < capacity; ++i) {
+		REQUIRE(!Thread_AtomicBitmapIsSet(bitmap, i));
+	}
+	REQUIRE(Thread_AtomicBitmapAcquire(bitmap, &index));
+
+	free(seen);
+	Thread_AtomicBitmapDestroy(bitmap);
+}
+
+TEST_CASE("Atomic bitmap hands out every bit once", "[al2o3 thread]") {
+	FillAndDrain(1);
+	FillAndDrain(64);
+	FillAndDrain(1000);
+	// a partly filled second summary level
+	FillAndDrain(64 * 64 + 3);
+	Thread_AtomicBitmapDestroy(NULL);
+}
+
+#define BITMAP_CHURN_CAPACITY 300
+#define BITMAP_CHURN_THREADS 4
+#define BITMAP_CHURN_ITERATIONS 20000
+#define BITMAP_CHURN_HOLD 60
+
+static Thread_AtomicBitmapHandle s_churnBitmap;
+static Thread_Atomic32_t s_churnOwners[BITMAP_CHURN_CAPACITY];
+static Thread_Atomic32_t s_churnDuplicates;
+static Thread_Atomic32_t s_churnFailures;
+
+static void BitmapChurn(void *data) {
+	uint32_t const self = (uint32_t) (uintptr_t) data;
+	uint32_t held[BITMAP_CHURN_HOLD];
+	uint32_t heldCount = 0;
+	for (uint32_t i = 0; i < BITMAP_CHURN_ITERATIONS; ++i) {
+		// hold a few so the bitmap runs close to full
+		if (heldCount < BITMAP_CHURN_HOLD && (i % 3) != 2) {
+			uint32_t index;
+			if (!Thread_AtomicBitmapAcquire(s_churnBitmap, &index)) {
+				Thread_AtomicFetchAdd32Explicit(&s_churnFailures, 1, Thread_ATOMIC_RELAXED);
+				continue;
+			}
+			uint32_t const owner = Thread_AtomicExchange32Explicit(&s_churnOwners[index], self, Thread_ATOMIC_RELAXED);
+			if (owner != 0) {
+				Thread_AtomicFetchAdd32Explicit(&s_churnDuplicates, 1, Thread_ATOMIC_RELAXED);
+			}
+			held[heldCount++] = index;
+		} else if (heldCount) {
+			uint32_t const index = held[--heldCount];
+			Thread_AtomicStore32Explicit(&s_churnOwners[index], 0, Thread_ATOMIC_RELAXED);
+			Thread_AtomicBitmapRelease(s_churnBitmap, index);
+		}
+	}
+	while (heldCount) {
+		uint32_t const index = held[--heldCount];
+		Thread_AtomicStore32Explicit(&s_churnOwners[index], 0, Thread_ATOMIC_RELAXED);
+		Thread_AtomicBitmapRelease(s_churnBitmap, index);
+	}
+}
+
+TEST_CASE("Atomic bitmap never hands a bit to two threads", "[al2o3 thread]") {
+	// capacity above what all threads hold at once, so acquire never fails
+	s_churnBitmap = Thread_AtomicBitmapCreate(BITMAP_CHURN_CAPACITY);
+	REQUIRE(s_churnBitmap);
+	Thread_Thread threads[BITMAP_CHURN_THREADS];
+	for (uint32_t i = 0; i < BITMAP_CHURN_THREADS; ++i) {
+		REQUIRE(Thread_ThreadCreate(&threads[i], &BitmapChurn, (void *) (uintptr_t) (i + 1)));
+	}
+	for (uint32_t i = 0; i < BITMAP_CHURN_THREADS; ++i) {
+		Thread_ThreadJoin(&threads[i]);
+		Thread_ThreadDestroy(&threads[i]);
+	}
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_churnDuplicates, Thread_ATOMIC_RELAXED) == 0);
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_churnFailures, Thread_ATOMIC_RELAXED) == 0);
+	for (uint32_t i = 0; i < BITMAP_CHURN_CAPACITY; ++i) {
+		REQUIRE(!Thread_AtomicBitmapIsSet(s_churnBitmap, i));
+	}
+	// everything was given back, so all of it can be taken again
+	uint32_t index;
+	for (uint32_t i = 0; i < BITMAP_CHURN_CAPACITY; ++i) {
+		REQUIRE(Thread_AtomicBitmapAcquire(s_churnBitmap, &index));
+	}
+	REQUIRE(!Thread_AtomicBitmapAcquire(s_churnBitmap, &index));
+	Thread_AtomicBitmapDestroy(s_churnBitmap);
+}
+
+TEST_CASE("Slot allocator handles go stale on release", "[al2o3 thread]") {
+	Thread_SlotAllocatorHandle allocator = Thread_SlotAllocatorCreate(2);
+	REQUIRE(allocator);
+	REQUIRE(Thread_SlotAllocatorCapacity(allocator) == 2);
+
+	Thread_SlotHandle a, b, c;
+	REQUIRE(Thread_SlotAllocatorAcquire(allocator, &a));
+	REQUIRE(Thread_SlotAllocatorAcquire(allocator, &b));
+	REQUIRE(a != 0);
+	REQUIRE(Thread_SlotHandleIndex(a) != Thread_SlotHandleIndex(b));
+	REQUIRE(!Thread_SlotAllocatorAcquire(allocator, &c));
+	REQUIRE(Thread_SlotAllocatorIsValid(allocator, a));
+	REQUIRE(!Thread_SlotAllocatorIsValid(allocator, 0));
+
+	REQUIRE(Thread_SlotAllocatorRelease(allocator, a));
+	REQUIRE(!Thread_SlotAllocatorIsValid(allocator, a));
+	// a second release of the same handle is caught and changes nothing
+	REQUIRE(!Thread_SlotAllocatorRelease(allocator, a));
+
+	// the slot comes back under a new generation, the old handle stays dead
+	REQUIRE(Thread_SlotAllocatorAcquire(allocator, &c));
+	REQUIRE(Thread_SlotHandleIndex(c) == Thread_SlotHandleIndex(a));
+	REQUIRE(Thread_SlotHandleGeneration(c) == Thread_SlotHandleGeneration(a) + 1);
+	REQUIRE(!Thread_SlotAllocatorIsValid(allocator, a));
+	REQUIRE(!Thread_SlotAllocatorRelease(allocator, a));
+	REQUIRE(Thread_SlotAllocatorIsValid(allocator, c));
+
+	// out of range handles are rejected rather than trusted
+	REQUIRE(!Thread_SlotAllocatorRelease(allocator, ((uint64_t) 1 << 32) | 7));
+
+	REQUIRE(Thread_SlotAllocatorRelease(allocator, b));
+	REQUIRE(Thread_SlotAllocatorRelease(allocator, c));
+	Thread_SlotAllocatorDestroy(allocator);
+}
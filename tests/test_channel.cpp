@@ -0,0 +1,241 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/channel.h"
+#include "al2o3_thread/channel.hpp"
+
+TEST_CASE("Channel buffered", "[al2o3 thread]") {
+	Thread_ChannelHandle channel = Thread_ChannelCreate(sizeof(uint32_t), 4);
+	REQUIRE(channel);
+	for (uint32_t i = 0; i < 4; ++i) {
+		REQUIRE(Thread_ChannelTrySend(channel, &i));
+	}
+	uint32_t value = 99;
+	REQUIRE(!Thread_ChannelTrySend(channel, &value));
+	REQUIRE(Thread_ChannelCount(channel) == 4);
+	REQUIRE(Thread_ChannelRecv(channel, &value));
+	REQUIRE(value == 0);
+	REQUIRE(Thread_ChannelSend(channel, &value));
+
+	// closed channels drain then report closed
+	Thread_ChannelClose(channel);
+	REQUIRE(Thread_ChannelIsClosed(channel));
+	REQUIRE(!Thread_ChannelTrySend(channel, &value));
+	uint32_t const expected[] = {1, 2, 3, 0};
+	for (uint32_t i = 0; i < 4; ++i) {
+		REQUIRE(Thread_ChannelRecv(channel, &value));
+		REQUIRE(value == expected[i]);
+	}
+	REQUIRE(!Thread_ChannelRecv(channel, &value));
+	REQUIRE(value == 0);
+	Thread_ChannelDestroy(channel);
+}
+
+#define PINGPONG_COUNT 10000
+
+static Thread_ChannelHandle s_ping;
+static Thread_ChannelHandle s_pong;
+
+static void Ponger(void *data) {
+	uint32_t value;
+	while (Thread_ChannelRecv(s_ping, &value)) {
+		value++;
+		Thread_ChannelSend(s_pong, &value);
+	}
+}
+
+TEST_CASE("Channel unbuffered rendezvous", "[al2o3 thread]") {
+	s_ping = Thread_ChannelCreate(sizeof(uint32_t), 0);
+	s_pong = Thread_ChannelCreate(sizeof(uint32_t), 0);
+	uint32_t value = 0;
+	// nobody is receiving yet
+	REQUIRE(!Thread_ChannelTrySend(s_ping, &value));
+
+	Thread_Thread thread;
+	REQUIRE(Thread_ThreadCreate(&thread, &Ponger, NULL));
+	bool inOrder = true;
+	for (uint32_t i = 0; i < PINGPONG_COUNT; ++i) {
+		REQUIRE(Thread_ChannelSend(s_ping, &i));
+		Thread_ChannelRecv(s_pong, &value);
+		inOrder &= value == i + 1;
+	}
+	REQUIRE(inOrder);
+	Thread_ChannelClose(s_ping);
+	Thread_ThreadDestroy(&thread);
+	Thread_ChannelDestroy(s_ping);
+	Thread_ChannelDestroy(s_pong);
+}
+
+#define PRODUCER_COUNT 4
+#define CONSUMER_COUNT 4
+#define ITEMS_PER_PRODUCER 20000
+
+static Thread_ChannelHandle s_items;
+static Thread_Atomic64_t s_consumedSum;
+static Thread_Atomic32_t s_consumedCount;
+
+static void ItemProducer(void *data) {
+	uint64_t const base = (uint64_t) (uintptr_t) data * ITEMS_PER_PRODUCER;
+	for (uint64_t i = 0; i < ITEMS_PER_PRODUCER; ++i) {
+		uint64_t const item = base + i;
+		Thread_ChannelSend(s_items, &item);
+	}
+}
+
+static void ItemConsumer(void *data) {
+	uint64_t item;
+	while (Thread_ChannelRecv(s_items, &item)) {
+		Thread_AtomicFetchAdd64Explicit(&s_consumedSum, (int64_t) item, Thread_ATOMIC_RELAXED);
+		Thread_AtomicFetchAdd32Explicit(&s_consumedCount, 1, Thread_ATOMIC_RELAXED);
+	}
+}
+
+static void ManyToMany(uint32_t capacity) {
+	s_items = Thread_ChannelCreate(sizeof(uint64_t), capacity);
+	Thread_AtomicStore64Relaxed(&s_consumedSum, 0);
+	Thread_AtomicStore32Relaxed(&s_consumedCount, 0);
+	Thread_Thread producers[PRODUCER_COUNT];
+	Thread_Thread consumers[CONSUMER_COUNT];
+	for (uint32_t i = 0; i < CONSUMER_COUNT; ++i) {
+		REQUIRE(Thread_ThreadCreate(&consumers[i], &ItemConsumer, NULL));
+	}
+	for (uint32_t i = 0; i < PRODUCER_COUNT; ++i) {
+		REQUIRE(Thread_ThreadCreate(&producers[i], &ItemProducer, (void *) (uintptr_t) i));
+	}
+	for (uint32_t i = 0; i < PRODUCER_COUNT; ++i) {
+		Thread_ThreadDestroy(&producers[i]);
+	}
+	// consumers see every item before the close
+	Thread_ChannelClose(s_items);
+	for (uint32_t i = 0; i < CONSUMER_COUNT; ++i) {
+		Thread_ThreadDestroy(&consumers[i]);
+	}
+	uint64_t const total = (uint64_t) PRODUCER_COUNT * ITEMS_PER_PRODUCER;
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_consumedCount) == total);
+	REQUIRE(Thread_AtomicLoad64Relaxed(&s_consumedSum) == total * (total - 1) / 2);
+	Thread_ChannelDestroy(s_items);
+}
+
+TEST_CASE("Channel many producers and consumers", "[al2o3 thread]") {
+	ManyToMany(0);
+	ManyToMany(1);
+	ManyToMany(64);
+}
+
+static Thread_ChannelHandle s_selectA;
+static Thread_ChannelHandle s_selectB;
+static Thread_ChannelHandle s_quit;
+
+static void SelectFeeder(void *data) {
+	uint32_t const value = (uint32_t) (uintptr_t) data;
+	Thread_ChannelHandle channel = value & 1 ? s_selectB : s_selectA;
+	for (uint32_t i = 0; i < 1000; ++i) {
+		Thread_ChannelSend(channel, &value);
+	}
+}
+
+TEST_CASE("Channel select", "[al2o3 thread]") {
+	s_selectA = Thread_ChannelCreate(sizeof(uint32_t), 0);
+	s_selectB = Thread_ChannelCreate(sizeof(uint32_t), 2);
+	s_quit = Thread_ChannelCreate(0, 0);
+
+	// nothing ready times out, NULL channels are never ready
+	uint32_t a = 0, b = 0;
+	Thread_ChannelCase cases[] = {
+			{s_selectA, Thread_CHANNEL_RECV, &a, false},
+			{s_selectB, Thread_CHANNEL_RECV, &b, false},
+			{NULL, Thread_CHANNEL_RECV, NULL, false},
+			{s_quit, Thread_CHANNEL_RECV, NULL, false},
+	};
+	REQUIRE(Thread_ChannelSelect(cases, 4, 0) == -1);
+	REQUIRE(Thread_ChannelSelect(cases, 4, 1000000) == -1);
+
+	Thread_Thread feeders[4];
+	for (uint32_t i = 0; i < 4; ++i) {
+		REQUIRE(Thread_ThreadCreate(&feeders[i], &SelectFeeder, (void *) (uintptr_t) (i + 1)));
+	}
+	uint32_t fromA = 0, fromB = 0;
+	bool valuesMatch = true;
+	while (fromA + fromB < 4000) {
+		int32_t const fired = Thread_ChannelSelect(cases, 4, Thread_FUTEX_WAIT_INFINITE);
+		REQUIRE(fired >= 0);
+		REQUIRE(fired != 2);
+		REQUIRE(cases[fired].ok);
+		if (fired == 0) {
+			valuesMatch &= (a & 1) == 0;
+			fromA++;
+		} else if (fired == 1) {
+			valuesMatch &= (b & 1) == 1;
+			fromB++;
+		}
+	}
+	REQUIRE(valuesMatch);
+	REQUIRE(fromA == 2000);
+	REQUIRE(fromB == 2000);
+	for (uint32_t i = 0; i < 4; ++i) {
+		Thread_ThreadDestroy(&feeders[i]);
+	}
+
+	// a close wakes the select with ok false
+	Thread_ChannelClose(s_quit);
+	REQUIRE(Thread_ChannelSelect(cases, 4, Thread_FUTEX_WAIT_INFINITE) == 3);
+	REQUIRE(!cases[3].ok);
+
+	// a send case completes into a waiting slot
+	Thread_ChannelCase send = {s_selectB, Thread_CHANNEL_SEND, &a, false};
+	a = 7;
+	REQUIRE(Thread_ChannelSelect(&send, 1, 0) == 0);
+	REQUIRE(send.ok);
+	REQUIRE(Thread_ChannelTryRecv(s_selectB, &b));
+	REQUIRE(b == 7);
+
+	Thread_ChannelDestroy(s_selectA);
+	Thread_ChannelDestroy(s_selectB);
+	Thread_ChannelDestroy(s_quit);
+}
+
+struct Message {
+	uint32_t id;
+	float payload;
+};
+
+static Thread::Channel<Message> *s_messages;
+static Thread::Channel<uint32_t> *s_acks;
+
+static void Responder(void *data) {
+	Message message;
+	while (s_messages->Recv(message)) {
+		s_acks->Send(message.id);
+	}
+}
+
+TEST_CASE("Channel C++", "[al2o3 thread]") {
+	Thread::Channel<Message> messages;
+	Thread::Channel<uint32_t> acks(8);
+	s_messages = &messages;
+	s_acks = &acks;
+	Thread_Thread thread;
+	REQUIRE(Thread_ThreadCreate(&thread, &Responder, NULL));
+
+	uint32_t acked = 0;
+	uint32_t sent = 0;
+	Message next = {0, 1.0f};
+	while (acked < 100) {
+		Thread::Select select;
+		// switch the send case off once everything has gone
+		int32_t const sendCase = sent < 100 ? select.Send(messages, next) : -2;
+		uint32_t ack;
+		int32_t const ackCase = select.Recv(acks, ack);
+		int32_t const fired = select.Wait();
+		REQUIRE(select.Ok(fired));
+		if (fired == sendCase) {
+			next.id = ++sent;
+		} else if (fired == ackCase) {
+			REQUIRE(ack == acked);
+			acked++;
+		}
+	}
+	messages.Close();
+	Thread_ThreadDestroy(&thread);
+	REQUIRE(acks.Count() == 0);
+}
@@ -0,0 +1,147 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/disruptor.h"
+#include "al2o3_thread/disruptor.hpp"
+
+#define DIAMOND_PRODUCERS 2
+#define DIAMOND_PER_PRODUCER 50000
+#define DIAMOND_TOTAL (DIAMOND_PRODUCERS * DIAMOND_PER_PRODUCER)
+
+typedef struct Tick {
+	uint32_t producer;
+	uint32_t index;
+	uint64_t doubled; // written in place by the first stage
+} Tick;
+
+static Thread::Disruptor<Tick> *s_ring;
+static Thread_Atomic32_t s_errors;
+
+static void TickProducer(void *data) {
+	uint32_t const producer = (uint32_t) (uintptr_t) data;
+	uint32_t index = 0;
+	while (index < DIAMOND_PER_PRODUCER) {
+		// batches of 1 to 8
+		uint32_t count = index % 8 + 1;
+		count = count < DIAMOND_PER_PRODUCER - index ? count : DIAMOND_PER_PRODUCER - index;
+		uint64_t const first = s_ring->Claim(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			Tick &tick = (*s_ring)[first + i];
+			tick.producer = producer;
+			tick.index = index++;
+		}
+		s_ring->Publish(first, count);
+	}
+}
+
+static void TickError() {
+	Thread_AtomicFetchAdd32Explicit(&s_errors, 1, Thread_ATOMIC_RELAXED);
+}
+
+// 0 doubles in place, 1 checks each producer's order, 2 needs both done first
+static void TickConsumer(void *data) {
+	uint32_t const consumer = (uint32_t) (uintptr_t) data;
+	uint32_t nextIndex[DIAMOND_PRODUCERS] = {};
+	uint32_t seen = 0;
+	while (seen < DIAMOND_TOTAL) {
+		uint64_t first;
+		uint32_t const count = s_ring->Wait(consumer, first, 16);
+		for (uint32_t i = 0; i < count; ++i) {
+			Tick &tick = (*s_ring)[first + i];
+			if (consumer == 0) {
+				tick.doubled = (uint64_t) tick.index * 2;
+			} else if (consumer == 1) {
+				if (tick.producer >= DIAMOND_PRODUCERS || tick.index != nextIndex[tick.producer]++) {
+					TickError();
+				}
+			} else if (tick.doubled != (uint64_t) tick.index * 2) {
+				TickError();
+			}
+		}
+		s_ring->Release(consumer, count);
+		seen += count;
+	}
+}
+
+static void Diamond(Thread_DisruptorWait wait) {
+	s_ring = new Thread::Disruptor<Tick>(256, false, wait);
+	REQUIRE(s_ring->handle);
+	REQUIRE(s_ring->Capacity() == 256);
+	Thread_AtomicStore32Explicit(&s_errors, 0, Thread_ATOMIC_RELAXED);
+	REQUIRE(s_ring->AddConsumer() == 0);
+	REQUIRE(s_ring->AddConsumer() == 1);
+	REQUIRE(s_ring->AddConsumer({0, 1}) == 2);
+
+	Thread_Thread consumers[3];
+	for (uint32_t i = 0; i < 3; ++i) {
+		REQUIRE(Thread_ThreadCreate(&consumers[i], &TickConsumer, (void *) (uintptr_t) i));
+	}
+	Thread_Thread producers[DIAMOND_PRODUCERS];
+	for (uint32_t i = 0; i < DIAMOND_PRODUCERS; ++i) {
+		REQUIRE(Thread_ThreadCreate(&producers[i], &TickProducer, (void *) (uintptr_t) i));
+	}
+	for (uint32_t i = 0; i < DIAMOND_PRODUCERS; ++i) {
+		Thread_ThreadDestroy(&producers[i]);
+	}
+	for (uint32_t i = 0; i < 3; ++i) {
+		Thread_ThreadDestroy(&consumers[i]);
+	}
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_errors, Thread_ATOMIC_RELAXED) == 0);
+	delete s_ring;
+}
+
+TEST_CASE("Disruptor diamond with multiple producers", "[al2o3 thread]") {
+	Diamond(Thread_DISRUPTOR_WAIT_PARK);
+	Diamond(Thread_DISRUPTOR_WAIT_YIELD);
+	// spinning needs a core per thread
+	if (Thread_CPUUsableCoreCount() >= 6) {
+		Diamond(Thread_DISRUPTOR_WAIT_SPIN);
+	}
+}
+
+TEST_CASE("Disruptor single producer full and empty", "[al2o3 thread]") {
+	Thread_DisruptorDesc desc = {};
+	desc.entrySize = sizeof(uint32_t);
+	desc.capacity = 5;
+	desc.singleProducer = true;
+	desc.wait = Thread_DISRUPTOR_WAIT_SPIN;
+	Thread_DisruptorHandle ring = Thread_DisruptorCreate(&desc);
+	REQUIRE(ring);
+	REQUIRE(Thread_DisruptorCapacity(ring) == 8);
+	uint32_t const slow = 0;
+	REQUIRE(Thread_DisruptorAddConsumer(ring, NULL, 0) == 0);
+	REQUIRE(Thread_DisruptorAddConsumer(ring, &slow, 1) == 1);
+
+	uint64_t first;
+	REQUIRE(Thread_DisruptorConsumerWait(ring, 0, &first, 8, 0) == 0);
+	REQUIRE(Thread_DisruptorConsumerWait(ring, 1, &first, 8, 1000000) == 0);
+
+	REQUIRE(Thread_DisruptorTryClaim(ring, 6, &first));
+	REQUIRE(first == 0);
+	for (uint32_t i = 0; i < 6; ++i) {
+		*(uint32_t *) Thread_DisruptorEntry(ring, first + i) = 100 + i;
+	}
+	// claimed but not published is invisible
+	REQUIRE(Thread_DisruptorConsumerWait(ring, 0, &first, 8, 0) == 0);
+	Thread_DisruptorPublish(ring, 0, 6);
+	REQUIRE(!Thread_DisruptorTryClaim(ring, 3, &first));
+
+	// the dependent consumer waits for the first
+	REQUIRE(Thread_DisruptorConsumerWait(ring, 1, &first, 8, 0) == 0);
+	REQUIRE(Thread_DisruptorConsumerWait(ring, 0, &first, 4, 0) == 4);
+	REQUIRE(first == 0);
+	REQUIRE(*(uint32_t *) Thread_DisruptorEntry(ring, 3) == 103);
+	Thread_DisruptorConsumerRelease(ring, 0, 4);
+	REQUIRE(Thread_DisruptorConsumerWait(ring, 1, &first, 8, 0) == 4);
+	// space only comes back once the last consumer in line releases
+	REQUIRE(!Thread_DisruptorTryClaim(ring, 3, &first));
+	Thread_DisruptorConsumerRelease(ring, 1, 2);
+	REQUIRE(Thread_DisruptorTryClaim(ring, 3, &first));
+	REQUIRE(first == 6);
+	REQUIRE(Thread_DisruptorEntry(ring, 8) == Thread_DisruptorEntry(ring, 0));
+	Thread_DisruptorPublish(ring, 6, 3);
+
+	REQUIRE(Thread_DisruptorConsumerWait(ring, 0, &first, 8, 0) == 5);
+	REQUIRE(first == 4);
+	Thread_DisruptorDestroy(ring);
+}
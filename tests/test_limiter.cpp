@@ -0,0 +1,144 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/barrier.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/limiter.h"
+
+#define LIMITER_JOBS 400
+#define LIMITER_MAX 2
+
+static Thread_Atomic32_t s_limiterInside;
+static Thread_Atomic32_t s_limiterMostInside;
+static Thread_Atomic32_t s_limiterRan;
+
+static void LimitedJob(void *data) {
+	uint32_t const inside = Thread_AtomicFetchAdd32Explicit(&s_limiterInside, 1, Thread_ATOMIC_RELAXED) + 1;
+	uint32_t most = Thread_AtomicLoad32Explicit(&s_limiterMostInside, Thread_ATOMIC_RELAXED);
+	while (inside > most &&
+			!Thread_AtomicCompareExchangeWeak32Explicit(&s_limiterMostInside, &most, inside,
+																									Thread_ATOMIC_RELAXED, Thread_ATOMIC_RELAXED)) {
+	}
+	// long enough that jobs overlap
+	uint64_t const start = Thread_MonotonicNs();
+	while (Thread_MonotonicNs() - start < 20000) {
+		Thread_AtomicPause();
+	}
+	Thread_AtomicFetchAdd32Explicit(&s_limiterRan, 1, Thread_ATOMIC_RELAXED);
+	Thread_AtomicFetchSub32Explicit(&s_limiterInside, 1, Thread_ATOMIC_RELAXED);
+}
+
+TEST_CASE("Limiter never runs more than its limit", "[al2o3 thread]") {
+	Thread_PoolHandle pool = Thread_PoolCreate(NULL);
+	REQUIRE(pool);
+	Thread_LimiterHandle limiter = Thread_LimiterCreate(pool, LIMITER_MAX);
+	REQUIRE(limiter);
+	for (uint32_t i = 0; i < LIMITER_JOBS; ++i) {
+		Thread_LimiterSubmit(limiter, &LimitedJob, NULL);
+	}
+	REQUIRE(Thread_LimiterRunningCount(limiter) <= LIMITER_MAX);
+	Thread_LimiterDestroy(limiter);
+
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_limiterRan, Thread_ATOMIC_RELAXED) == LIMITER_JOBS);
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_limiterMostInside, Thread_ATOMIC_RELAXED) <= LIMITER_MAX);
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_limiterInside, Thread_ATOMIC_RELAXED) == 0);
+	Thread_PoolDestroy(pool);
+}
+
+static Thread_Latch *s_limiterGate;
+
+static void GatedJob(void *data) {
+	Thread_LatchWait(s_limiterGate);
+}
+
+TEST_CASE("Limiter queues without blocking the submitter", "[al2o3 thread]") {
+	Thread_PoolHandle pool = Thread_PoolCreate(NULL);
+	REQUIRE(pool);
+	Thread_Latch gate;
+	Thread_LatchCreate(&gate, 1);
+	s_limiterGate = &gate;
+
+	Thread_LimiterHandle limiter = Thread_LimiterCreate(pool, 1);
+	REQUIRE(limiter);
+	// the first job holds the only slot until the gate opens, the rest wait
+	// in the limiter and submit still returns
+	for (uint32_t i = 0; i < 10; ++i) {
+		Thread_LimiterSubmit(limiter, &GatedJob, NULL);
+	}
+	REQUIRE(Thread_LimiterRunningCount(limiter) == 1);
+	REQUIRE(Thread_LimiterQueuedCount(limiter) >= 9);
+	Thread_LatchCountDown(&gate, 1);
+	Thread_LimiterDestroy(limiter);
+	Thread_LatchDestroy(&gate);
+	Thread_PoolDestroy(pool);
+}
+
+TEST_CASE("Rate limiter bursts then refills", "[al2o3 thread]") {
+	Thread_RateLimiter limiter;
+	// one token a millisecond
+	REQUIRE(Thread_RateLimiterCreate(&limiter, 1000, 10));
+	REQUIRE(Thread_RateLimiterAvailable(&limiter) == 10);
+	REQUIRE(Thread_RateLimiterTryAcquire(&limiter, 4));
+	uint32_t taken = 4;
+	while (Thread_RateLimiterTryAcquire(&limiter, 1)) {
+		taken++;
+	}
+	// refill while we were taking can add a few more
+	REQUIRE(taken >= 10);
+
+	// going into debt reports how long to wait
+	uint64_t const delay = Thread_RateLimiterReserve(&limiter, 5);
+	REQUIRE(delay > 0);
+	REQUIRE(delay <= 5000000);
+	REQUIRE(Thread_RateLimiterAvailable(&limiter) == 0);
+
+	Thread_Sleep(30);
+	REQUIRE(Thread_RateLimiterAvailable(&limiter) == 10);
+	REQUIRE(Thread_RateLimiterReserve(&limiter, 1) == 0);
+	Thread_RateLimiterDestroy(&limiter);
+}
+
+TEST_CASE("Rate limiter is exact at high rates", "[al2o3 thread]") {
+	// rates that don't divide 1e9 into whole ns per token
+	uint64_t const rates[] = {300000000, 700000000, 999999999, 3000};
+	for (uint64_t rate : rates) {
+		Thread_RateLimiter limiter;
+		REQUIRE(Thread_RateLimiterCreate(&limiter, rate, 10));
+		// a second's worth past the burst is a second's wait
+		uint64_t const delay = Thread_RateLimiterReserve(&limiter, (uint32_t) rate + 10);
+		REQUIRE(delay <= 1000000000);
+		REQUIRE(delay > 990000000);
+		Thread_RateLimiterDestroy(&limiter);
+	}
+}
+
+#define RATE_THREADS 4
+
+static Thread_RateLimiter s_rateLimiter;
+static Thread_Atomic32_t s_rateTaken;
+
+static void RateTaker(void *data) {
+	uint64_t const end = Thread_MonotonicNs() + 50000000;
+	while (Thread_MonotonicNs() < end) {
+		if (Thread_RateLimiterTryAcquire(&s_rateLimiter, 1)) {
+			Thread_AtomicFetchAdd32Explicit(&s_rateTaken, 1, Thread_ATOMIC_RELAXED);
+		}
+	}
+}
+
+TEST_CASE("Rate limiter holds the rate across threads", "[al2o3 thread]") {
+	REQUIRE(Thread_RateLimiterCreate(&s_rateLimiter, 1000, 5));
+	uint64_t const start = Thread_MonotonicNs();
+	Thread_Thread threads[RATE_THREADS];
+	for (uint32_t i = 0; i < RATE_THREADS; ++i) {
+		REQUIRE(Thread_ThreadCreate(&threads[i], &RateTaker, NULL));
+	}
+	for (uint32_t i = 0; i < RATE_THREADS; ++i) {
+		Thread_ThreadJoin(&threads[i]);
+		Thread_ThreadDestroy(&threads[i]);
+	}
+	uint64_t const elapsedMs = (Thread_MonotonicNs() - start) / 1000000;
+	// burst plus one a millisecond for as long as anyone was taking
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_rateTaken, Thread_ATOMIC_RELAXED) <= 5 + elapsedMs + 1);
+	Thread_RateLimiterDestroy(&s_rateLimiter);
+}
@@ -0,0 +1,108 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/mainqueue.h"
+
+#define POSTER_COUNT 4
+#define POSTS_PER_POSTER 1000
+
+static Thread_ThreadID s_pumpThreadID;
+static uint32_t s_ranOnPumpThread;
+static uint32_t s_ranElsewhere;
+
+static void CountJob(void *data) {
+	if (Thread_GetCurrentThreadID() == s_pumpThreadID) {
+		s_ranOnPumpThread++;
+	} else {
+		s_ranElsewhere++;
+	}
+}
+
+static void Poster(void *data) {
+	for (uint32_t i = 0; i < POSTS_PER_POSTER; ++i) {
+		Thread_MainQueuePost(&CountJob, NULL);
+	}
+}
+
+static Thread_Atomic32_t s_waitReturned;
+
+static void WaitingPoster(void *data) {
+	Thread_MainQueuePostAndWait(&CountJob, NULL);
+	Thread_AtomicStore32Explicit(&s_waitReturned, 1, Thread_ATOMIC_RELEASE);
+}
+
+static uint32_t s_offMainPumped;
+
+static void OffMainPump(void *data) {
+	s_offMainPumped = Thread_MainQueuePump(UINT64_MAX);
+}
+
+static void PostAnother(void *data) {
+	Thread_MainQueuePost(&CountJob, data);
+}
+
+TEST_CASE("Main queue", "[al2o3 thread]") {
+	// tests run on the process's main thread
+	Thread_SetMainThread();
+	s_pumpThreadID = Thread_GetCurrentThreadID();
+	s_ranOnPumpThread = 0;
+	s_ranElsewhere = 0;
+	// the main thread doesn't need to have pumped before waiting on itself
+	Thread_MainQueuePostAndWait(&CountJob, NULL);
+	REQUIRE(s_ranOnPumpThread == 1);
+	s_ranOnPumpThread = 0;
+	// nothing queued is nothing run
+	Thread_MainQueuePump(UINT64_MAX);
+	REQUIRE(Thread_MainQueueCount() == 0);
+
+	// only the main thread consumes, a pump anywhere else leaves the job queued
+	Thread_MainQueuePost(&CountJob, NULL);
+	s_offMainPumped = ~0u;
+	Thread_Thread offMain;
+	REQUIRE(Thread_ThreadCreate(&offMain, &OffMainPump, NULL));
+	Thread_ThreadDestroy(&offMain);
+	REQUIRE(s_offMainPumped == 0);
+	REQUIRE(Thread_MainQueueCount() == 1);
+	REQUIRE(Thread_MainQueuePump(UINT64_MAX) == 1);
+	REQUIRE(s_ranOnPumpThread == 1);
+	s_ranOnPumpThread = 0;
+
+	Thread_Thread posters[POSTER_COUNT];
+	for (uint32_t i = 0; i < POSTER_COUNT; ++i) {
+		REQUIRE(Thread_ThreadCreate(&posters[i], &Poster, NULL));
+	}
+	for (uint32_t i = 0; i < POSTER_COUNT; ++i) {
+		Thread_ThreadDestroy(&posters[i]);
+	}
+	REQUIRE(Thread_MainQueueCount() == POSTER_COUNT * POSTS_PER_POSTER);
+	// a zero budget still makes progress, one job at a time
+	REQUIRE(Thread_MainQueuePump(0) == 1);
+	while (Thread_MainQueueCount()) {
+		Thread_MainQueuePump(UINT64_MAX);
+	}
+	REQUIRE(s_ranOnPumpThread == POSTER_COUNT * POSTS_PER_POSTER);
+	REQUIRE(s_ranElsewhere == 0);
+
+	// the poster only returns once the main thread has run it
+	Thread_AtomicStore32Explicit(&s_waitReturned, 0, Thread_ATOMIC_RELAXED);
+	Thread_Thread waiter;
+	REQUIRE(Thread_ThreadCreate(&waiter, &WaitingPoster, NULL));
+	while (Thread_MainQueueCount() == 0) {
+		Thread_Sleep(1);
+	}
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_waitReturned, Thread_ATOMIC_ACQUIRE) == 0);
+	REQUIRE(Thread_MainQueuePump(UINT64_MAX) == 1);
+	Thread_ThreadDestroy(&waiter);
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_waitReturned, Thread_ATOMIC_ACQUIRE) == 1);
+
+	// on the pumping thread it runs inline
+	Thread_MainQueuePostAndWait(&CountJob, NULL);
+	REQUIRE(s_ranOnPumpThread == POSTER_COUNT * POSTS_PER_POSTER + 2);
+
+	// jobs posted by a job wait for the next pump
+	Thread_MainQueuePost(&PostAnother, NULL);
+	REQUIRE(Thread_MainQueuePump(UINT64_MAX) == 1);
+	REQUIRE(Thread_MainQueueCount() == 1);
+	REQUIRE(Thread_MainQueuePump(UINT64_MAX) == 1);
+	REQUIRE(Thread_MainQueueCount() == 0);
+}
@@ -0,0 +1,182 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/parallel.h"
+#include "al2o3_thread/parallel.hpp"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct SortItem {
+	uint32_t key;
+	uint32_t original; // position before sorting, checks stability
+} SortItem;
+
+static uint64_t SortItemKey(void const *element, void *userData) {
+	return ((SortItem const *) element)->key;
+}
+
+static uint32_t Random(uint32_t *state) {
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+static void SortAndCheck(Thread_PoolHandle pool, uint64_t count, uint32_t keyRange) {
+	SortItem *items = (SortItem *) malloc(count * sizeof(SortItem) + 1);
+	uint32_t state = 0x1234567u + (uint32_t) count;
+	for (uint64_t i = 0; i < count; ++i) {
+		items[i].key = Random(&state) % keyRange;
+		items[i].original = (uint32_t) i;
+	}
+	REQUIRE(Thread_ParallelSort(pool, items, count, sizeof(SortItem), &SortItemKey, NULL));
+	bool sorted = true;
+	for (uint64_t i = 1; i < count; ++i) {
+		sorted &= items[i - 1].key < items[i].key ||
+				(items[i - 1].key == items[i].key && items[i - 1].original < items[i].original);
+	}
+	REQUIRE(sorted);
+	free(items);
+}
+
+TEST_CASE("Parallel sort", "[al2o3 thread]") {
+	Thread_PoolHandle pool = Thread_PoolCreate(NULL);
+	REQUIRE(pool);
+	uint64_t const counts[] = {0, 1, 2, 17, 1000, 4096 * 3 + 7, 250000};
+	for (uint64_t count : counts) {
+		SortAndCheck(pool, count, 0xffffffffu);
+		// lots of equal keys
+		SortAndCheck(pool, count, 16);
+	}
+	SortAndCheck(NULL, 100000, 1000);
+
+	double values[5000];
+	uint32_t state = 42;
+	for (double &value : values) {
+		value = (double) Random(&state) / 1000.0;
+	}
+	REQUIRE(Thread::ParallelSort(pool, values, 5000, [](double const &value) { return (uint64_t) value; }));
+	bool sorted = true;
+	for (uint32_t i = 1; i < 5000; ++i) {
+		sorted &= (uint64_t) values[i - 1] <= (uint64_t) values[i];
+	}
+	REQUIRE(sorted);
+	Thread_PoolDestroy(pool);
+}
+
+TEST_CASE("Parallel scan", "[al2o3 thread]") {
+	Thread_PoolHandle pool = Thread_PoolCreate(NULL);
+	REQUIRE(pool);
+	uint64_t const count = 100000;
+	uint32_t *src = (uint32_t *) malloc(count * sizeof(uint32_t));
+	uint32_t *dst = (uint32_t *) malloc(count * sizeof(uint32_t));
+	for (uint64_t i = 0; i < count; ++i) {
+		src[i] = (uint32_t) (i % 7);
+	}
+	uint32_t const total = Thread_ParallelScanU32(pool, src, dst, count, true);
+	bool matches = true;
+	uint32_t sum = 0;
+	for (uint64_t i = 0; i < count; ++i) {
+		sum += src[i];
+		matches &= dst[i] == sum;
+	}
+	REQUIRE(matches);
+	REQUIRE(total == sum);
+
+	// exclusive in place
+	REQUIRE(Thread_ParallelScanU32(pool, src, src, count, false) == sum);
+	matches = src[0] == 0;
+	for (uint64_t i = 1; i < count; ++i) {
+		matches &= src[i] == dst[i - 1];
+	}
+	REQUIRE(matches);
+
+	double doubles[40000];
+	for (double &value : doubles) {
+		value = 0.5;
+	}
+	REQUIRE(Thread::ParallelScan(pool, doubles, doubles, 40000, true) == 20000.0);
+	REQUIRE(doubles[39999] == 20000.0);
+	REQUIRE(Thread_ParallelScanU64(NULL, NULL, NULL, 0, true) == 0);
+	free(src);
+	free(dst);
+	Thread_PoolDestroy(pool);
+}
+
+static bool IsEven(void const *element, void *userData) {
+	return (*(uint32_t const *) element & 1) == 0;
+}
+
+TEST_CASE("Parallel partition and compact", "[al2o3 thread]") {
+	Thread_PoolHandle pool = Thread_PoolCreate(NULL);
+	REQUIRE(pool);
+	uint64_t const count = 123457;
+	uint32_t *src = (uint32_t *) malloc(count * sizeof(uint32_t));
+	uint32_t *dst = (uint32_t *) malloc(count * sizeof(uint32_t));
+	uint32_t state = 99;
+	uint64_t evens = 0;
+	for (uint64_t i = 0; i < count; ++i) {
+		// low bit random, the rest keeps the original order visible
+		src[i] = (uint32_t) (i << 1) | (Random(&state) & 1);
+		evens += (src[i] & 1) == 0;
+	}
+
+	REQUIRE(Thread_ParallelPartition(pool, src, dst, count, sizeof(uint32_t), &IsEven, NULL) == evens);
+	bool stable = true;
+	for (uint64_t i = 0; i < count; ++i) {
+		bool const even = (dst[i] & 1) == 0;
+		stable &= even == (i < evens);
+		if (i > 0 && i != evens) {
+			stable &= dst[i - 1] < dst[i];
+		}
+	}
+	REQUIRE(stable);
+
+	memset(dst, 0xff, count * sizeof(uint32_t));
+	REQUIRE(Thread::ParallelCompact(pool, src, dst, count, [](uint32_t const &value) { return (value & 1) != 0; }) ==
+							count - evens);
+	stable = true;
+	for (uint64_t i = 0; i < count - evens; ++i) {
+		stable &= (dst[i] & 1) == 1;
+		if (i > 0) {
+			stable &= dst[i - 1] < dst[i];
+		}
+	}
+	REQUIRE(stable);
+	REQUIRE(dst[count - evens] == 0xffffffffu);
+	free(src);
+	free(dst);
+	Thread_PoolDestroy(pool);
+}
+
+#define FOR_COUNT 1000003
+
+static Thread_Atomic32_t s_forTouched[FOR_COUNT / 32 + 1];
+
+static void MarkRange(void *data, uint64_t begin, uint64_t end) {
+	for (uint64_t i = begin; i < end; ++i) {
+		Thread_AtomicFetchOr32Explicit(&s_forTouched[i / 32], 1u << (i % 32), Thread_ATOMIC_RELAXED);
+	}
+}
+
+static void NestedFor(void *data, uint64_t begin, uint64_t end) {
+	Thread_PoolHandle pool = (Thread_PoolHandle) data;
+	for (uint64_t i = begin; i < end; ++i) {
+		Thread_ParallelFor(pool, 1000, 10, [](void *, uint64_t, uint64_t) {}, NULL);
+	}
+}
+
+TEST_CASE("Parallel for", "[al2o3 thread]") {
+	Thread_PoolHandle pool = Thread_PoolCreate(NULL);
+	REQUIRE(pool);
+	memset(s_forTouched, 0, sizeof(s_forTouched));
+	Thread_ParallelFor(pool, FOR_COUNT, 0, &MarkRange, NULL);
+	bool all = true;
+	for (uint64_t i = 0; i < FOR_COUNT; ++i) {
+		all &= (Thread_AtomicLoad32Relaxed(&s_forTouched[i / 32]) & (1u << (i % 32))) != 0;
+	}
+	REQUIRE(all);
+	// from inside pool jobs, nothing may wait on a job queued behind it
+	Thread_ParallelFor(pool, 64, 1, &NestedFor, pool);
+	Thread_PoolDestroy(pool);
+}
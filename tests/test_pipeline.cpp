@@ -0,0 +1,139 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/pipeline.h"
+#include <stdlib.h>
+
+#define PIPELINE_ITEMS 20000
+#define PIPELINE_TOKENS 6
+
+typedef struct PipelineItem {
+	uint64_t index;
+	uint64_t squared;
+} PipelineItem;
+
+typedef struct PipelineTestState {
+	PipelineItem *items;
+	uint64_t produced;
+	Thread_Atomic32_t inFlight;
+	uint32_t maxInFlight; // only touched by the first stage
+	// threads inside each serial stage, must never go above 1
+	Thread_Atomic32_t inOrderInside;
+	Thread_Atomic32_t outOfOrderInside;
+	uint32_t overlaps;
+	// only touched by serial stages
+	uint64_t nextExpected;
+	uint32_t outOfSequence;
+	uint64_t outOfOrderCount;
+	uint64_t sum;
+} PipelineTestState;
+
+static void *PipelineRead(void *item, void *userData) {
+	PipelineTestState *state = (PipelineTestState *) userData;
+	if (state->produced == PIPELINE_ITEMS) {
+		return NULL;
+	}
+	uint32_t const inFlight = Thread_AtomicFetchAdd32Explicit(&state->inFlight, 1, Thread_ATOMIC_RELAXED) + 1;
+	state->maxInFlight = inFlight > state->maxInFlight ? inFlight : state->maxInFlight;
+	PipelineItem *out = &state->items[state->produced];
+	out->index = state->produced++;
+	return out;
+}
+
+static void *PipelineSquare(void *item, void *userData) {
+	PipelineItem *in = (PipelineItem *) item;
+	in->squared = in->index * in->index;
+	return in;
+}
+
+static void *PipelineInOrder(void *item, void *userData) {
+	PipelineTestState *state = (PipelineTestState *) userData;
+	PipelineItem *in = (PipelineItem *) item;
+	if (Thread_AtomicFetchAdd32Explicit(&state->inOrderInside, 1, Thread_ATOMIC_ACQUIRE) != 0) {
+		state->overlaps++;
+	}
+	if (in->index != state->nextExpected) {
+		state->outOfSequence++;
+	}
+	state->nextExpected = in->index + 1;
+	state->sum += in->squared;
+	Thread_AtomicFetchSub32Explicit(&state->inOrderInside, 1, Thread_ATOMIC_RELEASE);
+	return in;
+}
+
+static void *PipelineOutOfOrder(void *item, void *userData) {
+	PipelineTestState *state = (PipelineTestState *) userData;
+	if (Thread_AtomicFetchAdd32Explicit(&state->outOfOrderInside, 1, Thread_ATOMIC_ACQUIRE) != 0) {
+		state->overlaps++;
+	}
+	state->outOfOrderCount++;
+	Thread_AtomicFetchSub32Explicit(&state->outOfOrderInside, 1, Thread_ATOMIC_RELEASE);
+	return item;
+}
+
+static void *PipelineWrite(void *item, void *userData) {
+	PipelineTestState *state = (PipelineTestState *) userData;
+	Thread_AtomicFetchSub32Explicit(&state->inFlight, 1, Thread_ATOMIC_RELAXED);
+	return NULL;
+}
+
+static void RunTestPipeline(Thread_PoolHandle pool, uint32_t maxTokens) {
+	PipelineTestState state = {};
+	state.items = (PipelineItem *) malloc(sizeof(PipelineItem) * PIPELINE_ITEMS);
+	Thread_PipelineStage const stages[] = {
+			{&PipelineRead, &state, Thread_PIPELINE_SERIAL_IN_ORDER},
+			{&PipelineSquare, &state, Thread_PIPELINE_PARALLEL},
+			{&PipelineOutOfOrder, &state, Thread_PIPELINE_SERIAL_OUT_OF_ORDER},
+			{&PipelineSquare, &state, Thread_PIPELINE_PARALLEL},
+			{&PipelineInOrder, &state, Thread_PIPELINE_SERIAL_IN_ORDER},
+			{&PipelineWrite, &state, Thread_PIPELINE_PARALLEL},
+	};
+	Thread_PipelineRun(pool, maxTokens, stages, sizeof(stages) / sizeof(stages[0]));
+
+	uint64_t expectedSum = 0;
+	for (uint64_t i = 0; i < PIPELINE_ITEMS; ++i) {
+		expectedSum += i * i;
+	}
+	REQUIRE(state.produced == PIPELINE_ITEMS);
+	REQUIRE(state.overlaps == 0);
+	REQUIRE(state.outOfSequence == 0);
+	REQUIRE(state.nextExpected == PIPELINE_ITEMS);
+	REQUIRE(state.outOfOrderCount == PIPELINE_ITEMS);
+	REQUIRE(state.sum == expectedSum);
+	REQUIRE(Thread_AtomicLoad32Explicit(&state.inFlight, Thread_ATOMIC_RELAXED) == 0);
+	if (maxTokens) {
+		REQUIRE(state.maxInFlight <= maxTokens);
+	}
+	free(state.items);
+}
+
+TEST_CASE("Pipeline keeps serial stages serial and in order", "[al2o3 thread]") {
+	Thread_PoolHandle pool = Thread_PoolCreate(NULL);
+	REQUIRE(pool);
+	RunTestPipeline(pool, PIPELINE_TOKENS);
+	RunTestPipeline(pool, 1);
+	RunTestPipeline(pool, 0);
+	Thread_PoolDestroy(pool);
+
+	// no pool runs it all on the caller
+	RunTestPipeline(NULL, PIPELINE_TOKENS);
+}
+
+static void *PipelineNothing(void *item, void *userData) {
+	(*(uint32_t *) userData)++;
+	return NULL;
+}
+
+TEST_CASE("Pipeline with no input finishes", "[al2o3 thread]") {
+	Thread_PoolHandle pool = Thread_PoolCreate(NULL);
+	REQUIRE(pool);
+	uint32_t calls = 0;
+	Thread_PipelineStage const stages[] = {
+			{&PipelineNothing, &calls, Thread_PIPELINE_SERIAL_IN_ORDER},
+			{&PipelineSquare, NULL, Thread_PIPELINE_PARALLEL},
+	};
+	Thread_PipelineRun(pool, 0, stages, 2);
+	REQUIRE(calls == 1);
+	Thread_PoolDestroy(pool);
+}
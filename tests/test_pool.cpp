@@ -0,0 +1,293 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/barrier.h"
+#include "al2o3_thread/pool.h"
+
+static Thread_CountdownEvent s_done;
+static Thread_Atomic32_t s_ran;
+static Thread_Atomic32_t s_wrongPool;
+static Thread_PoolHandle s_pool;
+
+static void CountJob(void *data) {
+	if (Thread_PoolGetCurrent() != s_pool) {
+		Thread_AtomicFetchAdd32Explicit(&s_wrongPool, 1, Thread_ATOMIC_RELAXED);
+	}
+	Thread_AtomicFetchAdd32Explicit(&s_ran, 1, Thread_ATOMIC_RELAXED);
+	Thread_CountdownEventSignal(&s_done, 1);
+}
+
+// fans out into children from inside a worker, they land on its own deque
+static void ForkJob(void *data) {
+	uintptr_t const depth = (uintptr_t) data;
+	if (depth) {
+		Thread_CountdownEventAdd(&s_done, 2);
+		Thread_PoolSubmit(s_pool, &ForkJob, (void *) (depth - 1));
+		Thread_PoolSubmit(s_pool, &ForkJob, (void *) (depth - 1));
+	}
+	CountJob(NULL);
+}
+
+TEST_CASE("Pool runs every job", "[al2o3 thread]") {
+	s_pool = Thread_PoolCreate(NULL);
+	REQUIRE(s_pool);
+	REQUIRE(Thread_PoolMaxWorkerCount(s_pool) >= 1);
+	REQUIRE(Thread_PoolMaxWorkerCount(s_pool) <= Thread_CPUUsableCoreCount());
+	REQUIRE(Thread_PoolGetCurrent() == NULL);
+	Thread_AtomicStore32Relaxed(&s_ran, 0);
+
+	// more than the queue holds, the overflow runs on this thread
+	REQUIRE(Thread_CountdownEventCreate(&s_done, 10000));
+	for (uint32_t i = 0; i < 10000; ++i) {
+		Thread_PoolSubmit(s_pool, &CountJob, NULL);
+	}
+	Thread_CountdownEventWait(&s_done);
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_ran) == 10000);
+	REQUIRE(Thread_PoolWorkerCount(s_pool) <= Thread_PoolMaxWorkerCount(s_pool));
+
+	// 2^11 - 1 jobs from a binary tree of submits, all made by workers
+	Thread_AtomicStore32Relaxed(&s_ran, 0);
+	Thread_AtomicStore32Relaxed(&s_wrongPool, 0);
+	Thread_CountdownEventReset(&s_done, 1);
+	Thread_PoolSubmit(s_pool, &ForkJob, (void *) 10);
+	Thread_CountdownEventWait(&s_done);
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_ran) == 2047);
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_wrongPool) == 0);
+	REQUIRE(Thread_PoolQueueDepth(s_pool) == 0);
+
+	Thread_CountdownEventDestroy(&s_done);
+	Thread_PoolDestroy(s_pool);
+}
+
+TEST_CASE("Pool destroy drains queued jobs", "[al2o3 thread]") {
+	s_pool = Thread_PoolCreate(NULL);
+	REQUIRE(s_pool);
+	Thread_AtomicStore32Relaxed(&s_ran, 0);
+	REQUIRE(Thread_CountdownEventCreate(&s_done, 1000));
+	for (uint32_t i = 0; i < 1000; ++i) {
+		Thread_PoolSubmit(s_pool, &CountJob, NULL);
+	}
+	Thread_PoolDestroy(s_pool);
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_ran) == 1000);
+	Thread_CountdownEventDestroy(&s_done);
+}
+
+static Thread_Latch s_gate;
+static Thread_ThreadID s_submitter;
+static Thread_Atomic32_t s_inline;
+
+static void GateJob(void *data) {
+	Thread_LatchWait(&s_gate);
+	Thread_CountdownEventSignal(&s_done, 1);
+}
+
+static void InlineJob(void *data) {
+	if (Thread_GetCurrentThreadID() == s_submitter) {
+		Thread_AtomicFetchAdd32Explicit(&s_inline, 1, Thread_ATOMIC_RELAXED);
+	}
+	Thread_CountdownEventSignal(&s_done, 1);
+}
+
+TEST_CASE("Pool runs jobs inline when full", "[al2o3 thread]") {
+	Thread_PoolDesc desc = {};
+	desc.maxWorkers = 1;
+	desc.queueCapacity = 4;
+	s_pool = Thread_PoolCreate(&desc);
+	REQUIRE(s_pool);
+	REQUIRE(Thread_LatchCreate(&s_gate, 1));
+	REQUIRE(Thread_CountdownEventCreate(&s_done, 1 + 4 + 8));
+	Thread_AtomicStore32Relaxed(&s_inline, 0);
+	s_submitter = Thread_GetCurrentThreadID();
+
+	// the only worker blocks on the gate, leaving the queue to fill up
+	Thread_PoolSubmit(s_pool, &GateJob, NULL);
+	while (Thread_PoolQueueDepth(s_pool) != 0) {
+		Thread_Sleep(1);
+	}
+	for (uint32_t i = 0; i < 4 + 8; ++i) {
+		Thread_PoolSubmit(s_pool, &InlineJob, NULL);
+	}
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_inline) == 8);
+	Thread_LatchCountDown(&s_gate, 1);
+	Thread_CountdownEventWait(&s_done);
+
+	Thread_PoolDestroy(s_pool);
+	Thread_CountdownEventDestroy(&s_done);
+	Thread_LatchDestroy(&s_gate);
+}
+
+TEST_CASE("Pool retires idle workers", "[al2o3 thread]") {
+	Thread_PoolDesc desc = {};
+	desc.retireMs = 10;
+	s_pool = Thread_PoolCreate(&desc);
+	REQUIRE(s_pool);
+	REQUIRE(Thread_CountdownEventCreate(&s_done, 100));
+	for (uint32_t i = 0; i < 100; ++i) {
+		Thread_PoolSubmit(s_pool, &CountJob, NULL);
+	}
+	Thread_CountdownEventWait(&s_done);
+	REQUIRE(Thread_PoolWorkerCount(s_pool) >= 1);
+
+	for (uint32_t i = 0; i < 500 && Thread_PoolWorkerCount(s_pool) != 0; ++i) {
+		Thread_Sleep(10);
+	}
+	REQUIRE(Thread_PoolWorkerCount(s_pool) == 0);
+
+	// and come back when there is work again
+	Thread_CountdownEventReset(&s_done, 100);
+	for (uint32_t i = 0; i < 100; ++i) {
+		Thread_PoolSubmit(s_pool, &CountJob, NULL);
+	}
+	Thread_CountdownEventWait(&s_done);
+
+	Thread_PoolDestroy(s_pool);
+	Thread_CountdownEventDestroy(&s_done);
+}
+
+#define ORDER_JOBS 9
+static Thread_Atomic32_t s_orderNext;
+static uintptr_t s_order[ORDER_JOBS];
+
+static void OrderJob(void *data) {
+	s_order[Thread_AtomicFetchAdd32Explicit(&s_orderNext, 1, Thread_ATOMIC_RELAXED)] = (uintptr_t) data;
+	Thread_CountdownEventSignal(&s_done, 1);
+}
+
+// queues 3 jobs per lane behind a blocked single worker, data is the priority
+static void RunOrderedJobs(uint32_t agingInterval) {
+	Thread_PoolDesc desc = {};
+	desc.maxWorkers = 1;
+	desc.agingInterval = agingInterval;
+	s_pool = Thread_PoolCreate(&desc);
+	REQUIRE(s_pool);
+	REQUIRE(Thread_LatchCreate(&s_gate, 1));
+	REQUIRE(Thread_CountdownEventCreate(&s_done, 1 + ORDER_JOBS));
+	Thread_AtomicStore32Relaxed(&s_orderNext, 0);
+
+	Thread_PoolSubmit(s_pool, &GateJob, NULL);
+	while (Thread_PoolQueueDepth(s_pool) != 0) {
+		Thread_Sleep(1);
+	}
+	for (uint32_t i = 0; i < ORDER_JOBS; ++i) {
+		Thread_PoolPriority const priority = (Thread_PoolPriority) (Thread_POOL_PRIORITY_COUNT - 1 - i % Thread_POOL_PRIORITY_COUNT);
+		Thread_PoolSubmitPriority(s_pool, priority, &OrderJob, (void *) (uintptr_t) priority);
+	}
+	Thread_LatchCountDown(&s_gate, 1);
+	Thread_CountdownEventWait(&s_done);
+
+	Thread_PoolDestroy(s_pool);
+	Thread_CountdownEventDestroy(&s_done);
+	Thread_LatchDestroy(&s_gate);
+}
+
+TEST_CASE("Pool priority lanes", "[al2o3 thread]") {
+	// no aging inside the test, strictly high then normal then low
+	RunOrderedJobs(1000);
+	for (uint32_t i = 0; i < ORDER_JOBS; ++i) {
+		REQUIRE(s_order[i] == i / 3);
+	}
+
+	// aging every 2 jobs lets the lower lanes in before the high lane empties
+	RunOrderedJobs(2);
+	REQUIRE(s_order[0] == Thread_POOL_PRIORITY_HIGH);
+	uint32_t lastHigh = 0;
+	for (uint32_t i = 0; i < ORDER_JOBS; ++i) {
+		lastHigh = s_order[i] == Thread_POOL_PRIORITY_HIGH ? i : lastHigh;
+	}
+	REQUIRE(lastHigh > 2);
+}
+
+static Thread_Atomic32_t s_blocked;
+
+static void LatchJob(void *data) {
+	Thread_LatchCountDown((Thread_Latch *) data, 1);
+}
+
+static void BlockingJob(void *data) {
+	Thread_AtomicFetchAdd32Explicit(&s_blocked, 1, Thread_ATOMIC_RELAXED);
+	Thread_LatchWait(&s_gate);
+	Thread_CountdownEventSignal(&s_done, 1);
+}
+
+// submits land at different points around the retire timeout, including just as
+// the only worker gives up, and each one must still run
+TEST_CASE("Pool work submitted while a worker retires still runs", "[al2o3 thread]") {
+	Thread_PoolDesc desc = {};
+	desc.maxWorkers = 1;
+	desc.retireMs = 1;
+	s_pool = Thread_PoolCreate(&desc);
+	REQUIRE(s_pool);
+	REQUIRE(Thread_CountdownEventCreate(&s_done, 0));
+	Thread_AtomicStore32Relaxed(&s_ran, 0);
+	uint32_t stranded = 0;
+	for (uint32_t i = 0; i < 400 && !stranded; ++i) {
+		Thread_AtomicStore32Relaxed(&s_ran, 0);
+		Thread_CountdownEventReset(&s_done, 2);
+		Thread_PoolSubmit(s_pool, &CountJob, NULL);
+		while (Thread_AtomicLoad32Relaxed(&s_ran) == 0) {
+			Thread_Sleep(0);
+		}
+
+		uint64_t const start = Thread_MonotonicNs();
+		uint64_t const delayNs = (uint64_t) (i % 40) * 50000;
+		while (Thread_MonotonicNs() - start < delayNs) {
+			Thread_AtomicPause();
+		}
+		Thread_PoolSubmit(s_pool, &CountJob, NULL);
+		// a stranded job never runs, give up on it after a second
+		uint64_t const submitted = Thread_MonotonicNs();
+		while (Thread_AtomicLoad32Relaxed(&s_ran) != 2 && Thread_MonotonicNs() - submitted < 1000000000) {
+			Thread_Sleep(0);
+		}
+		stranded = Thread_AtomicLoad32Relaxed(&s_ran) != 2;
+		if (!stranded) {
+			Thread_CountdownEventWait(&s_done);
+		}
+	}
+	REQUIRE(stranded == 0);
+	Thread_PoolDestroy(s_pool);
+	Thread_CountdownEventDestroy(&s_done);
+}
+
+TEST_CASE("Pool reserved high priority workers", "[al2o3 thread]") {
+	Thread_PoolDesc desc = {};
+	desc.reservedHighWorkers = 1;
+	s_pool = Thread_PoolCreate(&desc);
+	REQUIRE(s_pool);
+	// reserved workers are already running before anything is submitted
+	REQUIRE(Thread_PoolWorkerCount(s_pool) == Thread_PoolReservedHighWorkerCount(s_pool));
+	uint32_t const general = Thread_PoolMaxWorkerCount(s_pool) - Thread_PoolReservedHighWorkerCount(s_pool);
+	if (Thread_PoolReservedHighWorkerCount(s_pool) == 0) {
+		// single core, nothing can be reserved
+		REQUIRE(general == 1);
+		Thread_PoolDestroy(s_pool);
+		return;
+	}
+
+	// tie up every general worker with background work
+	REQUIRE(Thread_LatchCreate(&s_gate, 1));
+	REQUIRE(Thread_CountdownEventCreate(&s_done, general + 1));
+	Thread_AtomicStore32Relaxed(&s_blocked, 0);
+	Thread_AtomicStore32Relaxed(&s_ran, 0);
+	for (uint32_t i = 0; i < general; ++i) {
+		Thread_PoolSubmitPriority(s_pool, Thread_POOL_PRIORITY_LOW, &BlockingJob, NULL);
+	}
+	while (Thread_AtomicLoad32Relaxed(&s_blocked) != general) {
+		Thread_Sleep(1);
+	}
+	// more background work waits, the high lane still runs
+	Thread_PoolSubmitPriority(s_pool, Thread_POOL_PRIORITY_NORMAL, &CountJob, NULL);
+	Thread_Latch highDone;
+	REQUIRE(Thread_LatchCreate(&highDone, 1));
+	Thread_PoolSubmitPriority(s_pool, Thread_POOL_PRIORITY_HIGH, &LatchJob, &highDone);
+	Thread_LatchWait(&highDone);
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_ran) == 0);
+
+	Thread_LatchCountDown(&s_gate, 1);
+	Thread_CountdownEventWait(&s_done);
+	Thread_PoolDestroy(s_pool);
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_ran) == 1);
+	Thread_LatchDestroy(&highDone);
+	Thread_LatchDestroy(&s_gate);
+	Thread_CountdownEventDestroy(&s_done);
+}
@@ -0,0 +1,92 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/seqlock.h"
+#include "al2o3_thread/seqlock.hpp"
+#include <string.h>
+
+#define SNAPSHOT_WORDS 256
+#define SNAPSHOT_FRAMES 20000
+#define SNAPSHOT_READERS 4
+
+// 2KB, every word holds the frame it was written in
+typedef struct Snapshot {
+	uint64_t words[SNAPSHOT_WORDS];
+} Snapshot;
+
+static Thread::SeqLocked<Snapshot> *s_snapshot;
+static Thread_Atomic32_t s_torn;
+static Thread_Atomic32_t s_backwards;
+
+static void SnapshotWriter(void *data) {
+	Snapshot snapshot;
+	for (uint64_t frame = 1; frame <= SNAPSHOT_FRAMES; ++frame) {
+		for (uint32_t i = 0; i < SNAPSHOT_WORDS; ++i) {
+			snapshot.words[i] = frame;
+		}
+		s_snapshot->Store(snapshot);
+	}
+}
+
+static void SnapshotReader(void *data) {
+	uint64_t last = 0;
+	Snapshot snapshot;
+	do {
+		s_snapshot->Load(snapshot);
+		for (uint32_t i = 1; i < SNAPSHOT_WORDS; ++i) {
+			if (snapshot.words[i] != snapshot.words[0]) {
+				Thread_AtomicFetchAdd32Explicit(&s_torn, 1, Thread_ATOMIC_RELAXED);
+				break;
+			}
+		}
+		if (snapshot.words[0] < last) {
+			Thread_AtomicFetchAdd32Explicit(&s_backwards, 1, Thread_ATOMIC_RELAXED);
+		}
+		last = snapshot.words[0];
+	} while (last != SNAPSHOT_FRAMES);
+}
+
+TEST_CASE("Sequence lock readers never see a torn write", "[al2o3 thread]") {
+	s_snapshot = new Thread::SeqLocked<Snapshot>();
+	Thread_AtomicStore32Explicit(&s_torn, 0, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStore32Explicit(&s_backwards, 0, Thread_ATOMIC_RELAXED);
+	REQUIRE(s_snapshot->Load().words[SNAPSHOT_WORDS - 1] == 0);
+
+	Thread_Thread readers[SNAPSHOT_READERS];
+	for (uint32_t i = 0; i < SNAPSHOT_READERS; ++i) {
+		REQUIRE(Thread_ThreadCreate(&readers[i], &SnapshotReader, NULL));
+	}
+	Thread_Thread writer;
+	REQUIRE(Thread_ThreadCreate(&writer, &SnapshotWriter, NULL));
+	Thread_ThreadDestroy(&writer);
+	for (uint32_t i = 0; i < SNAPSHOT_READERS; ++i) {
+		Thread_ThreadDestroy(&readers[i]);
+	}
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_torn, Thread_ATOMIC_RELAXED) == 0);
+	REQUIRE(Thread_AtomicLoad32Explicit(&s_backwards, Thread_ATOMIC_RELAXED) == 0);
+	delete s_snapshot;
+}
+
+TEST_CASE("Sequence lock raw protocol and odd sizes", "[al2o3 thread]") {
+	Thread_SeqLock lock;
+	REQUIRE(Thread_SeqLockCreate(&lock));
+
+	// not a multiple of 8, the tail goes byte by byte
+	uint64_t shared[2] = {};
+	char const text[13] = {'s', 'e', 'q', 'l', 'o', 'c', 'k', ' ', 't', 'a', 'i', 'l', '!'};
+	char out[13];
+	Thread_SeqLockWrite(&lock, shared, text, sizeof(text));
+	Thread_SeqLockRead(&lock, out, shared, sizeof(out));
+	REQUIRE(memcmp(out, text, sizeof(text)) == 0);
+
+	// a read that overlaps a write has to retry
+	uint32_t const sequence = Thread_SeqLockReadBegin(&lock);
+	REQUIRE(!Thread_SeqLockReadRetry(&lock, sequence));
+	Thread_SeqLockWriteBegin(&lock);
+	REQUIRE(Thread_SeqLockReadRetry(&lock, sequence));
+	Thread_SeqLockWriteEnd(&lock);
+	REQUIRE(Thread_SeqLockReadRetry(&lock, sequence));
+	REQUIRE(!Thread_SeqLockReadRetry(&lock, Thread_SeqLockReadBegin(&lock)));
+
+	Thread_SeqLockDestroy(&lock);
+}
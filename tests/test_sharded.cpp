@@ -0,0 +1,144 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/sharded.h"
+
+static Thread_ShardedCounterHandle s_counter;
+static Thread_ShardedMinMaxHandle s_minMax;
+static Thread_ShardedHistogramHandle s_histogram;
+
+static void ShardedJob(void *data) {
+	uint64_t const base = (uint64_t) data;
+	for (uint64_t i = 0; i < 1000; ++i) {
+		Thread_ShardedCounterAdd(s_counter, 1);
+		Thread_ShardedMinMaxUpdate(s_minMax, base + i);
+		Thread_ShardedHistogramRecord(s_histogram, i);
+	}
+}
+
+TEST_CASE("Sharded counters", "[al2o3 thread]") {
+	// 2 shards so some of the 8 threads share slots
+	s_counter = Thread_ShardedCounterCreate(2);
+	s_minMax = Thread_ShardedMinMaxCreate(0);
+	s_histogram = Thread_ShardedHistogramCreate(2);
+	REQUIRE(s_counter);
+	REQUIRE(s_minMax);
+	REQUIRE(s_histogram);
+
+	uint64_t min, max;
+	REQUIRE(!Thread_ShardedMinMaxRead(s_minMax, &min, &max));
+
+	Thread_Thread threads[8];
+	for (uint64_t i = 0; i < 8; ++i) {
+		REQUIRE(Thread_ThreadCreate(&threads[i], &ShardedJob, (void *) (10 + i * 1000)));
+	}
+	for (uint32_t i = 0; i < 8; ++i) {
+		Thread_ThreadDestroy(&threads[i]);
+	}
+	Thread_ShardedCounterAdd(s_counter, -5);
+
+	REQUIRE(Thread_ShardedCounterRead(s_counter) == 7995);
+	REQUIRE(Thread_ShardedMinMaxRead(s_minMax, &min, &max));
+	REQUIRE(min == 10);
+	REQUIRE(max == 10 + 7999);
+
+	uint64_t buckets[Thread_SHARDED_HISTOGRAM_BUCKET_COUNT];
+	uint64_t sum;
+	REQUIRE(Thread_ShardedHistogramRead(s_histogram, buckets, &sum) == 8000);
+	REQUIRE(sum == 8 * (999 * 1000 / 2));
+	REQUIRE(buckets[0] == 8);
+	REQUIRE(buckets[1] == 8);
+	REQUIRE(buckets[Thread_ShardedHistogramBucketOf(512)] == 8 * (1000 - 512));
+
+	Thread_ShardedCounterReset(s_counter);
+	Thread_ShardedMinMaxReset(s_minMax);
+	Thread_ShardedHistogramReset(s_histogram);
+	REQUIRE(Thread_ShardedCounterRead(s_counter) == 0);
+	REQUIRE(!Thread_ShardedMinMaxRead(s_minMax, &min, &max));
+	REQUIRE(Thread_ShardedHistogramRead(s_histogram, buckets, NULL) == 0);
+
+	Thread_ShardedCounterDestroy(s_counter);
+	Thread_ShardedMinMaxDestroy(s_minMax);
+	Thread_ShardedHistogramDestroy(s_histogram);
+}
+
+static Thread_Atomic32_t s_indexedThreads;
+
+static void IndexJob(void *data) {
+	uint32_t *out = (uint32_t *) data;
+	*out = Thread_GetCurrentThreadIndex();
+	// stay alive until every thread has its index so none can be reused
+	Thread_AtomicFetchAdd32Explicit(&s_indexedThreads, 1, Thread_ATOMIC_ACQ_REL);
+	while (Thread_AtomicLoad32Explicit(&s_indexedThreads, Thread_ATOMIC_ACQUIRE) != 4) {
+		Thread_Sleep(1);
+	}
+}
+
+TEST_CASE("Thread index", "[al2o3 thread]") {
+	uint32_t indices[4];
+	Thread_Thread threads[4];
+	Thread_AtomicStore32Explicit(&s_indexedThreads, 0, Thread_ATOMIC_RELAXED);
+	for (uint32_t i = 0; i < 4; ++i) {
+		REQUIRE(Thread_ThreadCreate(&threads[i], &IndexJob, &indices[i]));
+	}
+	for (uint32_t i = 0; i < 4; ++i) {
+		Thread_ThreadDestroy(&threads[i]);
+	}
+	uint32_t const mainIndex = Thread_GetCurrentThreadIndex();
+	for (uint32_t i = 0; i < 4; ++i) {
+		REQUIRE(indices[i] < Thread_MAX_THREAD_INDICES);
+		REQUIRE(indices[i] != mainIndex);
+		for (uint32_t j = i + 1; j < 4; ++j) {
+			REQUIRE(indices[i] != indices[j]);
+		}
+	}
+}
+
+#define SHARED_SLOT_THREADS 4
+#define SHARED_SLOT_ADDS 2000000
+
+static Thread_Atomic32_t s_sharedSlotArrived;
+static Thread_AtomicPtr_t s_sharedSlotCounter;
+
+static void SharedSlotJob(void *data) {
+	*(uint32_t *) data = Thread_GetCurrentThreadIndex();
+	Thread_AtomicFetchAdd32Explicit(&s_sharedSlotArrived, 1, Thread_ATOMIC_ACQ_REL);
+	Thread_ShardedCounterHandle counter;
+	while (!(counter = (Thread_ShardedCounterHandle) Thread_AtomicLoadPtrExplicit(&s_sharedSlotCounter,
+																																							 Thread_ATOMIC_ACQUIRE))) {
+		Thread_Yield();
+	}
+	for (uint32_t i = 0; i < SHARED_SLOT_ADDS; ++i) {
+		Thread_ShardedCounterAdd(counter, 1);
+	}
+}
+
+TEST_CASE("Sharded counter owner and overflow threads don't lose adds", "[al2o3 thread]") {
+	uint32_t indices[SHARED_SLOT_THREADS];
+	Thread_Thread threads[SHARED_SLOT_THREADS];
+	Thread_AtomicStore32Explicit(&s_sharedSlotArrived, 0, Thread_ATOMIC_RELAXED);
+	Thread_AtomicStorePtrExplicit(&s_sharedSlotCounter, NULL, Thread_ATOMIC_RELAXED);
+	for (uint32_t i = 0; i < SHARED_SLOT_THREADS; ++i) {
+		REQUIRE(Thread_ThreadCreate(&threads[i], &SharedSlotJob, &indices[i]));
+	}
+	while (Thread_AtomicLoad32Explicit(&s_sharedSlotArrived, Thread_ATOMIC_ACQUIRE) != SHARED_SLOT_THREADS) {
+		Thread_Yield();
+	}
+	// pick a shard count where the lowest index owns a slot and the highest is
+	// an overflow thread that index % shardCount would put on the same slot
+	uint32_t low = indices[0];
+	uint32_t high = indices[0];
+	for (uint32_t i = 1; i < SHARED_SLOT_THREADS; ++i) {
+		low = indices[i] < low ? indices[i] : low;
+		high = indices[i] > high ? indices[i] : high;
+	}
+	uint32_t const shardCount = high > low * 2 ? high - low : 1;
+	Thread_ShardedCounterHandle counter = Thread_ShardedCounterCreate(shardCount);
+	REQUIRE(counter);
+	Thread_AtomicStorePtrExplicit(&s_sharedSlotCounter, counter, Thread_ATOMIC_RELEASE);
+	for (uint32_t i = 0; i < SHARED_SLOT_THREADS; ++i) {
+		Thread_ThreadDestroy(&threads[i]);
+	}
+	REQUIRE(Thread_ShardedCounterRead(counter) == (int64_t) SHARED_SLOT_THREADS * SHARED_SLOT_ADDS);
+	Thread_ShardedCounterDestroy(counter);
+}
@@ -0,0 +1,142 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/thread.hpp"
+#include "al2o3_thread/barrier.h"
+#include "al2o3_thread/spinlock.h"
+#include "al2o3_thread/spinlock.hpp"
+#include <stdio.h>
+
+#define MAX_THREADS 64
+
+typedef enum LockKind {
+	LOCK_SPIN,
+	LOCK_TICKET,
+	LOCK_MCS,
+	LOCK_MUTEX,
+	LOCK_KIND_COUNT
+} LockKind;
+
+static char const *const s_lockNames[] = {"spin", "ticket", "mcs", "mutex"};
+
+static Thread::SpinLock *s_spin;
+static Thread::TicketLock *s_ticket;
+static Thread::MCSLock *s_mcs;
+static Thread::Mutex *s_mutex;
+static Thread_Barrier s_start;
+static LockKind s_kind;
+static uint32_t s_iterations;
+// deliberately not atomic, the lock is all that keeps it right
+static uint64_t s_counter;
+
+static void Contend(void *data) {
+	Thread_BarrierWait(&s_start);
+	for (uint32_t i = 0; i < s_iterations; ++i) {
+		switch (s_kind) {
+			case LOCK_SPIN: {
+				Thread::SpinLockGuard guard(*s_spin);
+				s_counter++;
+				break;
+			}
+			case LOCK_TICKET: {
+				Thread::TicketLockGuard guard(*s_ticket);
+				s_counter++;
+				break;
+			}
+			case LOCK_MCS: {
+				Thread::MCSLockGuard guard(*s_mcs);
+				s_counter++;
+				break;
+			}
+			default: {
+				Thread::MutexLock guard(*s_mutex);
+				s_counter++;
+				break;
+			}
+		}
+	}
+}
+
+// returns ns per acquire/release pair across all threads
+static double RunContended(LockKind kind, uint32_t threadCount, uint32_t iterations) {
+	s_kind = kind;
+	s_iterations = iterations;
+	s_counter = 0;
+	Thread_BarrierCreate(&s_start, threadCount + 1);
+	Thread_Thread threads[MAX_THREADS];
+	for (uint32_t i = 0; i < threadCount; ++i) {
+		Thread_ThreadCreate(&threads[i], &Contend, NULL);
+	}
+	uint64_t const start = Thread_MonotonicNs();
+	Thread_BarrierWait(&s_start);
+	for (uint32_t i = 0; i < threadCount; ++i) {
+		Thread_ThreadDestroy(&threads[i]);
+	}
+	uint64_t const elapsed = Thread_MonotonicNs() - start;
+	Thread_BarrierDestroy(&s_start);
+	REQUIRE(s_counter == (uint64_t) threadCount * iterations);
+	return (double) elapsed / (double) (threadCount * iterations);
+}
+
+struct LockSet {
+	Thread::SpinLock spin;
+	Thread::TicketLock ticket;
+	Thread::MCSLock mcs;
+	Thread::Mutex mutex;
+
+	LockSet() {
+		s_spin = &spin;
+		s_ticket = &ticket;
+		s_mcs = &mcs;
+		s_mutex = &mutex;
+	}
+};
+
+TEST_CASE("Spin locks exclude", "[al2o3 thread]") {
+	LockSet locks;
+	for (uint32_t kind = 0; kind < LOCK_MUTEX; ++kind) {
+		RunContended((LockKind) kind, 4, 5000);
+	}
+}
+
+TEST_CASE("Spin locks try acquire", "[al2o3 thread]") {
+	Thread_SpinLock spin = {};
+	REQUIRE(Thread_SpinLockCreate(&spin));
+	REQUIRE(Thread_SpinLockTryAcquire(&spin));
+	REQUIRE(!Thread_SpinLockTryAcquire(&spin));
+	Thread_SpinLockRelease(&spin);
+	REQUIRE(Thread_SpinLockTryAcquire(&spin));
+	Thread_SpinLockRelease(&spin);
+	Thread_SpinLockDestroy(&spin);
+
+	Thread_TicketLock ticket = {};
+	REQUIRE(Thread_TicketLockCreate(&ticket));
+	REQUIRE(Thread_TicketLockTryAcquire(&ticket));
+	REQUIRE(!Thread_TicketLockTryAcquire(&ticket));
+	Thread_TicketLockRelease(&ticket);
+	Thread_TicketLockAcquire(&ticket);
+	Thread_TicketLockRelease(&ticket);
+	Thread_TicketLockDestroy(&ticket);
+
+	Thread_MCSLock mcs = {};
+	Thread_MCSLockNode first, second;
+	REQUIRE(Thread_MCSLockCreate(&mcs));
+	REQUIRE(Thread_MCSLockTryAcquire(&mcs, &first));
+	REQUIRE(!Thread_MCSLockTryAcquire(&mcs, &second));
+	Thread_MCSLockRelease(&mcs, &first);
+	REQUIRE(Thread_MCSLockTryAcquire(&mcs, &second));
+	Thread_MCSLockRelease(&mcs, &second);
+	Thread_MCSLockDestroy(&mcs);
+}
+
+TEST_CASE("Spin lock scaling", "[al2o3 thread][.benchmark]") {
+	LockSet locks;
+	printf("ns per lock/unlock %8s %8s %8s %8s\n", s_lockNames[0], s_lockNames[1], s_lockNames[2], s_lockNames[3]);
+	for (uint32_t threads = 1; threads <= MAX_THREADS; threads *= 2) {
+		printf("%2u threads         ", threads);
+		for (uint32_t kind = 0; kind < LOCK_KIND_COUNT; ++kind) {
+			// same total work whatever the thread count
+			printf(" %8.1f", RunContended((LockKind) kind, threads, 200000 / threads));
+		}
+		printf("\n");
+	}
+}
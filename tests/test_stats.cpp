@@ -0,0 +1,136 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/barrier.h"
+#include "al2o3_thread/pool.h"
+#include "al2o3_thread/stats.h"
+
+static Thread_Latch s_sampled;
+static Thread_Atomic64_t s_workerOSThreadId;
+
+static void BurnNs(uint64_t ns) {
+	uint64_t const start = Thread_MonotonicNs();
+	while (Thread_MonotonicNs() - start < ns) {
+		Thread_AtomicPause();
+	}
+}
+
+// burns CPU time rather than wall time, a busy machine can preempt it
+static void BurnCpuNs(uint64_t ns) {
+	Thread_ThreadStats start;
+	Thread_StatsGetCurrent(&start);
+	Thread_ThreadStats now;
+	do {
+		BurnNs(100000);
+		Thread_StatsGetCurrent(&now);
+	} while (now.cpuTimeNs - start.cpuTimeNs < ns);
+}
+
+static void SleepyBurner(void *data) {
+	for (uint32_t i = 0; i < 4; ++i) {
+		Thread_Sleep(1);
+	}
+	BurnCpuNs(10000000);
+	Thread_AtomicStore64Explicit(&s_workerOSThreadId, Thread_StatsCurrentOSThreadID(), Thread_ATOMIC_RELAXED);
+	Thread_LatchWait(&s_sampled);
+}
+
+TEST_CASE("Thread stats", "[al2o3 thread]") {
+	Thread_ThreadStats before;
+	Thread_StatsGetCurrent(&before);
+	REQUIRE(before.osThreadId == Thread_StatsCurrentOSThreadID());
+	BurnCpuNs(10000000);
+	Thread_ThreadStats after;
+	Thread_StatsGetCurrent(&after);
+	REQUIRE(after.cpuTimeNs - before.cpuTimeNs >= 10000000);
+	REQUIRE(after.cpu < (int32_t) Thread_CPUCoreCount());
+
+	REQUIRE(Thread_LatchCreate(&s_sampled, 1));
+	Thread_AtomicStore64Explicit(&s_workerOSThreadId, 0, Thread_ATOMIC_RELAXED);
+	Thread_Thread thread;
+	REQUIRE(Thread_ThreadCreate(&thread, &SleepyBurner, NULL));
+
+	// it is registered for its whole run, wait until it has burnt its time
+	Thread_ThreadStats all[64];
+	Thread_ThreadStats const *found = NULL;
+	for (uint32_t tries = 0; tries < 5000 && !found; ++tries) {
+		uint32_t const count = Thread_StatsGetAll(all, 64);
+		for (uint32_t i = 0; i < count && i < 64; ++i) {
+			if (all[i].osThreadId == Thread_AtomicLoad64Explicit(&s_workerOSThreadId, Thread_ATOMIC_RELAXED) && all[i].cpuTimeNs >= 10000000) {
+				found = &all[i];
+			}
+		}
+		if (!found) {
+			Thread_Sleep(1);
+		}
+	}
+	REQUIRE(found);
+	REQUIRE(found->cpu < (int32_t) Thread_CPUCoreCount());
+#if defined(__linux__)
+	REQUIRE(found->voluntarySwitches >= 4);
+#endif
+
+	Thread_LatchCountDown(&s_sampled, 1);
+	Thread_ThreadDestroy(&thread);
+	Thread_LatchDestroy(&s_sampled);
+}
+
+static Thread_CountdownEvent s_jobsDone;
+
+static void OneMsJob(void *data) {
+	BurnNs(1000000);
+	Thread_CountdownEventSignal(&s_jobsDone, 1);
+}
+
+static void SumWorkerStats(Thread_PoolHandle pool, Thread_PoolWorkerStats *sum) {
+	Thread_PoolWorkerStats stats[256];
+	uint32_t const count = Thread_PoolGetWorkerStats(pool, stats, 256);
+	REQUIRE(count == Thread_PoolMaxWorkerCount(pool));
+	*sum = {};
+	for (uint32_t i = 0; i < count; ++i) {
+		REQUIRE(stats[i].steals <= stats[i].stealAttempts);
+		REQUIRE((!stats[i].alive || stats[i].osThreadId != 0));
+		sum->busyNs += stats[i].busyNs;
+		sum->stealingNs += stats[i].stealingNs;
+		sum->idleNs += stats[i].idleNs;
+		sum->jobsExecuted += stats[i].jobsExecuted;
+		sum->stealAttempts += stats[i].stealAttempts;
+		sum->steals += stats[i].steals;
+	}
+}
+
+TEST_CASE("Pool worker stats", "[al2o3 thread]") {
+	Thread_PoolHandle pool = Thread_PoolCreate(NULL);
+	REQUIRE(pool);
+	Thread_PoolWorkerStats sum;
+	SumWorkerStats(pool, &sum);
+	REQUIRE(sum.jobsExecuted == 0);
+	REQUIRE(sum.busyNs == 0);
+
+	REQUIRE(Thread_CountdownEventCreate(&s_jobsDone, 32));
+	for (uint32_t i = 0; i < 32; ++i) {
+		Thread_PoolSubmit(pool, &OneMsJob, NULL);
+	}
+	Thread_CountdownEventWait(&s_jobsDone);
+	// a worker counts the job just after it returns
+	for (uint32_t tries = 0; tries < 1000; ++tries) {
+		SumWorkerStats(pool, &sum);
+		if (sum.jobsExecuted == 32) {
+			break;
+		}
+		Thread_Sleep(1);
+	}
+	REQUIRE(sum.jobsExecuted == 32);
+	REQUIRE(sum.busyNs >= 32 * 1000000ull);
+
+	// out of work every live worker is stealing or parked, and that time keeps growing
+	Thread_PoolWorkerStats const quiet = sum;
+	Thread_Sleep(20);
+	SumWorkerStats(pool, &sum);
+	REQUIRE(sum.jobsExecuted == 32);
+	REQUIRE(sum.stealingNs + sum.idleNs > quiet.stealingNs + quiet.idleNs);
+	REQUIRE(sum.busyNs - quiet.busyNs < 1000000);
+
+	Thread_CountdownEventDestroy(&s_jobsDone);
+	Thread_PoolDestroy(pool);
+}
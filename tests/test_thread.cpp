@@ -1,5 +1,9 @@
 #include "al2o3_catch2/catch2.hpp"
 #include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/thread.hpp"
+#include <chrono>
+#include <stdio.h>
 
 static void TestJob(void* data) {
 	REQUIRE(((uint64_t)data) == 10);
@@ -31,3 +35,103 @@ TEST_CASE("Basic tests", "[al2o3 thread]") {
 	Thread_CPUCoreCount();
 	Thread_Sleep(10);
 }
+
+static Thread_Atomic32_t s_cacheRuns;
+static Thread_ThreadID s_cacheThreadID;
+static Thread_Atomic32_t s_cacheReused;
+
+static void CacheJob(void *data) {
+	if (Thread_GetCurrentThreadID() == s_cacheThreadID) {
+		Thread_AtomicFetchAdd32Explicit(&s_cacheReused, 1, Thread_ATOMIC_RELAXED);
+	}
+	s_cacheThreadID = Thread_GetCurrentThreadID();
+	Thread_Sleep((uint64_t) (uintptr_t) data);
+	Thread_AtomicFetchAdd32Explicit(&s_cacheRuns, 1, Thread_ATOMIC_RELAXED);
+}
+
+static void EmptyJob(void *data) {
+}
+
+TEST_CASE("Thread cache reuses OS threads", "[al2o3 thread]") {
+	Thread_AtomicStore32Relaxed(&s_cacheRuns, 0);
+	Thread_AtomicStore32Relaxed(&s_cacheReused, 0);
+	Thread_ThreadCacheSetSize(2);
+
+	// one at a time, every thread after the first should come from the cache
+	for (uint32_t i = 0; i < 20; ++i) {
+		Thread_Thread thread;
+		REQUIRE(Thread_ThreadCreate(&thread, &CacheJob, NULL));
+		Thread_ThreadJoin(&thread);
+		// join returns once the job is done, a second join is fine
+		REQUIRE(Thread_AtomicLoad32Relaxed(&s_cacheRuns) == i + 1);
+		Thread_ThreadJoin(&thread);
+		Thread_ThreadDestroy(&thread);
+	}
+	// the thread parks just after the job returns, so the first reuse can race it
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_cacheReused) >= 1);
+
+	// more live threads than the cache holds, the extra ones exit
+	Thread::Thread *threads[8];
+	for (uint32_t i = 0; i < 8; ++i) {
+		threads[i] = new Thread::Thread(&CacheJob, (void *) 5);
+	}
+	for (uint32_t i = 0; i < 8; ++i) {
+		delete threads[i];
+	}
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_cacheRuns) == 28);
+	for (uint32_t i = 0; i < 100 && Thread_ThreadCacheCount() != 2; ++i) {
+		Thread_Sleep(1);
+	}
+	REQUIRE(Thread_ThreadCacheCount() == 2);
+
+	Thread_ThreadCacheSetSize(0);
+	REQUIRE(Thread_ThreadCacheCount() == 0);
+}
+
+static Thread_Thread s_joinTarget;
+static Thread_Atomic32_t s_joinsDone;
+
+static void SleepJob(void *data) {
+	Thread_Sleep((uint64_t) (uintptr_t) data);
+}
+
+static void JoinerJob(void *data) {
+	Thread_ThreadJoin(&s_joinTarget);
+	Thread_AtomicFetchAdd32Explicit(&s_joinsDone, 1, Thread_ATOMIC_RELAXED);
+}
+
+TEST_CASE("Thread join from several threads at once", "[al2o3 thread]") {
+	Thread_AtomicStore32Relaxed(&s_joinsDone, 0);
+	REQUIRE(Thread_ThreadCreate(&s_joinTarget, &SleepJob, (void *) 20));
+	Thread_Thread joiners[4];
+	for (uint32_t i = 0; i < 4; ++i) {
+		REQUIRE(Thread_ThreadCreate(&joiners[i], &JoinerJob, NULL));
+	}
+	Thread_ThreadJoin(&s_joinTarget);
+	for (uint32_t i = 0; i < 4; ++i) {
+		Thread_ThreadDestroy(&joiners[i]);
+	}
+	REQUIRE(Thread_AtomicLoad32Relaxed(&s_joinsDone) == 4);
+	Thread_ThreadDestroy(&s_joinTarget);
+}
+
+static double CreateJoinMicroseconds(uint32_t count) {
+	auto const start = std::chrono::high_resolution_clock::now();
+	for (uint32_t i = 0; i < count; ++i) {
+		Thread_Thread thread;
+		Thread_ThreadCreate(&thread, &EmptyJob, NULL);
+		Thread_ThreadDestroy(&thread);
+	}
+	std::chrono::duration<double, std::micro> const elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count() / count;
+}
+
+TEST_CASE("Thread create join latency", "[al2o3 thread][.benchmark]") {
+	Thread_ThreadCacheSetSize(0);
+	double const uncached = CreateJoinMicroseconds(2000);
+	Thread_ThreadCacheSetSize(4);
+	CreateJoinMicroseconds(10);
+	double const cached = CreateJoinMicroseconds(2000);
+	Thread_ThreadCacheSetSize(0);
+	printf("create+join: %.2f us uncached, %.2f us cached\n", uncached, cached);
+}
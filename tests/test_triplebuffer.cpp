@@ -0,0 +1,81 @@
+#include "al2o3_catch2/catch2.hpp"
+#include "al2o3_thread/thread.h"
+#include "al2o3_thread/atomic.h"
+#include "al2o3_thread/triplebuffer.h"
+#include "al2o3_thread/triplebuffer.hpp"
+
+TEST_CASE("Triple buffer hands over the newest publish", "[al2o3 thread]") {
+	Thread_TripleBuffer tb;
+	REQUIRE(Thread_TripleBufferCreate(&tb, sizeof(uint32_t)));
+	REQUIRE(*(uint32_t const *) Thread_TripleBufferReadBuffer(&tb) == 0);
+	REQUIRE(!Thread_TripleBufferUpdate(&tb));
+
+	*(uint32_t *) Thread_TripleBufferWriteBuffer(&tb) = 1;
+	Thread_TripleBufferPublish(&tb);
+	// nothing changes for the consumer until it updates
+	REQUIRE(*(uint32_t const *) Thread_TripleBufferReadBuffer(&tb) == 0);
+	REQUIRE(Thread_TripleBufferUpdate(&tb));
+	REQUIRE(*(uint32_t const *) Thread_TripleBufferReadBuffer(&tb) == 1);
+	REQUIRE(!Thread_TripleBufferUpdate(&tb));
+	REQUIRE(*(uint32_t const *) Thread_TripleBufferReadBuffer(&tb) == 1);
+
+	// only the newest of several publishes is seen
+	for (uint32_t i = 2; i <= 5; ++i) {
+		*(uint32_t *) Thread_TripleBufferWriteBuffer(&tb) = i;
+		Thread_TripleBufferPublish(&tb);
+		REQUIRE(Thread_TripleBufferWriteBuffer(&tb) != Thread_TripleBufferReadBuffer(&tb));
+	}
+	REQUIRE(Thread_TripleBufferUpdate(&tb));
+	REQUIRE(*(uint32_t const *) Thread_TripleBufferReadBuffer(&tb) == 5);
+	REQUIRE(!Thread_TripleBufferUpdate(&tb));
+
+	Thread_TripleBufferDestroy(&tb);
+}
+
+#define FRAME_WORDS 256
+#define FRAME_COUNT 50000
+
+typedef struct Frame {
+	uint64_t words[FRAME_WORDS];
+} Frame;
+
+static Thread::TripleBuffer<Frame> *s_frames;
+
+static void FrameProducer(void *data) {
+	for (uint64_t frame = 1; frame <= FRAME_COUNT; ++frame) {
+		Frame &out = s_frames->Write();
+		for (uint32_t i = 0; i < FRAME_WORDS; ++i) {
+			out.words[i] = frame;
+		}
+		s_frames->Publish();
+	}
+}
+
+TEST_CASE("Triple buffer frames are never torn or reordered", "[al2o3 thread]") {
+	s_frames = new Thread::TripleBuffer<Frame>();
+	Thread_Thread producer;
+	REQUIRE(Thread_ThreadCreate(&producer, &FrameProducer, NULL));
+
+	uint64_t last = 0;
+	uint32_t torn = 0;
+	uint32_t backwards = 0;
+	uint32_t updates = 0;
+	while (last != FRAME_COUNT) {
+		if (!s_frames->Update()) {
+			Thread_AtomicPause();
+			continue;
+		}
+		updates++;
+		Frame const &frame = s_frames->Read();
+		for (uint32_t i = 1; i < FRAME_WORDS; ++i) {
+			torn += frame.words[i] != frame.words[0];
+		}
+		backwards += frame.words[0] <= last;
+		last = frame.words[0];
+	}
+	Thread_ThreadDestroy(&producer);
+	REQUIRE(torn == 0);
+	REQUIRE(backwards == 0);
+	REQUIRE(updates >= 1);
+	delete s_frames;
+}